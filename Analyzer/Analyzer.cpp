@@ -149,7 +149,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::deep_copy() const {
                            aggtype,
                            arg == nullptr ? nullptr : arg->deep_copy(),
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> CaseExpr::deep_copy() const {
@@ -1756,7 +1756,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_with_child_targetlist(
                            aggtype,
                            arg ? arg->rewrite_with_child_targetlist(tlist) : nullptr,
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_agg_to_var(
@@ -2109,6 +2109,11 @@ bool AggExpr::operator==(const Expr& rhs) const {
   if (aggtype != rhs_ae.get_aggtype() || is_distinct != rhs_ae.get_is_distinct()) {
     return false;
   }
+  if (arg1 || rhs_ae.get_arg1()) {
+    if (!arg1 || !rhs_ae.get_arg1() || !(*arg1 == *rhs_ae.get_arg1())) {
+      return false;
+    }
+  }
   if (arg.get() == rhs_ae.get_arg()) {
     return true;
   }
@@ -2422,6 +2427,9 @@ std::string AggExpr::toString() const {
     case kAPPROX_COUNT_DISTINCT:
       agg = "APPROX_COUNT_DISTINCT";
       break;
+    case kAPPROX_PERCENTILE:
+      agg = "APPROX_PERCENTILE";
+      break;
     case kSAMPLE:
       agg = "SAMPLE";
       break;
@@ -28,9 +28,11 @@
 #include "Shared/measure.h"
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <thread>
 #include <utility>
 #include "Catalog/Catalog.h"
+#include "QueryEngine/RelAlgBinaryPlan.h"
 
 #include "Shared/fixautotools.h"
 
@@ -42,6 +44,10 @@
 
 #include "gen-cpp/CalciteServer.h"
 
+#ifdef HAVE_CALCITE_JNI
+#include "CalciteJNI.h"
+#endif
+
 using namespace rapidjson;
 using namespace apache::thrift;
 using namespace apache::thrift::protocol;
@@ -232,16 +238,50 @@ Calcite::Calcite(const MapDParameters& mapd_parameter,
                  const std::string& session_prefix)
     : ssl_trust_store_(mapd_parameter.ssl_trust_store)
     , ssl_trust_password_(mapd_parameter.ssl_trust_password)
-    , session_prefix_(session_prefix) {
+    , session_prefix_(session_prefix)
+    , binary_plan_(mapd_parameter.calcite_binary_plan) {
+  if (mapd_parameter.calcite_in_process) {
+    initInProcess(mapd_parameter, data_dir);
+    return;
+  }
   init(mapd_parameter.omnisci_server_port,
        mapd_parameter.calcite_port,
        data_dir,
        mapd_parameter.calcite_max_mem);
 }
 
+void Calcite::initInProcess(const MapDParameters& mapd_parameter,
+                            const std::string& data_dir) {
+#ifdef HAVE_CALCITE_JNI
+  LOG(INFO) << "Creating in-process Calcite planner, base data dir is " << data_dir;
+  jni_ = std::make_shared<CalciteJNI>(mapd_parameter.omnisci_server_port,
+                                      data_dir,
+                                      mapd_parameter.calcite_max_mem,
+                                      mapd_parameter.calcite_planner_pool_size,
+                                      ssl_trust_store_,
+                                      ssl_trust_password_);
+  server_available_ = true;
+#else
+  LOG(FATAL) << "In-process Calcite requires a build with JNI support";
+#endif
+}
+
 void Calcite::updateMetadata(std::string catalog, std::string table) {
+  // a snapshot push either completes before the server drops its snapshot, or sees the
+  // new version and doesn't happen
+  std::lock_guard<std::mutex> push_lock(schema_push_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(schema_versions_mutex_);
+    ++schema_versions_[catalog];
+  }
   if (server_available_) {
     auto ms = measure<>::execution([&]() {
+#ifdef HAVE_CALCITE_JNI
+      if (jni_) {
+        jni_->updateMetadata(catalog, table);
+        return;
+      }
+#endif
       std::pair<mapd::shared_ptr<CalciteServerClient>, mapd::shared_ptr<TTransport>>
           clientP = get_client(remote_calcite_port_);
       clientP.first->updateMetadata(catalog, table);
@@ -333,6 +373,12 @@ std::vector<TCompletionHint> Calcite::getCompletionHints(
   const auto user = session_info.get_currentUser().userName;
   const auto session = session_info.get_session_id();
   const auto catalog = cat.getCurrentDB().dbName;
+#ifdef HAVE_CALCITE_JNI
+  if (jni_) {
+    return jni_->getCompletionHints(
+        user, session, catalog, visible_tables, sql_string, cursor);
+  }
+#endif
   auto client = get_client(remote_calcite_port_);
   client.first->getCompletionHints(
       hints, user, session, catalog, visible_tables, sql_string, cursor);
@@ -342,7 +388,11 @@ std::vector<TCompletionHint> Calcite::getCompletionHints(
 std::vector<std::string> Calcite::get_db_objects(const std::string ra) {
   std::vector<std::string> v_db_obj;
   Document document;
-  document.Parse(ra.c_str());
+  if (RelAlgBinaryPlan::isBinaryPlan(ra)) {
+    document.Parse(RelAlgBinaryPlan(ra).toJsonString().c_str());
+  } else {
+    document.Parse(ra.c_str());
+  }
   const Value& rels = document["rels"];
   CHECK(rels.IsArray());
   for (auto& v : rels.GetArray()) {
@@ -358,6 +408,94 @@ std::vector<std::string> Calcite::get_db_objects(const std::string ra) {
   return v_db_obj;
 }
 
+TSchemaSnapshot Calcite::buildSchemaSnapshot(const Catalog_Namespace::Catalog& cat,
+                                             const int64_t version) const {
+  TSchemaSnapshot snapshot;
+  snapshot.catalog = cat.getCurrentDB().dbName;
+  snapshot.version = version;
+  for (const auto td : cat.getAllTableMetadata()) {
+    if (td->shard >= 0) {
+      // skip shards, they're not standalone tables
+      continue;
+    }
+    TTableSnapshot table;
+    table.table_name = td->tableName;
+    table.is_view = td->isView;
+    if (td->isView) {
+      // the planner expands views from their SQL, it doesn't need the columns
+      table.view_sql = td->viewSQL;
+    } else {
+      // including the physical columns of geo columns, the planner skips them itself
+      const auto col_descriptors =
+          cat.getAllColumnMetadataForTable(td->tableId, true, true, true);
+      for (const auto cd : col_descriptors) {
+        if (cd->isDeletedCol) {
+          continue;
+        }
+        TColumnSnapshot column;
+        column.col_name = cd->columnName;
+        column.col_type = cd->columnType.get_type();
+        column.col_subtype = cd->columnType.get_subtype();
+        column.col_dim = cd->columnType.get_dimension();
+        column.col_scale = cd->columnType.get_scale();
+        column.is_notnull = cd->columnType.get_notnull();
+        table.columns.push_back(column);
+      }
+    }
+    snapshot.tables.push_back(table);
+  }
+  return snapshot;
+}
+
+void Calcite::pushSchemaSnapshotIfStale(const Catalog_Namespace::Catalog& cat) {
+  const auto& catalog = cat.getCurrentDB().dbName;
+  int64_t version{0};
+  {
+    std::lock_guard<std::mutex> lock(schema_versions_mutex_);
+    version = schema_versions_[catalog];
+    const auto it = pushed_schema_versions_.find(catalog);
+    if (it != pushed_schema_versions_.end() && it->second >= version) {
+      return;
+    }
+  }
+  const auto snapshot = buildSchemaSnapshot(cat, version);
+  std::lock_guard<std::mutex> push_lock(schema_push_mutex_);
+  {
+    // DDL since the version was read may have changed the maps the snapshot was built
+    // from, and the server has already dropped its snapshot for it; the next query
+    // pushes a fresh one
+    std::lock_guard<std::mutex> lock(schema_versions_mutex_);
+    if (schema_versions_[catalog] != version) {
+      return;
+    }
+  }
+  int64_t ms{0};
+  try {
+    ms = measure<>::execution([&]() {
+#ifdef HAVE_CALCITE_JNI
+      if (jni_) {
+        jni_->updateSchemaSnapshot(snapshot);
+        return;
+      }
+#endif
+      std::pair<mapd::shared_ptr<CalciteServerClient>, mapd::shared_ptr<TTransport>>
+          clientP = get_client(remote_calcite_port_);
+      clientP.first->updateSchemaSnapshot(snapshot);
+      clientP.second->close();
+    });
+  } catch (std::exception& e) {
+    // planning still works without the snapshot, it falls back to metadata callbacks
+    LOG(WARNING) << "Failed to push schema snapshot for " << catalog
+                 << ", reason: " << e.what();
+    return;
+  }
+  LOG(INFO) << "Time to push schema snapshot for " << catalog << " version " << version
+            << " (" << snapshot.tables.size() << " tables) " << ms << " (ms)";
+  std::lock_guard<std::mutex> lock(schema_versions_mutex_);
+  auto& pushed_version = pushed_schema_versions_[catalog];
+  pushed_version = std::max(pushed_version, version);
+}
+
 TPlanResult Calcite::processImpl(
     const Catalog_Namespace::SessionInfo& session_info,
     const std::string sql_string,
@@ -377,7 +515,21 @@ TPlanResult Calcite::processImpl(
   if (server_available_) {
     TPlanResult ret;
     try {
+      pushSchemaSnapshotIfStale(cat);
       auto ms = measure<>::execution([&]() {
+#ifdef HAVE_CALCITE_JNI
+        if (jni_) {
+          ret = jni_->process(user,
+                              session,
+                              catalog,
+                              sql_string,
+                              filter_push_down_info,
+                              legacy_syntax,
+                              is_explain,
+                              binary_plan_);
+          return;
+        }
+#endif
         std::pair<mapd::shared_ptr<CalciteServerClient>, mapd::shared_ptr<TTransport>>
             clientP = get_client(remote_calcite_port_);
         clientP.first->process(ret,
@@ -387,12 +539,18 @@ TPlanResult Calcite::processImpl(
                                sql_string,
                                filter_push_down_info,
                                legacy_syntax,
-                               is_explain);
+                               is_explain,
+                               binary_plan_);
         clientP.second->close();
       });
+      if (!ret.plan_result_binary.empty()) {
+        // the binary plan is recognized by its header wherever the plan is consumed
+        ret.plan_result = std::move(ret.plan_result_binary);
+        ret.plan_result_binary.clear();
+      }
 
       // LOG(INFO) << ret.plan_result;
-      LOG(INFO) << "Time in Thrift "
+      LOG(INFO) << "Time in " << (jni_ ? "JNI " : "Thrift ")
                 << (ms > ret.execution_time_ms ? ms - ret.execution_time_ms : 0)
                 << " (ms), Time in Java Calcite server " << ret.execution_time_ms
                 << " (ms)";
@@ -413,6 +571,13 @@ std::string Calcite::getExtensionFunctionWhitelist() {
     TPlanResult ret;
     std::string whitelist;
 
+#ifdef HAVE_CALCITE_JNI
+    if (jni_) {
+      whitelist = jni_->getExtensionFunctionWhitelist();
+      VLOG(1) << whitelist;
+      return whitelist;
+    }
+#endif
     std::pair<mapd::shared_ptr<CalciteServerClient>, mapd::shared_ptr<TTransport>>
         clientP = get_client(remote_calcite_port_);
     clientP.first->getExtensionFunctionWhitelist(whitelist);
@@ -428,6 +593,11 @@ std::string Calcite::getExtensionFunctionWhitelist() {
 }
 
 void Calcite::close_calcite_server() {
+  if (jni_) {
+    // the embedded JVM can't be restarted within the process, it lives until exit
+    server_available_ = false;
+    return;
+  }
   if (server_available_) {
     LOG(INFO) << "Shutting down Calcite server";
     try {
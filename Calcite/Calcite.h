@@ -24,20 +24,27 @@
 #ifndef CALCITE_H
 #define CALCITE_H
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include "Shared/MapDParameters.h"
 #include "rapidjson/document.h"
 
 namespace Catalog_Namespace {
+class Catalog;
 class SessionInfo;
-}
+}  // namespace Catalog_Namespace
+
+class CalciteJNI;
 
 // Forward declares for Thrift-generated classes
 class TFilterPushDownInfo;
 class TPlanResult;
 class TCompletionHint;
+class TSchemaSnapshot;
 
 class Calcite {
  public:
@@ -76,6 +83,7 @@ class Calcite {
             const int port,
             const std::string& data_dir,
             const size_t calcite_max_mem);
+  void initInProcess(const MapDParameters& mapd_parameter, const std::string& data_dir);
   void runServer(const int mapd_port,
                  const int port,
                  const std::string& data_dir,
@@ -86,6 +94,9 @@ class Calcite {
                           const bool legacy_syntax,
                           const bool is_explain);
   std::vector<std::string> get_db_objects(const std::string ra);
+  void pushSchemaSnapshotIfStale(const Catalog_Namespace::Catalog& cat);
+  TSchemaSnapshot buildSchemaSnapshot(const Catalog_Namespace::Catalog& cat,
+                                      const int64_t version) const;
 
   std::thread calcite_server_thread_;
   int ping();
@@ -95,6 +106,20 @@ class Calcite {
   std::string ssl_trust_store_;
   std::string ssl_trust_password_;
   std::string session_prefix_;
+  // set when the planner is hosted in-process instead of in a separate server
+  std::shared_ptr<CalciteJNI> jni_;
+  // request executable plans in the binary format instead of JSON
+  bool binary_plan_{false};
+
+  // Per-catalog schema versions, bumped by updateMetadata() on DDL once the catalog has
+  // published its new descriptor maps. A snapshot of the catalog is only serialized and
+  // pushed to the Calcite server when the version it last received is older than the
+  // current one.
+  std::mutex schema_versions_mutex_;
+  std::unordered_map<std::string, int64_t> schema_versions_;
+  std::unordered_map<std::string, int64_t> pushed_schema_versions_;
+  // serializes snapshot pushes with the metadata updates which invalidate them
+  std::mutex schema_push_mutex_;
 };
 
 #endif /* CALCITE_H */
@@ -0,0 +1,300 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CalciteJNI.h"
+#include "Shared/mapd_shared_ptr.h"
+#include "Shared/mapdpath.h"
+
+#include <glog/logging.h>
+#include <stdexcept>
+
+#include "Shared/fixautotools.h"
+
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/transport/TBufferTransports.h>
+
+#include "Shared/fixautotools.h"
+
+#include "gen-cpp/CalciteServer.h"
+
+using namespace apache::thrift::protocol;
+using namespace apache::thrift::transport;
+
+namespace {
+
+const char* calcite_direct_class = "com/mapd/parser/server/CalciteDirect";
+
+template <typename T>
+std::string serialize_thrift(const T& obj) {
+  auto buffer = mapd::make_shared<TMemoryBuffer>();
+  TBinaryProtocol protocol(buffer);
+  obj.write(&protocol);
+  return buffer->getBufferAsString();
+}
+
+template <typename T>
+void deserialize_thrift(T& obj, const std::string& bytes) {
+  auto buffer = mapd::make_shared<TMemoryBuffer>(
+      reinterpret_cast<uint8_t*>(const_cast<char*>(bytes.data())),
+      bytes.size(),
+      TMemoryBuffer::OBSERVE);
+  TBinaryProtocol protocol(buffer);
+  obj.read(&protocol);
+}
+
+// Releases the local references created during one call into the JVM.
+class LocalFrame {
+ public:
+  LocalFrame(JNIEnv* env, const jint capacity) : env_(env) {
+    CHECK_EQ(env_->PushLocalFrame(capacity), 0);
+  }
+  ~LocalFrame() { env_->PopLocalFrame(nullptr); }
+
+ private:
+  JNIEnv* env_;
+};
+
+JavaVM* get_or_create_jvm(const std::string& data_dir, const size_t calcite_max_mem) {
+  // a process can only ever host a single JVM
+  JavaVM* jvm{nullptr};
+  jsize num_vms{0};
+  if (JNI_GetCreatedJavaVMs(&jvm, 1, &num_vms) == JNI_OK && num_vms > 0) {
+    return jvm;
+  }
+  std::vector<std::string> option_strings{
+      "-Djava.class.path=" + mapd_root_abs_path() +
+          "/bin/calcite-1.0-SNAPSHOT-jar-with-dependencies.jar",
+      "-Xmx" + std::to_string(calcite_max_mem) + "m",
+      "-DMAPD_LOG_DIR=" + data_dir};
+  std::vector<JavaVMOption> options(option_strings.size());
+  for (size_t i = 0; i < option_strings.size(); ++i) {
+    options[i].optionString = const_cast<char*>(option_strings[i].c_str());
+    options[i].extraInfo = nullptr;
+  }
+  JavaVMInitArgs vm_args;
+  vm_args.version = JNI_VERSION_1_8;
+  vm_args.nOptions = options.size();
+  vm_args.options = options.data();
+  vm_args.ignoreUnrecognized = JNI_FALSE;
+  JNIEnv* env{nullptr};
+  const auto status =
+      JNI_CreateJavaVM(&jvm, reinterpret_cast<void**>(&env), &vm_args);
+  if (status != JNI_OK) {
+    LOG(FATAL) << "Failed to create the Calcite JVM, error " << status;
+  }
+  return jvm;
+}
+
+}  // namespace
+
+CalciteJNI::CalciteJNI(const int mapd_port,
+                       const std::string& data_dir,
+                       const size_t calcite_max_mem,
+                       const size_t planner_pool_size,
+                       const std::string& ssl_trust_store,
+                       const std::string& ssl_trust_password)
+    : jvm_(get_or_create_jvm(data_dir, calcite_max_mem)) {
+  auto env = getEnv();
+  LocalFrame frame(env, 16);
+  auto handler_class = env->FindClass(calcite_direct_class);
+  checkException(env);
+  CHECK(handler_class);
+  auto ctor_mid = env->GetMethodID(
+      handler_class,
+      "<init>",
+      "(ILjava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;I)V");
+  CHECK(ctor_mid);
+  const auto handler = env->NewObject(handler_class,
+                                      ctor_mid,
+                                      static_cast<jint>(mapd_port),
+                                      toJString(env, data_dir),
+                                      toJString(env, mapd_root_abs_path() + "/QueryEngine/"),
+                                      toJString(env, ssl_trust_store),
+                                      toJString(env, ssl_trust_password),
+                                      static_cast<jint>(planner_pool_size));
+  checkException(env);
+  CHECK(handler);
+  handler_ = env->NewGlobalRef(handler);
+  process_mid_ = env->GetMethodID(
+      handler_class,
+      "process",
+      "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;[IZZZ)[B");
+  completion_hints_mid_ = env->GetMethodID(handler_class,
+                                           "getCompletionHints",
+                                           "(Ljava/lang/String;Ljava/lang/String;Ljava/"
+                                           "lang/String;[Ljava/lang/String;Ljava/lang/"
+                                           "String;I)[[B");
+  whitelist_mid_ = env->GetMethodID(
+      handler_class, "getExtensionFunctionWhitelist", "()Ljava/lang/String;");
+  update_metadata_mid_ = env->GetMethodID(
+      handler_class, "updateMetadata", "(Ljava/lang/String;Ljava/lang/String;)V");
+  update_schema_snapshot_mid_ =
+      env->GetMethodID(handler_class, "updateSchemaSnapshot", "([B)V");
+  CHECK(process_mid_ && completion_hints_mid_ && whitelist_mid_ &&
+        update_metadata_mid_ && update_schema_snapshot_mid_);
+  LOG(INFO) << "In-process Calcite planner started with " << planner_pool_size
+            << " planner instances";
+}
+
+TPlanResult CalciteJNI::process(
+    const std::string& user,
+    const std::string& session,
+    const std::string& catalog,
+    const std::string& sql_string,
+    const std::vector<TFilterPushDownInfo>& filter_push_down_info,
+    const bool legacy_syntax,
+    const bool is_explain,
+    const bool binary_plan) {
+  auto env = getEnv();
+  LocalFrame frame(env, 16);
+  std::vector<jint> push_down_triples;
+  for (const auto& push_down : filter_push_down_info) {
+    push_down_triples.push_back(push_down.input_prev);
+    push_down_triples.push_back(push_down.input_start);
+    push_down_triples.push_back(push_down.input_next);
+  }
+  auto push_down_arr = env->NewIntArray(push_down_triples.size());
+  env->SetIntArrayRegion(
+      push_down_arr, 0, push_down_triples.size(), push_down_triples.data());
+  auto result_bytes =
+      static_cast<jbyteArray>(env->CallObjectMethod(handler_,
+                                                    process_mid_,
+                                                    toJString(env, user),
+                                                    toJString(env, session),
+                                                    toJString(env, catalog),
+                                                    toJString(env, sql_string),
+                                                    push_down_arr,
+                                                    static_cast<jboolean>(legacy_syntax),
+                                                    static_cast<jboolean>(is_explain),
+                                                    static_cast<jboolean>(binary_plan)));
+  checkException(env);
+  TPlanResult ret;
+  deserialize_thrift(ret, fromJByteArray(env, result_bytes));
+  return ret;
+}
+
+std::vector<TCompletionHint> CalciteJNI::getCompletionHints(
+    const std::string& user,
+    const std::string& session,
+    const std::string& catalog,
+    const std::vector<std::string>& visible_tables,
+    const std::string& sql_string,
+    const int cursor) {
+  auto env = getEnv();
+  LocalFrame frame(env, 16 + visible_tables.size());
+  auto string_class = env->FindClass("java/lang/String");
+  auto tables_arr = env->NewObjectArray(visible_tables.size(), string_class, nullptr);
+  for (size_t i = 0; i < visible_tables.size(); ++i) {
+    env->SetObjectArrayElement(tables_arr, i, toJString(env, visible_tables[i]));
+  }
+  auto hints_arr = static_cast<jobjectArray>(env->CallObjectMethod(handler_,
+                                                                   completion_hints_mid_,
+                                                                   toJString(env, user),
+                                                                   toJString(env, session),
+                                                                   toJString(env, catalog),
+                                                                   tables_arr,
+                                                                   toJString(env, sql_string),
+                                                                   static_cast<jint>(cursor)));
+  checkException(env);
+  std::vector<TCompletionHint> hints;
+  const auto num_hints = env->GetArrayLength(hints_arr);
+  for (jsize i = 0; i < num_hints; ++i) {
+    auto hint_bytes = static_cast<jbyteArray>(env->GetObjectArrayElement(hints_arr, i));
+    TCompletionHint hint;
+    deserialize_thrift(hint, fromJByteArray(env, hint_bytes));
+    hints.push_back(hint);
+    env->DeleteLocalRef(hint_bytes);
+  }
+  return hints;
+}
+
+std::string CalciteJNI::getExtensionFunctionWhitelist() {
+  auto env = getEnv();
+  LocalFrame frame(env, 4);
+  auto whitelist =
+      static_cast<jstring>(env->CallObjectMethod(handler_, whitelist_mid_));
+  checkException(env);
+  return fromJString(env, whitelist);
+}
+
+void CalciteJNI::updateMetadata(const std::string& catalog, const std::string& table) {
+  auto env = getEnv();
+  LocalFrame frame(env, 4);
+  env->CallVoidMethod(
+      handler_, update_metadata_mid_, toJString(env, catalog), toJString(env, table));
+  checkException(env);
+}
+
+void CalciteJNI::updateSchemaSnapshot(const TSchemaSnapshot& snapshot) {
+  auto env = getEnv();
+  LocalFrame frame(env, 4);
+  const auto snapshot_bytes = serialize_thrift(snapshot);
+  auto snapshot_arr = env->NewByteArray(snapshot_bytes.size());
+  env->SetByteArrayRegion(snapshot_arr,
+                          0,
+                          snapshot_bytes.size(),
+                          reinterpret_cast<const jbyte*>(snapshot_bytes.data()));
+  env->CallVoidMethod(handler_, update_schema_snapshot_mid_, snapshot_arr);
+  checkException(env);
+}
+
+JNIEnv* CalciteJNI::getEnv() {
+  JNIEnv* env{nullptr};
+  const auto status = jvm_->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_8);
+  if (status == JNI_EDETACHED) {
+    // daemon threads don't keep the JVM from shutting down at process exit
+    CHECK_EQ(jvm_->AttachCurrentThreadAsDaemon(reinterpret_cast<void**>(&env), nullptr),
+             JNI_OK);
+  } else {
+    CHECK_EQ(status, JNI_OK);
+  }
+  return env;
+}
+
+void CalciteJNI::checkException(JNIEnv* env) {
+  if (!env->ExceptionCheck()) {
+    return;
+  }
+  auto ex = env->ExceptionOccurred();
+  env->ExceptionClear();
+  auto throwable_class = env->FindClass("java/lang/Throwable");
+  auto get_message_mid =
+      env->GetMethodID(throwable_class, "getMessage", "()Ljava/lang/String;");
+  auto message = static_cast<jstring>(env->CallObjectMethod(ex, get_message_mid));
+  const auto what = message ? fromJString(env, message) : "Calcite planner error";
+  auto parse_error_class = env->FindClass("java/lang/IllegalArgumentException");
+  if (env->IsInstanceOf(ex, parse_error_class)) {
+    throw std::invalid_argument(what);
+  }
+  throw std::runtime_error(what);
+}
+
+jstring CalciteJNI::toJString(JNIEnv* env, const std::string& str) {
+  return env->NewStringUTF(str.c_str());
+}
+
+std::string CalciteJNI::fromJString(JNIEnv* env, jstring str) {
+  const auto chars = env->GetStringUTFChars(str, nullptr);
+  std::string ret(chars);
+  env->ReleaseStringUTFChars(str, chars);
+  return ret;
+}
+
+std::string CalciteJNI::fromJByteArray(JNIEnv* env, jbyteArray bytes) {
+  std::string ret(env->GetArrayLength(bytes), '\0');
+  env->GetByteArrayRegion(bytes, 0, ret.size(), reinterpret_cast<jbyte*>(&ret[0]));
+  return ret;
+}
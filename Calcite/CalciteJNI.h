@@ -0,0 +1,94 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    CalciteJNI.h
+ * @brief   Hosts the Calcite planner inside the server process through JNI.
+ *
+ * The planner runs in an embedded JVM, so planning a query doesn't need a socket round
+ * trip to the standalone Calcite server. Requests and results cross the boundary as
+ * Thrift binary-encoded buffers instead of going through a Thrift transport. Planner
+ * instances are pooled on the Java side; any server thread may call in concurrently.
+ */
+
+#ifndef CALCITE_CALCITEJNI_H
+#define CALCITE_CALCITEJNI_H
+
+#include <jni.h>
+
+#include <string>
+#include <vector>
+
+class TCompletionHint;
+class TFilterPushDownInfo;
+class TPlanResult;
+class TSchemaSnapshot;
+
+class CalciteJNI {
+ public:
+  CalciteJNI(const int mapd_port,
+             const std::string& data_dir,
+             const size_t calcite_max_mem,
+             const size_t planner_pool_size,
+             const std::string& ssl_trust_store,
+             const std::string& ssl_trust_password);
+
+  TPlanResult process(const std::string& user,
+                      const std::string& session,
+                      const std::string& catalog,
+                      const std::string& sql_string,
+                      const std::vector<TFilterPushDownInfo>& filter_push_down_info,
+                      const bool legacy_syntax,
+                      const bool is_explain,
+                      const bool binary_plan);
+
+  std::vector<TCompletionHint> getCompletionHints(
+      const std::string& user,
+      const std::string& session,
+      const std::string& catalog,
+      const std::vector<std::string>& visible_tables,
+      const std::string& sql_string,
+      const int cursor);
+
+  std::string getExtensionFunctionWhitelist();
+
+  void updateMetadata(const std::string& catalog, const std::string& table);
+
+  void updateSchemaSnapshot(const TSchemaSnapshot& snapshot);
+
+ private:
+  // Returns the JNI environment of the calling thread, attaching it to the JVM first
+  // if needed. Threads stay attached for their lifetime.
+  JNIEnv* getEnv();
+
+  // Rethrows a pending Java exception as a C++ one; parse errors surface as
+  // std::invalid_argument, like the Thrift InvalidParseRequest does.
+  void checkException(JNIEnv* env);
+
+  jstring toJString(JNIEnv* env, const std::string& str);
+  std::string fromJString(JNIEnv* env, jstring str);
+  std::string fromJByteArray(JNIEnv* env, jbyteArray bytes);
+
+  JavaVM* jvm_;
+  jobject handler_;
+  jmethodID process_mid_;
+  jmethodID completion_hints_mid_;
+  jmethodID whitelist_mid_;
+  jmethodID update_metadata_mid_;
+  jmethodID update_schema_snapshot_mid_;
+};
+
+#endif  // CALCITE_CALCITEJNI_H
@@ -26,6 +26,7 @@
 #include <algorithm>
 #include <cassert>
 #include <exception>
+#include <future>
 #include <list>
 #include <memory>
 #include <random>
@@ -54,6 +55,7 @@
 #include "../Shared/File.h"
 #include "../Shared/StringTransform.h"
 #include "../Shared/measure.h"
+#include "../Shared/thread_count.h"
 #include "../StringDictionary/StringDictionaryClient.h"
 #include "MapDRelease.h"
 #include "SharedDictionaryValidator.h"
@@ -94,6 +96,7 @@ const int MAPD_TEMP_DICT_START_ID =
 
 const std::string Catalog::physicalTableNameTag_("_shard_#");
 std::map<std::string, std::shared_ptr<Catalog>> Catalog::mapd_cat_map_;
+std::mutex Catalog::mapd_cat_map_mutex_;
 
 thread_local bool Catalog::thread_holds_read_lock = false;
 thread_local bool SysCatalog::thread_holds_read_lock = false;
@@ -173,6 +176,33 @@ class sqlite_lock {
   }
 };
 
+// Catalog write locks nest, e.g. under a system catalog write lock for the tables of the
+// system database, so the maps are published when the outermost one is released.
+inline void on_write_lock(const Catalog* cat) {
+  ++cat->writeLockDepth_;
+}
+
+inline std::vector<std::string> on_write_unlock(const Catalog* cat) {
+  if (--cat->writeLockDepth_ == 0) {
+    cat->publishDescriptorMaps();
+    return cat->takeCalciteUpdates();
+  }
+  return {};
+}
+
+inline void send_calcite_updates(const Catalog* cat,
+                                 const std::vector<std::string>& tableNames) {
+  cat->sendCalciteUpdates(tableNames);
+}
+
+inline void on_write_lock(const SysCatalog*) {}
+
+inline std::vector<std::string> on_write_unlock(const SysCatalog*) {
+  return {};
+}
+
+inline void send_calcite_updates(const SysCatalog*, const std::vector<std::string>&) {}
+
 template <typename T>
 class write_lock {
   const T* catalog;
@@ -197,9 +227,12 @@ class write_lock {
     } else {
       lock_catalog(cat);
     }
+    on_write_lock(catalog);
   }
 
   ~write_lock() {
+    // readers switch to the new maps before the lock is released
+    const auto calcite_updates = on_write_unlock(catalog);
     if (holds_lock) {
       std::thread::id no_thread;
       if (catalog->name() == MAPD_SYSTEM_DB) {
@@ -207,7 +240,10 @@ class write_lock {
       } else {
         catalog->thread_holding_write_lock = no_thread;
       }
+      lock.unlock();
     }
+    // Calcite fetches the new schema from the catalog, don't make it wait on the lock
+    send_calcite_updates(catalog, calcite_updates);
   }
 };
 
@@ -921,7 +957,7 @@ void SysCatalog::createDatabase(const string& name, int owner) {
         "frag_page_size integer, "
         "max_rows bigint, partitions text, shard_column_id integer, shard integer, "
         "num_shards integer, key_metainfo TEXT, version_num "
-        "BIGINT DEFAULT 1) ");
+        "BIGINT DEFAULT 1, mmap_chunks boolean DEFAULT 0) ");
     dbConn->query(
         "CREATE TABLE mapd_columns (tableid integer references mapd_tables, columnid "
         "integer, name text, coltype "
@@ -1098,6 +1134,43 @@ list<DBMetadata> SysCatalog::getAllDBMetadata() {
   return db_list;
 }
 
+void SysCatalog::loadAllCatalogs() {
+  std::vector<DBMetadata> dbs;
+  for (const auto& db : getAllDBMetadata()) {
+    if (!Catalog::get(db.dbName)) {
+      dbs.push_back(db);
+    }
+  }
+  const auto time_ms = measure<>::execution([&]() {
+    const size_t num_threads = std::max(cpu_threads(), 1);
+    for (size_t start = 0; start < dbs.size(); start += num_threads) {
+      std::vector<std::pair<std::string, std::future<std::shared_ptr<Catalog>>>> loads;
+      for (size_t i = start; i < std::min(start + num_threads, dbs.size()); ++i) {
+        const auto& db = dbs[i];
+        loads.emplace_back(db.dbName, std::async(std::launch::async, [this, db] {
+                             return Catalog::get(basePath_,
+                                                 db,
+                                                 dataMgr_,
+                                                 string_dict_hosts_,
+                                                 calciteMgr_,
+                                                 false);
+                           }));
+      }
+      for (auto& load : loads) {
+        try {
+          load.second.get();
+        } catch (const std::exception& e) {
+          // left to be loaded on first access, which reports the error to the client
+          LOG(ERROR) << "Failed to load the catalog of database " << load.first << ": "
+                     << e.what();
+        }
+      }
+    }
+  });
+  LOG(INFO) << "Loaded the catalogs of " << dbs.size() << " databases in " << time_ms
+            << "ms";
+}
+
 list<UserMetadata> SysCatalog::getAllUserMetadata(long dbId) {
   // this call is to return users that have some form of permissions to objects in the db
   // sadly mapd_object_permissions table is also misused to manage user roles.
@@ -1761,6 +1834,10 @@ Catalog::Catalog(const string& basePath,
   if (!is_new_db) {
     CheckAndExecuteMigrationsPostBuildMaps();
   }
+  // filled in directly, and possibly published half way by a nested write lock
+  tableMapsChanged_ = true;
+  columnMapsChanged_ = true;
+  publishDescriptorMaps();
 
   /*
   TODO(wamsi): Enable creation of dashboard roles
@@ -1793,6 +1870,121 @@ Catalog::~Catalog() {
   }
 
   // ColumnDescriptorMapById points to the same descriptors.  No need to delete
+
+  tableDescriptorMap_.clear();
+  tableDescriptorMapById_.clear();
+  columnDescriptorMap_.clear();
+  columnDescriptorMapById_.clear();
+}
+
+Catalog::RetiredDescriptors::~RetiredDescriptors() {
+  for (auto td : tables) {
+    if (td->fragmenter != nullptr) {
+      delete td->fragmenter;
+    }
+    delete td;
+  }
+  for (auto cd : columns) {
+    delete cd;
+  }
+}
+
+void Catalog::publishDescriptorMaps() const {
+  auto previous = std::atomic_load(&descriptorMapsSnapshot_);
+  if (previous && !tableMapsChanged_ && !columnMapsChanged_ &&
+      pendingRetiredTables_.empty() && pendingRetiredColumns_.empty()) {
+    return;
+  }
+  auto snapshot = std::make_shared<DescriptorMaps>();
+  if (previous && !tableMapsChanged_) {
+    snapshot->tableDescriptorMap = previous->tableDescriptorMap;
+    snapshot->tableDescriptorMapById = previous->tableDescriptorMapById;
+  } else {
+    snapshot->tableDescriptorMap =
+        std::make_shared<const TableDescriptorMap>(tableDescriptorMap_);
+    snapshot->tableDescriptorMapById =
+        std::make_shared<const TableDescriptorMapById>(tableDescriptorMapById_);
+  }
+  if (previous && !columnMapsChanged_) {
+    snapshot->columnDescriptorMap = previous->columnDescriptorMap;
+    snapshot->columnDescriptorMapById = previous->columnDescriptorMapById;
+  } else {
+    snapshot->columnDescriptorMap =
+        std::make_shared<const ColumnDescriptorMap>(columnDescriptorMap_);
+    snapshot->columnDescriptorMapById =
+        std::make_shared<const ColumnDescriptorMapById>(columnDescriptorMapById_);
+  }
+  tableMapsChanged_ = false;
+  columnMapsChanged_ = false;
+  snapshot->retired = std::make_shared<RetiredDescriptors>();
+  if (retiredDescriptors_) {
+    // removed since the previous snapshot, which may still be in use
+    retiredDescriptors_->tables.swap(pendingRetiredTables_);
+    retiredDescriptors_->columns.swap(pendingRetiredColumns_);
+    retiredDescriptors_->next = snapshot->retired;
+  } else {
+    // nothing was published yet, so nobody can hold a reference
+    RetiredDescriptors unreferenced;
+    unreferenced.tables.swap(pendingRetiredTables_);
+    unreferenced.columns.swap(pendingRetiredColumns_);
+  }
+  retiredDescriptors_ = snapshot->retired;
+  std::atomic_store(&descriptorMapsSnapshot_,
+                    std::shared_ptr<const DescriptorMaps>(std::move(snapshot)));
+  ++descriptorMapsVersion_;
+}
+
+std::vector<std::string> Catalog::takeCalciteUpdates() const {
+  std::vector<std::string> tableNames;
+  tableNames.swap(pendingCalciteUpdates_);
+  return tableNames;
+}
+
+void Catalog::sendCalciteUpdates(const std::vector<std::string>& tableNames) const {
+  for (const auto& tableName : tableNames) {
+    calciteMgr_->updateMetadata(currentDB_.dbName, tableName);
+  }
+}
+
+void Catalog::updateCalciteMetadata(const std::string& tableName) const {
+  const auto writer = name() == MAPD_SYSTEM_DB
+                          ? SysCatalog::instance().thread_holding_write_lock.load()
+                          : thread_holding_write_lock.load();
+  if (writer == std::this_thread::get_id() && writeLockDepth_ > 0) {
+    pendingCalciteUpdates_.push_back(tableName);
+    return;
+  }
+  calciteMgr_->updateMetadata(currentDB_.dbName, tableName);
+}
+
+Catalog::DescriptorMapsView Catalog::getDescriptorMaps() const {
+  const auto writer = name() == MAPD_SYSTEM_DB
+                          ? SysCatalog::instance().thread_holding_write_lock.load()
+                          : thread_holding_write_lock.load();
+  if (writer != std::this_thread::get_id()) {
+    auto snapshot = std::atomic_load(&descriptorMapsSnapshot_);
+    if (snapshot) {
+      return {*snapshot->tableDescriptorMap,
+              *snapshot->tableDescriptorMapById,
+              *snapshot->columnDescriptorMap,
+              *snapshot->columnDescriptorMapById,
+              snapshot};
+    }
+  }
+  // either changing the maps or still in the constructor
+  return {tableDescriptorMap_,
+          tableDescriptorMapById_,
+          columnDescriptorMap_,
+          columnDescriptorMapById_,
+          nullptr};
+}
+
+void Catalog::retireTableDescriptor(TableDescriptor* td) {
+  pendingRetiredTables_.push_back(td);
+}
+
+void Catalog::retireColumnDescriptor(ColumnDescriptor* cd) {
+  pendingRetiredColumns_.push_back(cd);
 }
 
 void Catalog::updateTableDescriptorSchema() {
@@ -1835,6 +2027,9 @@ void Catalog::updateTableDescriptorSchema() {
                          std::to_string(MAPD_ROOT_USER_ID));
       sqliteConnector_.query(queryString);
     }
+    if (std::find(cols.begin(), cols.end(), std::string("mmap_chunks")) == cols.end()) {
+      sqliteConnector_.query("ALTER TABLE mapd_tables ADD mmap_chunks boolean DEFAULT 0");
+    }
   } catch (std::exception& e) {
     sqliteConnector_.query("ROLLBACK TRANSACTION");
     throw;
@@ -2585,9 +2780,8 @@ std::string getUserFromId(const int32_t id) {
 }  // namespace
 
 void Catalog::buildMaps() {
-  sys_write_lock write_lock_sys(&SysCatalog::instance());
-  sys_sqlite_lock sqlite_lock_sys(&SysCatalog::instance());
-
+  // Only takes the locks of this catalog, so the catalogs of different databases can
+  // be built concurrently. Resolving dashboard owners locks the system catalog itself.
   cat_write_lock write_lock(this);
   cat_sqlite_lock sqlite_lock(this);
 
@@ -2612,8 +2806,8 @@ void Catalog::buildMaps() {
   string tableQuery(
       "SELECT tableid, name, ncolumns, isview, fragments, frag_type, max_frag_rows, "
       "max_chunk_size, frag_page_size, "
-      "max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, userid "
-      "from mapd_tables");
+      "max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, userid, "
+      "mmap_chunks from mapd_tables");
   sqliteConnector_.query(tableQuery);
   numRows = sqliteConnector_.getNumRows();
   for (size_t r = 0; r < numRows; ++r) {
@@ -2635,9 +2829,13 @@ void Catalog::buildMaps() {
     td->nShards = sqliteConnector_.getData<int>(r, 13);
     td->keyMetainfo = sqliteConnector_.getData<string>(r, 14);
     td->userId = sqliteConnector_.getData<int>(r, 15);
+    td->mmapChunks = sqliteConnector_.getData<bool>(r, 16);
     if (!td->isView) {
       td->fragmenter = nullptr;
     }
+    if (td->mmapChunks) {
+      dataMgr_->setTableMmapChunks(currentDB_.dbId, td->tableId, true);
+    }
     td->hasDeletedCol = false;
     tableDescriptorMap_[to_upper(td->tableName)] = td;
     tableDescriptorMapById_[td->tableId] = td;
@@ -2780,6 +2978,8 @@ void Catalog::addTableToMap(TableDescriptor& td,
   new_td->mutex_ = std::make_shared<std::mutex>();
   tableDescriptorMap_[to_upper(td.tableName)] = new_td;
   tableDescriptorMapById_[td.tableId] = new_td;
+  tableMapsChanged_ = true;
+  columnMapsChanged_ = true;
   for (auto cd : columns) {
     ColumnDescriptor* new_cd = new ColumnDescriptor();
     *new_cd = cd;
@@ -2837,11 +3037,11 @@ void Catalog::removeTableFromMap(const string& tableName, int tableId) {
 
   tableDescriptorMapById_.erase(tableDescIt);
   tableDescriptorMap_.erase(to_upper(tableName));
-  if (td->fragmenter != nullptr) {
-    delete td->fragmenter;
-  }
+  tableMapsChanged_ = true;
+  columnMapsChanged_ = true;
   bool isTemp = td->persistenceLevel == Data_Namespace::MemoryLevel::CPU_LEVEL;
-  delete td;
+  // freed along with its fragmenter once no snapshot references it
+  retireTableDescriptor(td);
 
   std::unique_ptr<StringDictionaryClient> client;
   if (SysCatalog::instance().isAggregator()) {
@@ -2887,7 +3087,7 @@ void Catalog::removeTableFromMap(const string& tableName, int tableId) {
         }
       }
 
-      delete cd;
+      retireColumnDescriptor(cd);
     }
   }
 }
@@ -3010,9 +3210,9 @@ const TableDescriptor* Catalog::getMetadataForTable(const string& tableName,
                                                     const bool populateFragmenter) const {
   // we give option not to populate fragmenter (default true/yes) as it can be heavy for
   // pure metadata calls
-  cat_read_lock read_lock(this);
-  auto tableDescIt = tableDescriptorMap_.find(to_upper(tableName));
-  if (tableDescIt == tableDescriptorMap_.end()) {  // check to make sure table exists
+  const auto maps = getDescriptorMaps();
+  auto tableDescIt = maps.tableDescriptorMap.find(to_upper(tableName));
+  if (tableDescIt == maps.tableDescriptorMap.end()) {  // check to make sure table exists
     return nullptr;
   }
   TableDescriptor* td = tableDescIt->second;
@@ -3026,9 +3226,9 @@ const TableDescriptor* Catalog::getMetadataForTable(const string& tableName,
 const TableDescriptor* Catalog::getMetadataForTableImpl(
     int tableId,
     const bool populateFragmenter) const {
-  cat_read_lock read_lock(this);
-  auto tableDescIt = tableDescriptorMapById_.find(tableId);
-  if (tableDescIt == tableDescriptorMapById_.end()) {  // check to make sure table exists
+  const auto maps = getDescriptorMaps();
+  auto tableDescIt = maps.tableDescriptorMapById.find(tableId);
+  if (tableDescIt == maps.tableDescriptorMapById.end()) {  // check to make sure table exists
     return nullptr;
   }
   TableDescriptor* td = tableDescIt->second;
@@ -3085,23 +3285,23 @@ const std::vector<LeafHostInfo>& Catalog::getStringDictionaryHosts() const {
 
 const ColumnDescriptor* Catalog::getMetadataForColumn(int tableId,
                                                       const string& columnName) const {
-  cat_read_lock read_lock(this);
+  const auto maps = getDescriptorMaps();
 
   ColumnKey columnKey(tableId, to_upper(columnName));
-  auto colDescIt = columnDescriptorMap_.find(columnKey);
+  auto colDescIt = maps.columnDescriptorMap.find(columnKey);
   if (colDescIt ==
-      columnDescriptorMap_.end()) {  // need to check to make sure column exists for table
+      maps.columnDescriptorMap.end()) {  // need to check to make sure column exists for table
     return nullptr;
   }
   return colDescIt->second;
 }
 
 const ColumnDescriptor* Catalog::getMetadataForColumn(int tableId, int columnId) const {
-  cat_read_lock read_lock(this);
+  const auto maps = getDescriptorMaps();
 
   ColumnIdKey columnIdKey(tableId, columnId);
-  auto colDescIt = columnDescriptorMapById_.find(columnIdKey);
-  if (colDescIt == columnDescriptorMapById_
+  auto colDescIt = maps.columnDescriptorMapById.find(columnIdKey);
+  if (colDescIt == maps.columnDescriptorMapById
                        .end()) {  // need to check to make sure column exists for table
     return nullptr;
   }
@@ -3253,9 +3453,9 @@ void Catalog::getAllColumnMetadataForTable(
     const bool fetchSystemColumns,
     const bool fetchVirtualColumns,
     const bool fetchPhysicalColumns) const {
-  cat_read_lock read_lock(this);
+  const auto maps = getDescriptorMaps();
   int32_t skip_physical_cols = 0;
-  for (const auto& columnDescriptor : columnDescriptorMapById_) {
+  for (const auto& columnDescriptor : maps.columnDescriptorMapById) {
     if (!fetchPhysicalColumns && skip_physical_cols > 0) {
       --skip_physical_cols;
       continue;
@@ -3283,7 +3483,6 @@ list<const ColumnDescriptor*> Catalog::getAllColumnMetadataForTable(
     const bool fetchSystemColumns,
     const bool fetchVirtualColumns,
     const bool fetchPhysicalColumns) const {
-  cat_read_lock read_lock(this);
   list<const ColumnDescriptor*> columnDescriptors;
   const TableDescriptor* td =
       getMetadataForTableImpl(tableId, false);  // dont instantiate fragmenter
@@ -3296,9 +3495,9 @@ list<const ColumnDescriptor*> Catalog::getAllColumnMetadataForTable(
 }
 
 list<const TableDescriptor*> Catalog::getAllTableMetadata() const {
-  cat_read_lock read_lock(this);
+  const auto maps = getDescriptorMaps();
   list<const TableDescriptor*> table_list;
-  for (auto p : tableDescriptorMapById_) {
+  for (auto p : maps.tableDescriptorMapById) {
     table_list.push_back(p.second);
   }
   return table_list;
@@ -3442,66 +3641,71 @@ void Catalog::addColumn(const TableDescriptor& td, ColumnDescriptor& cd) {
       std::vector<std::string>{std::to_string(td.tableId), cd.columnName});
   cd.columnId = sqliteConnector_.getData<int>(0, 0);
 
+  cat_write_lock write_lock(this);
   ++tableDescriptorMapById_[td.tableId]->nColumns;
   auto ncd = new ColumnDescriptor(cd);
   columnDescriptorMap_[ColumnKey(cd.tableId, to_upper(cd.columnName))] = ncd;
   columnDescriptorMapById_[ColumnIdKey(cd.tableId, cd.columnId)] = ncd;
+  columnMapsChanged_ = true;
   columnDescriptorsForRoll.emplace_back(nullptr, ncd);
 }
 
 void Catalog::roll(const bool forward) {
   std::set<const TableDescriptor*> tds;
+  {
+    cat_write_lock write_lock(this);
+    for (const auto& cdr : columnDescriptorsForRoll) {
+      auto ocd = cdr.first;
+      auto ncd = cdr.second;
+      CHECK(ocd || ncd);
+      auto tabDescIt = tableDescriptorMapById_.find((ncd ? ncd : ocd)->tableId);
+      CHECK(tableDescriptorMapById_.end() != tabDescIt);
+      auto td = tabDescIt->second;
+      auto& vc = td->columnIdBySpi_;
+      if (forward) {
+        if (ocd) {
+          if (nullptr == ncd ||
+              ncd->columnType.get_comp_param() != ocd->columnType.get_comp_param()) {
+            delDictionary(*ocd);
+          }
 
-  for (const auto& cdr : columnDescriptorsForRoll) {
-    auto ocd = cdr.first;
-    auto ncd = cdr.second;
-    CHECK(ocd || ncd);
-    auto tabDescIt = tableDescriptorMapById_.find((ncd ? ncd : ocd)->tableId);
-    CHECK(tableDescriptorMapById_.end() != tabDescIt);
-    auto td = tabDescIt->second;
-    auto& vc = td->columnIdBySpi_;
-    if (forward) {
-      if (ocd) {
-        if (nullptr == ncd ||
-            ncd->columnType.get_comp_param() != ocd->columnType.get_comp_param()) {
-          delDictionary(*ocd);
-        }
-
-        vc.erase(std::remove(vc.begin(), vc.end(), ocd->columnId), vc.end());
+          vc.erase(std::remove(vc.begin(), vc.end(), ocd->columnId), vc.end());
 
-        delete ocd;
-      }
-      if (ncd) {
-        // append columnId if its new and not phy geo
-        if (vc.end() == std::find(vc.begin(), vc.end(), ncd->columnId)) {
-          if (!ncd->isGeoPhyCol) {
-            vc.push_back(ncd->columnId);
+          retireColumnDescriptor(ocd);
+        }
+        if (ncd) {
+          // append columnId if its new and not phy geo
+          if (vc.end() == std::find(vc.begin(), vc.end(), ncd->columnId)) {
+            if (!ncd->isGeoPhyCol) {
+              vc.push_back(ncd->columnId);
+            }
           }
         }
-      }
-      tds.insert(td);
-    } else {
-      if (ocd) {
-        columnDescriptorMap_[ColumnKey(ocd->tableId, to_upper(ocd->columnName))] = ocd;
-        columnDescriptorMapById_[ColumnIdKey(ocd->tableId, ocd->columnId)] = ocd;
-      }
-      // roll back the dict of new column
-      if (ncd) {
-        columnDescriptorMap_.erase(ColumnKey(ncd->tableId, to_upper(ncd->columnName)));
-        columnDescriptorMapById_.erase(ColumnIdKey(ncd->tableId, ncd->columnId));
-        if (nullptr == ocd ||
-            ocd->columnType.get_comp_param() != ncd->columnType.get_comp_param()) {
-          delDictionary(*ncd);
+        tds.insert(td);
+      } else {
+        if (ocd) {
+          columnDescriptorMap_[ColumnKey(ocd->tableId, to_upper(ocd->columnName))] = ocd;
+          columnDescriptorMapById_[ColumnIdKey(ocd->tableId, ocd->columnId)] = ocd;
+        }
+        // roll back the dict of new column
+        if (ncd) {
+          columnDescriptorMap_.erase(ColumnKey(ncd->tableId, to_upper(ncd->columnName)));
+          columnDescriptorMapById_.erase(ColumnIdKey(ncd->tableId, ncd->columnId));
+          if (nullptr == ocd ||
+              ocd->columnType.get_comp_param() != ncd->columnType.get_comp_param()) {
+            delDictionary(*ncd);
+          }
+          retireColumnDescriptor(ncd);
         }
-        delete ncd;
+        columnMapsChanged_ = true;
       }
     }
+    columnDescriptorsForRoll.clear();
   }
-  columnDescriptorsForRoll.clear();
 
   if (forward) {
     for (const auto td : tds) {
-      calciteMgr_->updateMetadata(currentDB_.dbName, td->tableName);
+      updateCalciteMetadata(td->tableName);
     }
   }
 }
@@ -3693,8 +3897,8 @@ void Catalog::createTable(
           "frag_type, max_frag_rows, "
           "max_chunk_size, "
           "frag_page_size, max_rows, partitions, shard_column_id, shard, num_shards, "
-          "key_metainfo) VALUES (?, ?, ?, "
-          "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+          "key_metainfo, mmap_chunks) VALUES (?, ?, ?, "
+          "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
 
           std::vector<std::string>{td.tableName,
                                    std::to_string(td.userId),
@@ -3710,12 +3914,16 @@ void Catalog::createTable(
                                    std::to_string(td.shardedColumnId),
                                    std::to_string(td.shard),
                                    std::to_string(td.nShards),
-                                   td.keyMetainfo});
+                                   td.keyMetainfo,
+                                   std::to_string(td.mmapChunks)});
 
       // now get the auto generated tableid
       sqliteConnector_.query_with_text_param(
           "SELECT tableid FROM mapd_tables WHERE name = ?", td.tableName);
       td.tableId = sqliteConnector_.getData<int>(0, 0);
+      if (td.mmapChunks) {
+        dataMgr_->setTableMmapChunks(currentDB_.dbId, td.tableId, true);
+      }
       int colId = 1;
       for (auto cd : columns) {
         if (cd.columnType.get_compression() == kENCODING_DICT) {
@@ -3809,7 +4017,7 @@ void Catalog::createTable(
   }
   try {
     addTableToMap(td, cds, dds);
-    calciteMgr_->updateMetadata(currentDB_.dbName, td.tableName);
+    updateCalciteMetadata(td.tableName);
   } catch (std::exception& e) {
     sqliteConnector_.query("ROLLBACK TRANSACTION");
     removeTableFromMap(td.tableName, td.tableId);
@@ -4323,13 +4531,14 @@ void Catalog::renamePhysicalTable(const TableDescriptor* td, const string& newTa
   TableDescriptorMap::iterator tableDescIt =
       tableDescriptorMap_.find(to_upper(td->tableName));
   CHECK(tableDescIt != tableDescriptorMap_.end());
-  calciteMgr_->updateMetadata(currentDB_.dbName, td->tableName);
+  updateCalciteMetadata(td->tableName);
   // Get table descriptor to change it
   TableDescriptor* changeTd = tableDescIt->second;
   changeTd->tableName = newTableName;
   tableDescriptorMap_.erase(tableDescIt);  // erase entry under old name
   tableDescriptorMap_[to_upper(newTableName)] = changeTd;
-  calciteMgr_->updateMetadata(currentDB_.dbName, td->tableName);
+  tableMapsChanged_ = true;
+  updateCalciteMetadata(newTableName);
 }
 
 void Catalog::renameTable(const TableDescriptor* td, const string& newTableName) {
@@ -4390,12 +4599,13 @@ void Catalog::renameColumn(const TableDescriptor* td,
   ColumnDescriptorMap::iterator columnDescIt =
       columnDescriptorMap_.find(std::make_tuple(td->tableId, to_upper(cd->columnName)));
   CHECK(columnDescIt != columnDescriptorMap_.end());
-  calciteMgr_->updateMetadata(currentDB_.dbName, td->tableName);
+  updateCalciteMetadata(td->tableName);
   ColumnDescriptor* changeCd = columnDescIt->second;
   changeCd->columnName = newColumnName;
   columnDescriptorMap_.erase(columnDescIt);  // erase entry under old name
   columnDescriptorMap_[std::make_tuple(td->tableId, to_upper(newColumnName))] = changeCd;
-  calciteMgr_->updateMetadata(currentDB_.dbName, td->tableName);
+  columnMapsChanged_ = true;
+  updateCalciteMetadata(td->tableName);
 }
 
 int32_t Catalog::createFrontendView(FrontendViewDescriptor& vd) {
@@ -4653,7 +4863,7 @@ void Catalog::eraseDBData() {
   }
   // Physically erase database metadata
   boost::filesystem::remove(basePath_ + "/mapd_catalogs/" + currentDB_.dbName);
-  calciteMgr_->updateMetadata(currentDB_.dbName, "");
+  updateCalciteMetadata("");
 }
 
 void Catalog::eraseTablePhysicalData(const TableDescriptor* td) {
@@ -4679,7 +4889,7 @@ void Catalog::eraseTablePhysicalData(const TableDescriptor* td) {
     INJECT_TIMER(Remove_Table);
     dataMgr_->removeTableRelatedDS(currentDB_.dbId, tableId);
   }
-  calciteMgr_->updateMetadata(currentDB_.dbName, td->tableName);
+  updateCalciteMetadata(td->tableName);
   {
     INJECT_TIMER(removeTableFromMap_);
     removeTableFromMap(td->tableName, tableId);
@@ -4726,10 +4936,12 @@ bool SessionInfo::checkDBAccessPrivileges(const DBObjectType& permissionType,
 }
 
 void Catalog::set(const std::string& dbName, std::shared_ptr<Catalog> cat) {
+  std::lock_guard<std::mutex> lock(mapd_cat_map_mutex_);
   mapd_cat_map_[dbName] = cat;
 }
 
 std::shared_ptr<Catalog> Catalog::get(const std::string& dbName) {
+  std::lock_guard<std::mutex> lock(mapd_cat_map_mutex_);
   auto cat_it = mapd_cat_map_.find(dbName);
   if (cat_it != mapd_cat_map_.end()) {
     return cat_it->second;
@@ -4748,14 +4960,17 @@ std::shared_ptr<Catalog> Catalog::get(const string& basePath,
   if (cat) {
     return cat;
   } else {
+    // built without holding the map mutex, so other databases can load meanwhile
     cat = std::make_shared<Catalog>(
         basePath, curDB, dataMgr, string_dict_hosts, calcite, is_new_db);
-    Catalog::set(curDB.dbName, cat);
-    return cat;
+    std::lock_guard<std::mutex> lock(mapd_cat_map_mutex_);
+    // keep the first one if the same database was loaded concurrently
+    return mapd_cat_map_.emplace(curDB.dbName, cat).first->second;
   }
 }
 
 void Catalog::remove(const std::string& dbName) {
+  std::lock_guard<std::mutex> lock(mapd_cat_map_mutex_);
   mapd_cat_map_.erase(dbName);
 }
 
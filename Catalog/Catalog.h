@@ -38,6 +38,7 @@
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <utility>
@@ -269,6 +270,17 @@ class Catalog {
   void eraseTablePhysicalData(const TableDescriptor* td);
   void optimizeTable(const TableDescriptor* td) const;
 
+  // Publishes a snapshot of the current table and column descriptor maps for the
+  // lock-free lookups. Called by the catalog write lock when it is released.
+  void publishDescriptorMaps() const;
+  // Bumped by every publish, so caches derived from the descriptors can tell they
+  // are stale.
+  uint64_t getDescriptorMapsVersion() const { return descriptorMapsVersion_.load(); }
+  // The Calcite updates queued by DDL under the write lock. They are taken while the
+  // lock is still held and sent once it is released.
+  std::vector<std::string> takeCalciteUpdates() const;
+  void sendCalciteUpdates(const std::vector<std::string>& tableNames) const;
+
  protected:
   typedef std::map<std::string, TableDescriptor*> TableDescriptorMap;
   typedef std::map<int, TableDescriptor*> TableDescriptorMapById;
@@ -285,6 +297,37 @@ class Catalog {
   typedef std::unordered_map<const TableDescriptor*, const ColumnDescriptor*>
       DeletedColumnPerTableMap;
 
+  // Descriptors dropped from the maps are only freed once no published snapshot
+  // references them anymore. The bin of each snapshot holds the descriptors removed
+  // while it was the latest one and keeps the bins of all later snapshots alive, so
+  // dropping the oldest snapshot referencing a descriptor is what frees it.
+  struct RetiredDescriptors {
+    ~RetiredDescriptors();
+
+    std::vector<TableDescriptor*> tables;
+    std::vector<ColumnDescriptor*> columns;
+    std::shared_ptr<RetiredDescriptors> next;
+  };
+
+  // Immutable copy of the descriptor maps, replaced on DDL. Maps which didn't change
+  // are shared with the previous snapshot.
+  struct DescriptorMaps {
+    std::shared_ptr<const TableDescriptorMap> tableDescriptorMap;
+    std::shared_ptr<const TableDescriptorMapById> tableDescriptorMapById;
+    std::shared_ptr<const ColumnDescriptorMap> columnDescriptorMap;
+    std::shared_ptr<const ColumnDescriptorMapById> columnDescriptorMapById;
+    std::shared_ptr<RetiredDescriptors> retired;
+  };
+
+  // The maps a lookup reads from; holds on to the snapshot while in use.
+  struct DescriptorMapsView {
+    const TableDescriptorMap& tableDescriptorMap;
+    const TableDescriptorMapById& tableDescriptorMapById;
+    const ColumnDescriptorMap& columnDescriptorMap;
+    const ColumnDescriptorMapById& columnDescriptorMapById;
+    std::shared_ptr<const DescriptorMaps> snapshot;
+  };
+
   void CheckAndExecuteMigrations();
   void CheckAndExecuteMigrationsPostBuildMaps();
   void updateDictionaryNames();
@@ -341,6 +384,16 @@ class Catalog {
 
   const int getColumnIdBySpiUnlocked(const int table_id, const size_t spi) const;
 
+  // Returns the latest published snapshot, or the live maps for the thread holding the
+  // write lock, so that it sees its own changes.
+  DescriptorMapsView getDescriptorMaps() const;
+  void retireTableDescriptor(TableDescriptor* td);
+  void retireColumnDescriptor(ColumnDescriptor* cd);
+  // Tells Calcite about DDL on the table. Under the write lock, this is deferred until
+  // the new maps are published and the lock is released, so that the schema snapshot
+  // Calcite is sent for the new version can't be built from the old maps.
+  void updateCalciteMetadata(const std::string& tableName) const;
+
   std::string basePath_;
   TableDescriptorMap tableDescriptorMap_;
   TableDescriptorMapById tableDescriptorMapById_;
@@ -371,8 +424,20 @@ class Catalog {
       std::vector<std::pair<ColumnDescriptor*, ColumnDescriptor*>>;
   ColumnDescriptorsForRoll columnDescriptorsForRoll;
 
+  // accessed through std::atomic_load / std::atomic_store
+  mutable std::shared_ptr<const DescriptorMaps> descriptorMapsSnapshot_;
+  mutable std::shared_ptr<RetiredDescriptors> retiredDescriptors_;
+  mutable std::vector<TableDescriptor*> pendingRetiredTables_;
+  mutable std::vector<ColumnDescriptor*> pendingRetiredColumns_;
+  // whether the table or column maps changed since they were last published
+  mutable bool tableMapsChanged_{true};
+  mutable bool columnMapsChanged_{true};
+  mutable std::vector<std::string> pendingCalciteUpdates_;
+  mutable std::atomic<uint64_t> descriptorMapsVersion_{0};
+
  private:
   static std::map<std::string, std::shared_ptr<Catalog>> mapd_cat_map_;
+  static std::mutex mapd_cat_map_mutex_;
   DeletedColumnPerTableMap deletedColumnPerTable_;
 
  public:
@@ -380,6 +445,8 @@ class Catalog {
   mutable mapd_shared_mutex sharedMutex_;
   mutable std::atomic<std::thread::id> thread_holding_sqlite_lock;
   mutable std::atomic<std::thread::id> thread_holding_write_lock;
+  // nesting of the write locks of the thread holding them
+  mutable int writeLockDepth_{0};
   // assuming that you never call into a catalog from another catalog via the same thread
   static thread_local bool thread_holds_read_lock;
 };
@@ -429,6 +496,9 @@ class SysCatalog {
   const std::string& getBasePath() const { return basePath_; }
   SqliteConnector* getSqliteConnector() { return sqliteConnector_.get(); }
   std::list<DBMetadata> getAllDBMetadata();
+  // Loads the catalogs of all databases in parallel, so that sessions don't pay for
+  // loading them on first access.
+  void loadAllCatalogs();
   std::list<UserMetadata> getAllUserMetadata();
   /**
    * return the users associated with the given DB
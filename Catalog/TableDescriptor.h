@@ -57,6 +57,7 @@ struct TableDescriptor {
   Data_Namespace::MemoryLevel persistenceLevel;
   bool hasDeletedCol;  // Does table has a delete col, Yes (VACUUM = DELAYED)
                        //                              No  (VACUUM = IMMEDIATE)
+  bool mmapChunks;     // Are chunks served from mapped files, read-only (MMAP = 'TRUE')
   // Spi means Sequential Positional Index which is equivalent to the input index in a
   // RexInput node
   std::vector<int> columnIdBySpi_;  // spi = 1,2,3,...
@@ -71,6 +72,7 @@ struct TableDescriptor {
       , shardedColumnId(0)
       , persistenceLevel(Data_Namespace::MemoryLevel::DISK_LEVEL)
       , hasDeletedCol(true)
+      , mmapChunks(false)
       , mutex_(std::make_shared<std::mutex>()) {}
 };
 
@@ -42,8 +42,9 @@
     }                                                                             \
   }
 
-DEFINE_ENUM_WITH_STRING_CONVERSIONS(MgrType,
-                                    (FILE_MGR)(CPU_MGR)(GPU_MGR)(GLOBAL_FILE_MGR))
+DEFINE_ENUM_WITH_STRING_CONVERSIONS(
+    MgrType,
+    (FILE_MGR)(CPU_MGR)(GPU_MGR)(GLOBAL_FILE_MGR)(DISK_CACHE_MGR))
 
 namespace Data_Namespace {
 
@@ -43,7 +43,8 @@ Buffer::Buffer(BufferMgr* bm,
     , segIt_(segIt)
     , pageSize_(pageSize)
     , numPages_(0)
-    , pinCount_(0) {
+    , pinCount_(0)
+    , accessCount_(0) {
   pin();
   // so that the pointer value of this Buffer is stored
   segIt_->buffer = this;
@@ -25,6 +25,7 @@
 #include "../AbstractBuffer.h"
 #include "BufferSeg.h"
 
+#include <atomic>
 #include <iostream>
 #include <mutex>
 //#include <boost/thread/locks.hpp>
@@ -173,6 +174,8 @@ class Buffer : public AbstractBuffer {
   std::vector<bool> pageDirtyFlags_;
   int pinCount_;
   std::mutex pinMutex_;
+  /// Number of times the chunk was asked for while in this buffer
+  std::atomic<size_t> accessCount_;
 };
 
 }  // namespace Buffer_Namespace
@@ -50,6 +50,29 @@ void oom_trace_pop() {
 
 namespace Buffer_Namespace {
 
+namespace {
+
+static thread_local bool scan_hint_active{false};
+
+std::tuple<bool, unsigned int, const BufferSeg*> eviction_key(const BufferSeg& seg) {
+  // segments loaded by large scans sort first, so they're evicted before the others
+  return std::make_tuple(!seg.isScanned, seg.lastTouched, &seg);
+}
+
+}  // namespace
+
+ScanHint::ScanHint(const bool enable) : previous_(scan_hint_active) {
+  scan_hint_active = previous_ || enable;
+}
+
+ScanHint::~ScanHint() {
+  scan_hint_active = previous_;
+}
+
+bool ScanHint::isActive() {
+  return scan_hint_active;
+}
+
 std::string BufferMgr::keyToString(const ChunkKey& key) {
   std::ostringstream oss;
 
@@ -74,7 +97,8 @@ BufferMgr::BufferMgr(const int deviceId,
     , allocationsCapped_(false)
     , parentMgr_(parentMgr)
     , maxBufferId_(0)
-    , bufferEpoch_(0) {
+    , bufferEpoch_(0)
+    , numProtectedPages_(0) {
   CHECK(maxBufferSize_ > 0 && maxSlabSize_ > 0 && pageSize_ > 0 &&
         maxSlabSize_ % pageSize_ == 0);
   maxNumPages_ = maxBufferSize_ / pageSize_;
@@ -102,12 +126,19 @@ void BufferMgr::clear() {
   std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
   std::lock_guard<std::mutex> unsizedSegsLock(unsizedSegsMutex_);
   for (auto bufferIt = chunkIndex_.begin(); bufferIt != chunkIndex_.end(); ++bufferIt) {
+    retireAccessCount(bufferIt->first, bufferIt->second->buffer);
     delete bufferIt->second->buffer;
   }
   chunkIndex_.clear();
   slabs_.clear();
   slabSegments_.clear();
   unsizedSegs_.clear();
+  freeSegs_.clear();
+  probationSegs_.clear();
+  protectedSegs_.clear();
+  numProtectedPages_ = 0;
+  evictedKeys_.clear();
+  evictedKeyIndex_.clear();
   bufferEpoch_ = 0;
 }
 
@@ -166,6 +197,13 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evictStart,
   while (numPages < numPagesRequested) {
     if (evictIt->memStatus == USED) {
       CHECK(evictIt->buffer->getPinCount() < 1);
+      retireAccessCount(evictIt->chunkKey, evictIt->buffer);
+      untrackSegment(evictIt);
+      if (!evictIt->isScanned) {
+        rememberEvictedKey(evictIt->chunkKey);
+      }
+    } else {
+      unindexFreeSegment(evictIt);
     }
     numPages += evictIt->numPages;
     if (evictIt->memStatus == USED && evictIt->chunkKey.size() > 0) {
@@ -178,17 +216,22 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evictStart,
   BufferSeg dataSeg(startPage, numPagesRequested, USED, bufferEpoch_++);  // until we can
   // dataSeg.pinCount++;
   dataSeg.slabNum = slabNum;
+  dataSeg.isScanned = ScanHint::isActive();
   auto dataSegIt =
       slabSegments_[slabNum].insert(evictIt, dataSeg);  // Will insert before evictIt
+  trackSegment(dataSegIt);
   if (numPagesRequested < numPages) {
     size_t excessPages = numPages - numPagesRequested;
     if (evictIt != slabSegments_[slabNum].end() &&
         evictIt->memStatus == FREE) {  // need to merge with current page
+      unindexFreeSegment(evictIt);
       evictIt->startPage = startPage + numPagesRequested;
       evictIt->numPages += excessPages;
+      indexFreeSegment(evictIt);
     } else {  // need to insert a free seg before evictIt for excessPages
       BufferSeg freeSeg(startPage + numPagesRequested, excessPages, FREE);
-      slabSegments_[slabNum].insert(evictIt, freeSeg);
+      freeSeg.slabNum = slabNum;
+      indexFreeSegment(slabSegments_[slabNum].insert(evictIt, freeSeg));
     }
   }
   return dataSegIt;
@@ -213,9 +256,17 @@ BufferList::iterator BufferMgr::reserveBuffer(
         nextIt->numPages >= numPagesExtraNeeded) {  // Then we can just use the next
                                                     // BufferSeg which happens to be free
       size_t leftoverPages = nextIt->numPages - numPagesExtraNeeded;
+      unindexFreeSegment(nextIt);
+      untrackSegment(segIt);
       segIt->numPages = numPagesRequested;
-      nextIt->numPages = leftoverPages;
-      nextIt->startPage = segIt->startPage + segIt->numPages;
+      trackSegment(segIt);
+      if (leftoverPages > 0) {
+        nextIt->numPages = leftoverPages;
+        nextIt->startPage = segIt->startPage + segIt->numPages;
+        indexFreeSegment(nextIt);
+      } else {
+        slabSegments_[slabNum].erase(nextIt);
+      }
       return segIt;
     }
   }
@@ -231,6 +282,16 @@ BufferList::iterator BufferMgr::reserveBuffer(
   newSegIt->buffer = segIt->buffer;
   // newSegIt->buffer->segIt_ = newSegIt;
   newSegIt->chunkKey = segIt->chunkKey;
+  if (segIt->slabNum < 0) {  // first allocation of the chunk
+    auto evictedKeyIt = evictedKeyIndex_.find(newSegIt->chunkKey);
+    if (evictedKeyIt != evictedKeyIndex_.end()) {
+      evictedKeys_.erase(evictedKeyIt->second);
+      evictedKeyIndex_.erase(evictedKeyIt);
+      if (!ScanHint::isActive()) {
+        protectSegment(newSegIt);
+      }
+    }
+  }
   int8_t* oldMem = newSegIt->buffer->mem_;
   newSegIt->buffer->mem_ = slabs_[newSegIt->slabNum] + newSegIt->startPage * pageSize_;
 
@@ -241,8 +302,20 @@ BufferList::iterator BufferMgr::reserveBuffer(
     newSegIt->buffer->writeData(
         oldMem, newSegIt->buffer->size(), 0, newSegIt->buffer->getType(), deviceId_);
   }
+  // the chunk keeps its place in the eviction order
+  const bool wasSized = segIt->slabNum >= 0;
+  const auto lastTouched = segIt->lastTouched;
+  const bool isProtected = segIt->isProtected;
+  const bool isScanned = segIt->isScanned;
   // Deincrement pin count to reverse effect above
   removeSegment(segIt);
+  if (wasSized) {
+    untrackSegment(newSegIt);
+    newSegIt->lastTouched = lastTouched;
+    newSegIt->isProtected = isProtected;
+    newSegIt->isScanned = isScanned;
+    trackSegment(newSegIt);
+  }
   {
     std::lock_guard<std::mutex> lock(chunkIndexMutex_);
     chunkIndex_[newSegIt->chunkKey] = newSegIt;
@@ -251,32 +324,129 @@ BufferList::iterator BufferMgr::reserveBuffer(
   return newSegIt;
 }
 
-BufferList::iterator BufferMgr::findFreeBufferInSlab(const size_t slabNum,
-                                                     const size_t numPagesRequested) {
-  for (auto bufferIt = slabSegments_[slabNum].begin();
-       bufferIt != slabSegments_[slabNum].end();
-       ++bufferIt) {
-    if (bufferIt->memStatus == FREE && bufferIt->numPages >= numPagesRequested) {
-      // startPage doesn't change
-      size_t excessPages = bufferIt->numPages - numPagesRequested;
-      bufferIt->numPages = numPagesRequested;
-      bufferIt->memStatus = USED;
-      bufferIt->lastTouched = bufferEpoch_++;
-      bufferIt->slabNum = slabNum;
-      if (excessPages > 0) {
-        BufferSeg freeSeg(bufferIt->startPage + numPagesRequested, excessPages, FREE);
-        auto tempIt = bufferIt;  // this should make a copy and not be a reference
-        // - as we do not want to increment bufferIt
-        tempIt++;
-        slabSegments_[slabNum].insert(tempIt, freeSeg);
-      }
-      return bufferIt;
-    }
+BufferList::iterator BufferMgr::reserveFreeSegment(BufferList::iterator segIt,
+                                                   const size_t numPagesRequested) {
+  CHECK(segIt->memStatus == FREE && segIt->numPages >= numPagesRequested);
+  unindexFreeSegment(segIt);
+  // startPage doesn't change
+  size_t excessPages = segIt->numPages - numPagesRequested;
+  segIt->numPages = numPagesRequested;
+  segIt->memStatus = USED;
+  segIt->lastTouched = bufferEpoch_++;
+  segIt->isProtected = false;
+  segIt->isScanned = ScanHint::isActive();
+  if (excessPages > 0) {
+    BufferSeg freeSeg(segIt->startPage + numPagesRequested, excessPages, FREE);
+    freeSeg.slabNum = segIt->slabNum;
+    indexFreeSegment(slabSegments_[segIt->slabNum].insert(std::next(segIt), freeSeg));
   }
-  // If here then we did not find a free buffer of
-  // sufficient size in
-  // this slab, return the end iterator
-  return slabSegments_[slabNum].end();
+  trackSegment(segIt);
+  return segIt;
+}
+
+void BufferMgr::indexFreeSegment(BufferList::iterator segIt) {
+  CHECK(segIt->memStatus == FREE && segIt->slabNum >= 0);
+  freeSegs_.emplace(FreeSegKey(segIt->numPages, segIt->slabNum, segIt->startPage),
+                    segIt);
+}
+
+void BufferMgr::unindexFreeSegment(BufferList::iterator segIt) {
+  CHECK_EQ(freeSegs_.erase(FreeSegKey(segIt->numPages, segIt->slabNum, segIt->startPage)),
+           size_t(1));
+}
+
+void BufferMgr::trackSegment(BufferList::iterator segIt) {
+  if (segIt->isProtected) {
+    protectedSegs_.emplace(eviction_key(*segIt), segIt);
+    numProtectedPages_ += segIt->numPages;
+  } else {
+    probationSegs_.emplace(eviction_key(*segIt), segIt);
+  }
+}
+
+void BufferMgr::untrackSegment(BufferList::iterator segIt) {
+  if (segIt->isProtected) {
+    CHECK_EQ(protectedSegs_.erase(eviction_key(*segIt)), size_t(1));
+    numProtectedPages_ -= segIt->numPages;
+  } else {
+    CHECK_EQ(probationSegs_.erase(eviction_key(*segIt)), size_t(1));
+  }
+}
+
+void BufferMgr::touchSegment(BufferList::iterator segIt) {
+  if (segIt->slabNum < 0) {  // no memory reserved yet
+    segIt->lastTouched = bufferEpoch_++;
+    return;
+  }
+  untrackSegment(segIt);
+  segIt->lastTouched = bufferEpoch_++;
+  trackSegment(segIt);
+  if (!ScanHint::isActive()) {
+    protectSegment(segIt);
+  }
+}
+
+void BufferMgr::protectSegment(BufferList::iterator segIt) {
+  untrackSegment(segIt);
+  segIt->isProtected = true;
+  segIt->isScanned = false;
+  trackSegment(segIt);
+  // leave a quarter of the pool to the chunks on probation, so that chunks which are no
+  // longer used age out of the protected ones
+  const size_t poolPages = allocationsCapped_ ? numPagesAllocated_ : maxNumPages_;
+  while (numProtectedPages_ > poolPages - poolPages / 4) {
+    auto lruSegIt = protectedSegs_.begin()->second;
+    untrackSegment(lruSegIt);
+    lruSegIt->isProtected = false;
+    trackSegment(lruSegIt);
+  }
+}
+
+void BufferMgr::rememberEvictedKey(const ChunkKey& key) {
+  if (key.empty() || key[0] == -1) {  // temporary buffer
+    return;
+  }
+  auto evictedKeyIt = evictedKeyIndex_.find(key);
+  if (evictedKeyIt != evictedKeyIndex_.end()) {
+    evictedKeys_.erase(evictedKeyIt->second);
+  }
+  evictedKeyIndex_[key] = evictedKeys_.insert(evictedKeys_.end(), key);
+  while (evictedKeys_.size() > probationSegs_.size() + protectedSegs_.size()) {
+    evictedKeyIndex_.erase(evictedKeys_.front());
+    evictedKeys_.pop_front();
+  }
+}
+
+BufferList::iterator BufferMgr::findEvictionStart(BufferList::iterator segIt,
+                                                  const size_t numPagesRequested,
+                                                  const bool evictProtected) {
+  // pinCount should never go up - only down because we have
+  // global lock on buffer pool and pin count only increments
+  // on getChunk
+  auto& slab = slabSegments_[segIt->slabNum];
+  const auto evictable = [evictProtected](const BufferList::iterator it) {
+    return it->memStatus == FREE ||
+           (it->buffer && it->buffer->getPinCount() < 1 &&
+            (evictProtected || !it->isProtected));
+  };
+  if (!evictable(segIt)) {
+    return slab.end();
+  }
+  // the run of evictable segments starting at segIt, extended backwards if it's not
+  // big enough
+  size_t numPages = 0;
+  for (auto evictIt = segIt;
+       evictIt != slab.end() && numPages < numPagesRequested && evictable(evictIt);
+       ++evictIt) {
+    numPages += evictIt->numPages;
+  }
+  auto startIt = segIt;
+  while (numPages < numPagesRequested && startIt != slab.begin() &&
+         evictable(std::prev(startIt))) {
+    --startIt;
+    numPages += startIt->numPages;
+  }
+  return numPages >= numPagesRequested ? startIt : slab.end();
 }
 
 BufferList::iterator BufferMgr::findFreeBuffer(size_t numBytes) {
@@ -287,11 +457,10 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t numBytes) {
 
   size_t numSlabs = slabSegments_.size();
 
-  for (size_t slabNum = 0; slabNum != numSlabs; ++slabNum) {
-    auto segIt = findFreeBufferInSlab(slabNum, numPagesRequested);
-    if (segIt != slabSegments_[slabNum].end()) {
-      return segIt;
-    }
+  // best fit among the free segments of all slabs
+  auto freeSegIt = freeSegs_.lower_bound(FreeSegKey(numPagesRequested, -1, -1));
+  if (freeSegIt != freeSegs_.end()) {
+    return reserveFreeSegment(freeSegIt->second, numPagesRequested);
   }
 
   // If we're here then we didn't find a free segment of sufficient size
@@ -314,8 +483,11 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t numBytes) {
       }
       // if here then addSlab succeeded
       numPagesAllocated_ += currentMaxSlabPageSize_;
-      return findFreeBufferInSlab(
-          numSlabs,
+      auto newSegIt = slabSegments_[numSlabs].begin();
+      newSegIt->slabNum = numSlabs;
+      indexFreeSegment(newSegIt);
+      return reserveFreeSegment(
+          newSegIt,
           numPagesRequested);  // has to succeed since we made sure to request a slab big
                                // enough to accomodate request
     } catch (std::runtime_error& error) {  // failed to allocate slab
@@ -350,85 +522,34 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t numBytes) {
 
   // If here then we can't add a slab - so we need to evict
 
-  size_t minScore = std::numeric_limits<size_t>::max();
-  // We're going for lowest score here, like golf
-  // This is because score is the sum of the lastTouched score for all
-  // pages evicted. Evicting less pages and older pages will lower the
-  // score
-  BufferList::iterator bestEvictionStart = slabSegments_[0].end();
-  int bestEvictionStartSlab = -1;
-  int slabNum = 0;
-
-  for (auto slabIt = slabSegments_.begin(); slabIt != slabSegments_.end();
-       ++slabIt, ++slabNum) {
-    for (auto bufferIt = slabIt->begin(); bufferIt != slabIt->end(); ++bufferIt) {
-      /* Note there are some shortcuts we could take here - like we
-       * should never consider a USED buffer coming after a free buffer
-       * as we would have used the FREE buffer, but we won't worry about
-       * this for now
-       */
-
-      // We can't evict pinned  buffers - only normal used
-      // buffers
-
-      // if (bufferIt->memStatus == FREE || bufferIt->buffer->getPinCount() == 0) {
-      size_t pageCount = 0;
-      size_t score = 0;
-      bool solutionFound = false;
-      auto evictIt = bufferIt;
-      for (; evictIt != slabSegments_[slabNum].end(); ++evictIt) {
-        // pinCount should never go up - only down because we have
-        // global lock on buffer pool and pin count only increments
-        // on getChunk
-        if (evictIt->memStatus == USED && evictIt->buffer->getPinCount() > 0) {
-          break;
-        }
-        pageCount += evictIt->numPages;
-        if (evictIt->memStatus == USED) {
-          // MAT changed from
-          // score += evictIt->lastTouched;
-          // Issue was thrashing when going from 8M fragment size chunks back to 64M
-          // basically the large chunks were being evicted prior to small as many small
-          // chunk score was larger than one large chunk so it always would evict a large
-          // chunk so under memory pressure a query would evict its own current chunks and
-          // cause reloads rather than evict several smaller unused older chunks.
-          score = std::max(score, static_cast<size_t>(evictIt->lastTouched));
-        }
-        if (pageCount >= numPagesRequested) {
-          solutionFound = true;
-          break;
-        }
+  // Try the least recently used chunks on probation first, without touching protected
+  // ones, and only then all chunks. Each candidate is evicted together with the
+  // neighbouring segments needed to make room for the request.
+  for (const bool evictProtected : {false, true}) {
+    for (const auto segs : {&probationSegs_, &protectedSegs_}) {
+      if (!evictProtected && segs == &protectedSegs_) {
+        continue;
       }
-      if (solutionFound && score < minScore) {
-        minScore = score;
-        bestEvictionStart = bufferIt;
-        bestEvictionStartSlab = slabNum;
-      } else if (evictIt == slabSegments_[slabNum].end()) {
-        // this means that every segment after this will fail as
-        // well, so our search has proven futile
-        // throw std::runtime_error ("Couldn't evict chunks to get free space");
-        break;
-        // in reality we should try to rearrange the buffer to get
-        // more contiguous free space
+      for (const auto& seg : *segs) {
+        const int slabNum = seg.second->slabNum;
+        auto evictionStart =
+            findEvictionStart(seg.second, numPagesRequested, evictProtected);
+        if (evictionStart == slabSegments_[slabNum].end()) {
+          continue;
+        }
+        LOG(INFO) << "ALLOCATION failed to find " << numBytes << "B free. Forcing Eviction."
+                  << " Eviction start " << evictionStart->startPage
+                  << " Number pages requested " << numPagesRequested
+                  << " Best Eviction Start Slab " << slabNum << " " << getStringMgrType()
+                  << ":" << deviceId_;
+        return evict(evictionStart, numPagesRequested, slabNum);
       }
-      // other possibility is ending at PINNED - do nothing in this
-      // case
-      //}
     }
   }
-  if (bestEvictionStart == slabSegments_[0].end()) {
-    LOG(ERROR) << "ALLOCATION failed to find " << numBytes << "B throwing out of memory "
-               << getStringMgrType() << ":" << deviceId_;
-    printSlabs();
-    throw OutOfMemory();
-  }
-  LOG(INFO) << "ALLOCATION failed to find " << numBytes << "B free. Forcing Eviction."
-            << " Eviction start " << bestEvictionStart->startPage
-            << " Number pages requested " << numPagesRequested
-            << " Best Eviction Start Slab " << bestEvictionStartSlab << " "
-            << getStringMgrType() << ":" << deviceId_;
-  bestEvictionStart = evict(bestEvictionStart, numPagesRequested, bestEvictionStartSlab);
-  return bestEvictionStart;
+  LOG(ERROR) << "ALLOCATION failed to find " << numBytes << "B throwing out of memory "
+             << getStringMgrType() << ":" << deviceId_;
+  printSlabs();
+  throw OutOfMemory();
 }
 
 std::string BufferMgr::printSlab(size_t slabNum) {
@@ -601,6 +722,10 @@ bool BufferMgr::isBufferOnDevice(const ChunkKey& key) {
 
 /// This method throws a runtime_error when deleting a Chunk that does not exist.
 void BufferMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
+  {
+    std::lock_guard<std::mutex> accessCountsLock(accessCountsMutex_);
+    accessCounts_.erase(key);
+  }
   std::unique_lock<std::mutex> chunkIndexLock(chunkIndexMutex_);
   // Note: purge is currently unused
 
@@ -620,6 +745,15 @@ void BufferMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
 }
 
 void BufferMgr::deleteBuffersWithPrefix(const ChunkKey& keyPrefix, const bool purge) {
+  {
+    std::lock_guard<std::mutex> accessCountsLock(accessCountsMutex_);
+    auto countIt = accessCounts_.lower_bound(keyPrefix);
+    while (countIt != accessCounts_.end() &&
+           countIt->first.size() >= keyPrefix.size() &&
+           std::equal(keyPrefix.begin(), keyPrefix.end(), countIt->first.begin())) {
+      accessCounts_.erase(countIt++);
+    }
+  }
   // Note: purge is unused
   // lookup the buffer for the Chunk in chunkIndex_
   std::lock_guard<std::mutex> sizedSegsLock(
@@ -656,11 +790,15 @@ void BufferMgr::removeSegment(BufferList::iterator& segIt) {
     std::lock_guard<std::mutex> unsizedSegsLock(unsizedSegsMutex_);
     unsizedSegs_.erase(segIt);
   } else {
+    if (segIt->memStatus == USED) {
+      untrackSegment(segIt);
+    }
     if (segIt != slabSegments_[slabNum].begin()) {
       auto prevIt = std::prev(segIt);
       // LOG(INFO) << "PrevIt: " << " " << getStringMgrType() << ":" << deviceId_;
       // printSeg(prevIt);
       if (prevIt->memStatus == FREE) {
+        unindexFreeSegment(prevIt);
         segIt->startPage = prevIt->startPage;
         segIt->numPages += prevIt->numPages;
         slabSegments_[slabNum].erase(prevIt);
@@ -669,6 +807,7 @@ void BufferMgr::removeSegment(BufferList::iterator& segIt) {
     auto nextIt = std::next(segIt);
     if (nextIt != slabSegments_[slabNum].end()) {
       if (nextIt->memStatus == FREE) {
+        unindexFreeSegment(nextIt);
         segIt->numPages += nextIt->numPages;
         slabSegments_[slabNum].erase(nextIt);
       }
@@ -676,6 +815,9 @@ void BufferMgr::removeSegment(BufferList::iterator& segIt) {
     segIt->memStatus = FREE;
     // segIt->pinCount = 0;
     segIt->buffer = 0;
+    segIt->isProtected = false;
+    segIt->isScanned = false;
+    indexFreeSegment(segIt);
   }
 }
 
@@ -726,6 +868,78 @@ void BufferMgr::checkpoint(const int db_id, const int tb_id) {
 /// Returns a pointer to the Buffer holding the chunk, if it exists; otherwise,
 /// throws a runtime_error.
 AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t numBytes) {
+  auto buffer = static_cast<Buffer*>(fetchChunk(key, numBytes));
+  // the buffer is pinned, so it stays in the pool until the count is in
+  buffer->accessCount_.fetch_add(1, std::memory_order_relaxed);
+  return buffer;
+}
+
+bool BufferMgr::prewarmBuffer(const ChunkKey& key,
+                              const size_t numBytes,
+                              const bool evict) {
+  {
+    std::lock_guard<std::mutex> sizedSegsLock(sizedSegsMutex_);
+    std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
+    if (chunkIndex_.find(key) != chunkIndex_.end()) {
+      return false;
+    }
+    const size_t numPages = (numBytes + pageSize_ - 1) / pageSize_;
+    // a free segment big enough, or room for a new slab
+    if (!evict &&
+        (freeSegs_.empty() || std::get<0>(freeSegs_.rbegin()->first) < numPages) &&
+        (allocationsCapped_ || numPagesAllocated_ + numPages > maxNumPages_)) {
+      return false;
+    }
+  }
+  fetchChunk(key, numBytes)->unPin();
+  return true;
+}
+
+std::vector<std::pair<ChunkKey, size_t>> BufferMgr::getChunkAccessCounts() {
+  std::vector<std::pair<ChunkKey, size_t>> chunkAccessCounts;
+  {
+    std::lock_guard<std::mutex> sizedSegsLock(sizedSegsMutex_);
+    std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
+    std::lock_guard<std::mutex> accessCountsLock(accessCountsMutex_);
+    auto liveAccessCounts = accessCounts_;
+    for (const auto& chunk : chunkIndex_) {
+      const auto buffer = chunk.second->buffer;
+      const size_t accessCount =
+          buffer ? buffer->accessCount_.load(std::memory_order_relaxed) : 0;
+      if (accessCount > 0) {
+        liveAccessCounts[chunk.first] += accessCount;
+      }
+    }
+    chunkAccessCounts.assign(liveAccessCounts.begin(), liveAccessCounts.end());
+  }
+  std::stable_sort(chunkAccessCounts.begin(),
+                   chunkAccessCounts.end(),
+                   [](const std::pair<ChunkKey, size_t>& lhs,
+                      const std::pair<ChunkKey, size_t>& rhs) {
+                     return lhs.second > rhs.second;
+                   });
+  return chunkAccessCounts;
+}
+
+void BufferMgr::addChunkAccessCounts(
+    const std::vector<std::pair<ChunkKey, size_t>>& chunkAccessCounts) {
+  std::lock_guard<std::mutex> accessCountsLock(accessCountsMutex_);
+  for (const auto& chunkAccessCount : chunkAccessCounts) {
+    accessCounts_[chunkAccessCount.first] += chunkAccessCount.second;
+  }
+}
+
+/// Called with sizedSegsMutex_ held, before the buffer goes away.
+void BufferMgr::retireAccessCount(const ChunkKey& key, const Buffer* buffer) {
+  const size_t accessCount =
+      buffer ? buffer->accessCount_.load(std::memory_order_relaxed) : 0;
+  if (accessCount > 0) {
+    std::lock_guard<std::mutex> accessCountsLock(accessCountsMutex_);
+    accessCounts_[key] += accessCount;
+  }
+}
+
+AbstractBuffer* BufferMgr::fetchChunk(const ChunkKey& key, const size_t numBytes) {
   std::lock_guard<std::mutex> lock(globalMutex_);  // granular lock
 
   std::unique_lock<std::mutex> sizedSegsLock(sizedSegsMutex_);
@@ -736,8 +950,8 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t numBytes)
   if (foundBuffer) {
     CHECK(bufferIt->second->buffer);
     bufferIt->second->buffer->pin();
+    touchSegment(bufferIt->second);
     sizedSegsLock.unlock();
-    bufferIt->second->lastTouched = bufferEpoch_++;  // race
     if (bufferIt->second->buffer->size() <
         numBytes) {  // need to fetch part of buffer we don't have - up to numBytes
       parentMgr_->fetchBuffer(key, bufferIt->second->buffer, numBytes);
@@ -900,4 +1114,61 @@ void BufferMgr::getChunkMetadataVecForKeyPrefix(
 const std::vector<BufferList>& BufferMgr::getSlabSegments() {
   return slabSegments_;
 }
+
+std::vector<AbstractBuffer*> BufferMgr::adoptSlab(int8_t* slab,
+                                                  const size_t slabSize,
+                                                  const std::vector<SlabChunk>& chunks) {
+  std::lock_guard<std::mutex> sizedSegsLock(sizedSegsMutex_);
+  std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
+  const size_t slabPages = slabSize / pageSize_;
+  CHECK_LE(numPagesAllocated_ + slabPages, maxNumPages_);
+  const int slabNum = slabs_.size();
+  slabs_.push_back(slab);
+  slabSegments_.resize(slabSegments_.size() + 1);
+  numPagesAllocated_ += slabPages;
+  auto& slabSegs = slabSegments_.back();
+
+  std::vector<size_t> byStartPage(chunks.size());
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    byStartPage[i] = i;
+  }
+  std::sort(byStartPage.begin(), byStartPage.end(), [&chunks](size_t lhs, size_t rhs) {
+    return chunks[lhs].startPage < chunks[rhs].startPage;
+  });
+  size_t freeStartPage = 0;
+  const auto addFreeSegment = [&](const size_t endPage) {
+    if (endPage > freeStartPage) {
+      BufferSeg freeSeg(freeStartPage, endPage - freeStartPage, FREE);
+      freeSeg.slabNum = slabNum;
+      indexFreeSegment(slabSegs.insert(slabSegs.end(), freeSeg));
+    }
+  };
+  std::vector<AbstractBuffer*> buffers(chunks.size());
+  for (const auto i : byStartPage) {
+    const auto& chunk = chunks[i];
+    const size_t numPages = (chunk.numBytes + pageSize_ - 1) / pageSize_;
+    CHECK_GE(chunk.startPage, static_cast<int>(freeStartPage));
+    CHECK_LE(chunk.startPage + numPages, slabPages);
+    CHECK(chunkIndex_.find(chunk.key) == chunkIndex_.end());
+    addFreeSegment(chunk.startPage);
+    BufferSeg dataSeg(chunk.startPage, numPages, USED, bufferEpoch_ + i);
+    dataSeg.slabNum = slabNum;
+    dataSeg.chunkKey = chunk.key;
+    auto segIt = slabSegs.insert(slabSegs.end(), dataSeg);
+    allocateBuffer(segIt, pageSize_, 0);
+    auto buffer = segIt->buffer;
+    buffer->mem_ = slab + chunk.startPage * pageSize_;
+    buffer->numPages_ = numPages;
+    buffer->pageDirtyFlags_.resize(numPages);
+    buffer->setSize(chunk.numBytes);
+    buffer->unPin();
+    trackSegment(segIt);
+    chunkIndex_[chunk.key] = segIt;
+    buffers[i] = buffer;
+    freeStartPage = chunk.startPage + numPages;
+  }
+  addFreeSegment(slabPages);
+  bufferEpoch_ += chunks.size();
+  return buffers;
+}
 }  // namespace Buffer_Namespace
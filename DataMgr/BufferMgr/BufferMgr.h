@@ -29,6 +29,9 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
 #include "../AbstractBuffer.h"
 #include "../AbstractBufferMgr.h"
 #include "../Shared/types.h"
@@ -60,6 +63,25 @@ using namespace Data_Namespace;
 
 namespace Buffer_Namespace {
 
+/**
+ * @class   ScanHint
+ * @brief   Marks the chunks loaded by the current thread while alive as part of a large
+ * scan.
+ *
+ * Such chunks are the first to be evicted and aren't protected by being touched again,
+ * so a one-off scan doesn't push the working set of other queries out of the pool.
+ */
+class ScanHint {
+ public:
+  explicit ScanHint(const bool enable = true);
+  ~ScanHint();
+
+  static bool isActive();
+
+ private:
+  bool previous_;
+};
+
 /**
  * @class   BufferMgr
  * @brief
@@ -114,6 +136,21 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   /// Returns the a pointer to the chunk with the specified key.
   virtual AbstractBuffer* getBuffer(const ChunkKey& key, const size_t numBytes = 0);
 
+  /**
+   * @brief Loads the first numBytes of the chunk into the pool unless it is there
+   * already, without counting as an access to it.
+   *
+   * Without evict, the chunk is only loaded if it fits the free memory of the pool.
+   * Returns whether the chunk was loaded.
+   */
+  bool prewarmBuffer(const ChunkKey& key, const size_t numBytes, const bool evict);
+
+  /// Returns how often each chunk was asked for, most often first.
+  std::vector<std::pair<ChunkKey, size_t>> getChunkAccessCounts();
+  /// Adds to the access counts, e.g. the ones recorded by a previous run.
+  void addChunkAccessCounts(
+      const std::vector<std::pair<ChunkKey, size_t>>& chunkAccessCounts);
+
   /**
    * @brief Puts the contents of d into the Buffer with ChunkKey key.
    * @param key - Unique identifier for a Chunk.
@@ -152,23 +189,53 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   std::vector<BufferList> slabSegments_;
   size_t pageSize_;
 
+  /// A chunk held in a slab, by its first page and size in bytes
+  struct SlabChunk {
+    ChunkKey key;
+    int startPage;
+    size_t numBytes;
+  };
+
+  /**
+   * @brief Adds a slab whose memory already holds the given chunks, e.g. left there by
+   * a previous run of the server.
+   *
+   * The pages none of the chunks cover are free. Returns the unpinned buffers of the
+   * chunks, in the order given, which is also their eviction order.
+   */
+  std::vector<AbstractBuffer*> adoptSlab(int8_t* slab,
+                                         const size_t slabSize,
+                                         const std::vector<SlabChunk>& chunks);
+
+  /// taken in this order, as fetchBuffer() does
+  std::mutex globalMutex_;
+  std::mutex sizedSegsMutex_;
+  std::mutex chunkIndexMutex_;
+
  private:
   BufferMgr(const BufferMgr&);             // private copy constructor
   BufferMgr& operator=(const BufferMgr&);  // private assignment
   void removeSegment(BufferList::iterator& segIt);
-  BufferList::iterator findFreeBufferInSlab(const size_t slabNum,
-                                            const size_t numPagesRequested);
+  BufferList::iterator reserveFreeSegment(BufferList::iterator segIt,
+                                          const size_t numPagesRequested);
+  void indexFreeSegment(BufferList::iterator segIt);
+  void unindexFreeSegment(BufferList::iterator segIt);
+  void trackSegment(BufferList::iterator segIt);
+  void untrackSegment(BufferList::iterator segIt);
+  void touchSegment(BufferList::iterator segIt);
+  void protectSegment(BufferList::iterator segIt);
+  void rememberEvictedKey(const ChunkKey& key);
+  BufferList::iterator findEvictionStart(BufferList::iterator segIt,
+                                         const size_t numPagesRequested,
+                                         const bool evictProtected);
   int getBufferId();
   virtual void addSlab(const size_t slabSize) = 0;
   virtual void freeAllMem() = 0;
   virtual void allocateBuffer(BufferList::iterator segIt,
                               const size_t pageSize,
                               const size_t numBytes) = 0;
-  std::mutex chunkIndexMutex_;
-  std::mutex sizedSegsMutex_;
   std::mutex unsizedSegsMutex_;
   std::mutex bufferIdMutex_;
-  std::mutex globalMutex_;
 
   std::map<ChunkKey, BufferList::iterator> chunkIndex_;
   size_t maxBufferSize_;  /// max number of bytes allocated for the buffer pool
@@ -190,6 +257,35 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   BufferList unsizedSegs_;
   // std::map<size_t, int8_t *> freeMem_;
 
+  /// Free segments of all slabs ordered by (numPages, slabNum, startPage), so the best
+  /// fitting one is found with a single lookup
+  typedef std::tuple<size_t, int, int> FreeSegKey;
+  std::map<FreeSegKey, BufferList::iterator> freeSegs_;
+
+  /// Used segments in eviction order, as a segmented LRU. Chunks start out on
+  /// probation and are protected once touched again; the least recently used protected
+  /// chunks move back to probation when the protected ones take up more than three
+  /// quarters of the pool. Ordered by (!isScanned, lastTouched, segment address).
+  typedef std::tuple<bool, unsigned int, const BufferSeg*> EvictionKey;
+  std::map<EvictionKey, BufferList::iterator> probationSegs_;
+  std::map<EvictionKey, BufferList::iterator> protectedSegs_;
+  size_t numProtectedPages_;
+
+  /// Keys of recently evicted chunks, oldest first. A chunk loaded again while still
+  /// remembered here is protected right away, since it has been touched before. Holds
+  /// at most as many keys as there are chunks in the pool.
+  std::list<ChunkKey> evictedKeys_;
+  std::map<ChunkKey, std::list<ChunkKey>::iterator> evictedKeyIndex_;
+
+  /// Number of times each evicted chunk was asked for. Chunks in the pool count their
+  /// accesses in their buffer, and fold them in here when they are evicted.
+  std::map<ChunkKey, size_t> accessCounts_;
+  std::mutex accessCountsMutex_;
+
+  void retireAccessCount(const ChunkKey& key, const Buffer* buffer);
+
+  AbstractBuffer* fetchChunk(const ChunkKey& key, const size_t numBytes);
+
   BufferList::iterator evict(BufferList::iterator& evictStart,
                              const size_t numPagesRequested,
                              const int slabNum);
@@ -0,0 +1,235 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file        BufferPoolPrewarmer.cpp
+ * @brief       Loads chunks into a buffer pool ahead of the queries which need them.
+ */
+
+#include "BufferPoolPrewarmer.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace Buffer_Namespace {
+
+namespace {
+
+const char* history_header = "BUFFER_POOL_ACCESS_HISTORY";
+const int history_version = 1;
+const std::chrono::seconds history_interval(60);
+
+}  // namespace
+
+BufferPoolPrewarmer::BufferPoolPrewarmer(BufferMgr* bufferMgr,
+                                         AbstractBufferMgr* chunkStore,
+                                         const std::string& historyPath,
+                                         const size_t maxBytesPerSec)
+    : bufferMgr_(bufferMgr)
+    , chunkStore_(chunkStore)
+    , historyPath_(historyPath)
+    , maxBytesPerSec_(maxBytesPerSec)
+    , stopPrewarm_(false)
+    , stopHistory_(false)
+    , numSavedAccesses_(0)
+    , numPrewarmedChunks_(0) {
+  CHECK(bufferMgr_);
+  CHECK(chunkStore_);
+  if (!historyPath_.empty()) {
+    loadHistory();
+    historyThread_ = std::thread(&BufferPoolPrewarmer::recordHistory, this);
+  }
+}
+
+BufferPoolPrewarmer::~BufferPoolPrewarmer() {
+  stopPrewarm();
+  if (historyThread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> historyLock(historyMutex_);
+      stopHistory_ = true;
+    }
+    historyCondition_.notify_all();
+    historyThread_.join();
+  }
+}
+
+void BufferPoolPrewarmer::prewarmFromHistory() {
+  stopPrewarm();
+  std::vector<ChunkKey> keys;
+  for (const auto& chunkAccessCount : bufferMgr_->getChunkAccessCounts()) {
+    keys.push_back(chunkAccessCount.first);
+  }
+  if (keys.empty()) {
+    return;
+  }
+  stopPrewarm_ = false;
+  prewarmThread_ = std::thread([this, keys] { prewarm(keys); });
+}
+
+void BufferPoolPrewarmer::stopPrewarm() {
+  if (prewarmThread_.joinable()) {
+    stopPrewarm_ = true;
+    prewarmThread_.join();
+  }
+}
+
+void BufferPoolPrewarmer::waitForPrewarm() {
+  if (prewarmThread_.joinable()) {
+    prewarmThread_.join();
+  }
+}
+
+size_t BufferPoolPrewarmer::prewarmChunks(const std::vector<ChunkKey>& keys) {
+  size_t numLoaded = 0;
+  for (const auto& key : keys) {
+    numLoaded += prewarmChunk(key, true) > 0;
+  }
+  numPrewarmedChunks_ += numLoaded;
+  return numLoaded;
+}
+
+void BufferPoolPrewarmer::saveHistory() {
+  if (historyPath_.empty()) {
+    return;
+  }
+  const auto chunkAccessCounts = bufferMgr_->getChunkAccessCounts();
+  size_t numAccesses = 0;
+  for (const auto& chunkAccessCount : chunkAccessCounts) {
+    numAccesses += chunkAccessCount.second;
+  }
+  std::lock_guard<std::mutex> historyLock(historyMutex_);
+  if (numAccesses == numSavedAccesses_) {
+    return;
+  }
+  // replaced as a whole, so that a crash never leaves half of a history behind
+  const auto partialPath = historyPath_ + ".part";
+  {
+    std::ofstream history(partialPath, std::ios::trunc);
+    history << history_header << " " << history_version << "\n";
+    for (const auto& chunkAccessCount : chunkAccessCounts) {
+      history << chunkAccessCount.second << " " << chunkAccessCount.first.size();
+      for (const auto id : chunkAccessCount.first) {
+        history << " " << id;
+      }
+      history << "\n";
+    }
+    if (!history.good()) {
+      LOG(WARNING) << "Could not write the buffer pool access history " << partialPath;
+      return;
+    }
+  }
+  if (std::rename(partialPath.c_str(), historyPath_.c_str()) != 0) {
+    LOG(WARNING) << "Could not rename " << partialPath << " to " << historyPath_;
+    return;
+  }
+  numSavedAccesses_ = numAccesses;
+}
+
+void BufferPoolPrewarmer::loadHistory() {
+  std::ifstream history(historyPath_);
+  if (!history) {
+    return;
+  }
+  std::string header;
+  int version{0};
+  if (!(history >> header >> version) || header != history_header ||
+      version != history_version) {
+    LOG(WARNING) << "Ignoring " << historyPath_
+                 << ", which isn't a buffer pool access history of this version.";
+    return;
+  }
+  std::vector<std::pair<ChunkKey, size_t>> chunkAccessCounts;
+  size_t count{0};
+  size_t keySize{0};
+  while (history >> count >> keySize) {
+    ChunkKey key(keySize);
+    for (auto& id : key) {
+      history >> id;
+    }
+    if (!history) {
+      break;
+    }
+    chunkAccessCounts.emplace_back(key, count);
+  }
+  bufferMgr_->addChunkAccessCounts(chunkAccessCounts);
+  numSavedAccesses_ = 0;
+  for (const auto& chunkAccessCount : chunkAccessCounts) {
+    numSavedAccesses_ += chunkAccessCount.second;
+  }
+  LOG(INFO) << "Read the access counts of " << chunkAccessCounts.size()
+            << " chunks from " << historyPath_;
+}
+
+void BufferPoolPrewarmer::prewarm(const std::vector<ChunkKey>& keys) {
+  const auto start = std::chrono::steady_clock::now();
+  size_t numLoaded = 0;
+  size_t numBytesLoaded = 0;
+  for (const auto& key : keys) {
+    if (stopPrewarm_) {
+      break;
+    }
+    // only what fits the free memory, the pool is the queries' to evict from
+    const auto chunkSize = prewarmChunk(key, false);
+    if (!chunkSize) {
+      continue;
+    }
+    ++numLoaded;
+    ++numPrewarmedChunks_;
+    numBytesLoaded += chunkSize;
+    if (maxBytesPerSec_) {
+      const auto resume =
+          start + std::chrono::microseconds(
+                      static_cast<int64_t>(1e6 * numBytesLoaded / maxBytesPerSec_));
+      while (!stopPrewarm_ && std::chrono::steady_clock::now() < resume) {
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+            resume - std::chrono::steady_clock::now(), std::chrono::milliseconds(50)));
+      }
+    }
+  }
+  LOG(INFO) << "Prewarmed the buffer pool with " << numLoaded << " chunks ("
+            << numBytesLoaded << "B) in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now() - start)
+                   .count()
+            << " ms";
+}
+
+size_t BufferPoolPrewarmer::prewarmChunk(const ChunkKey& key, const bool evict) {
+  if (!chunkStore_->isBufferOnDevice(key)) {
+    return 0;
+  }
+  const auto chunkSize = chunkStore_->getBuffer(key)->size();
+  return chunkSize > 0 && bufferMgr_->prewarmBuffer(key, chunkSize, evict) ? chunkSize
+                                                                          : 0;
+}
+
+void BufferPoolPrewarmer::recordHistory() {
+  std::unique_lock<std::mutex> historyLock(historyMutex_);
+  while (!historyCondition_.wait_for(
+      historyLock, history_interval, [this] { return stopHistory_; })) {
+    historyLock.unlock();
+    saveHistory();
+    historyLock.lock();
+  }
+  historyLock.unlock();
+  saveHistory();
+}
+
+}  // namespace Buffer_Namespace
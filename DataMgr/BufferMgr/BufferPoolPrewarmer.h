@@ -0,0 +1,97 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file        BufferPoolPrewarmer.h
+ * @brief       Loads chunks into a buffer pool ahead of the queries which need them.
+ */
+
+#ifndef DATAMGR_MEMORY_BUFFER_BUFFERPOOLPREWARMER_H
+#define DATAMGR_MEMORY_BUFFER_BUFFERPOOLPREWARMER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BufferMgr.h"
+
+namespace Buffer_Namespace {
+
+/**
+ * @class   BufferPoolPrewarmer
+ * @brief   Fills a buffer pool with the chunks its queries use most.
+ *
+ * The pool counts how often each chunk is asked for. With a history path, the counts
+ * are written there every minute and on destruction, and read back on construction, so
+ * they cover the previous runs as well. prewarmFromHistory() then loads the most used
+ * chunks in the background, in the order of their counts, for as long as they fit the
+ * free memory of the pool. The loads are throttled to maxBytesPerSec, since they take
+ * turns with the queries for the pool and the disk.
+ *
+ * Chunks are checked against chunkStore, which holds every chunk there is, before they
+ * are loaded, so that chunks dropped in the meantime are skipped.
+ */
+class BufferPoolPrewarmer {
+ public:
+  BufferPoolPrewarmer(BufferMgr* bufferMgr,
+                      AbstractBufferMgr* chunkStore,
+                      const std::string& historyPath,
+                      const size_t maxBytesPerSec);
+  ~BufferPoolPrewarmer();
+
+  /// Starts loading the most used chunks in the background, in place of any such load
+  /// still in progress.
+  void prewarmFromHistory();
+
+  /// Stops the background load, e.g. before the pool is cleared.
+  void stopPrewarm();
+  /// Waits for the background load to finish.
+  void waitForPrewarm();
+
+  /// Loads the given chunks right away, unthrottled, evicting others if need be.
+  /// Returns the number of chunks loaded.
+  size_t prewarmChunks(const std::vector<ChunkKey>& keys);
+
+  void saveHistory();
+
+  size_t getNumPrewarmedChunks() const { return numPrewarmedChunks_; }
+
+ private:
+  void loadHistory();
+  void prewarm(const std::vector<ChunkKey>& keys);
+  size_t prewarmChunk(const ChunkKey& key, const bool evict);  // bytes loaded
+  void recordHistory();
+
+  BufferMgr* bufferMgr_;
+  AbstractBufferMgr* chunkStore_;
+  std::string historyPath_;
+  size_t maxBytesPerSec_;
+  std::thread prewarmThread_;
+  std::atomic<bool> stopPrewarm_;
+  std::thread historyThread_;
+  bool stopHistory_;
+  std::mutex historyMutex_;
+  std::condition_variable historyCondition_;
+  size_t numSavedAccesses_;  // total of the access counts last saved
+  std::atomic<size_t> numPrewarmedChunks_;
+};
+
+}  // namespace Buffer_Namespace
+
+#endif  // DATAMGR_MEMORY_BUFFER_BUFFERPOOLPREWARMER_H
@@ -35,6 +35,9 @@ struct BufferSeg {
   unsigned int pinCount;
   int slabNum;
   unsigned int lastTouched;
+  // eviction state of used segments, see BufferMgr::touchSegment
+  bool isProtected = false;  // touched again since it was loaded
+  bool isScanned = false;    // loaded by a large scan, evicted first
 
   BufferSeg() : memStatus(FREE), buffer(0), pinCount(0), slabNum(-1), lastTouched(0) {}
   BufferSeg(const int startPage, const size_t numPages)
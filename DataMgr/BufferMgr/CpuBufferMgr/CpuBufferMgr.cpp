@@ -17,39 +17,401 @@
 #include "CpuBufferMgr.h"
 #include <glog/logging.h>
 #include "../../../CudaMgr/CudaMgr.h"
+#include "../../FileMgr/FileBuffer.h"
+#include "../../FileMgr/GlobalFileMgr.h"
 #include "CpuBuffer.h"
+#include "MappedCpuBuffer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
 
 namespace Buffer_Namespace {
 
+namespace {
+
+const char* slab_file_prefix = "cpu_slab_";
+const char* slab_index_file = "cpu_slabs.index";
+const char* slab_index_header = "CPU_BUFFER_POOL";
+const int slab_index_version = 1;
+
+int latest_epoch(const AbstractBuffer* chunk) {
+  const auto file_buffer = dynamic_cast<const File_Namespace::FileBuffer*>(chunk);
+  return file_buffer ? file_buffer->latestEpoch() : -1;
+}
+
+}  // namespace
+
 CpuBufferMgr::CpuBufferMgr(const int deviceId,
                            const size_t maxBufferSize,
                            CudaMgr_Namespace::CudaMgr* cudaMgr,
                            const size_t bufferAllocIncrement,
                            const size_t pageSize,
-                           AbstractBufferMgr* parentMgr)
+                           AbstractBufferMgr* parentMgr,
+                           const std::string& slabPath)
     : BufferMgr(deviceId, maxBufferSize, bufferAllocIncrement, pageSize, parentMgr)
-    , cudaMgr_(cudaMgr) {}
+    , cudaMgr_(cudaMgr)
+    , slabPath_(slabPath)
+    , numSlabFiles_(0)
+    , numAdoptedChunks_(0)
+    , slabIndexSaved_(false)
+    , extentStore_(nullptr)
+    , mappedSize_(0) {
+  if (slabPath_.empty()) {
+    return;
+  }
+  boost::filesystem::path path(slabPath_);
+  if (boost::filesystem::exists(path)) {
+    if (!boost::filesystem::is_directory(path)) {
+      LOG(FATAL) << "CPU buffer pool path " << slabPath_ << " is not a directory.";
+    }
+  } else if (!boost::filesystem::create_directories(path)) {
+    LOG(FATAL) << "Could not create the CPU buffer pool directory " << slabPath_;
+  }
+}
 
 CpuBufferMgr::~CpuBufferMgr() {
   freeAllMem();
 }
 
+void CpuBufferMgr::adoptSlabs(AbstractBufferMgr* chunkStore) {
+  if (slabPath_.empty()) {
+    return;
+  }
+  CHECK(chunkStore);
+  CHECK(slabs_.empty());
+  std::set<std::string> adoptedFiles;
+  const auto indexPath = getSlabIndexPath();
+  std::ifstream index(indexPath);
+  std::string header;
+  int version{0};
+  size_t pageSize{0};
+  if (index >> header >> version >> pageSize && header == slab_index_header &&
+      version == slab_index_version && pageSize == pageSize_) {
+    std::string tag;
+    std::string name;
+    size_t slabSize{0};
+    size_t mapSize{0};
+    size_t numChunks{0};
+    while (index >> tag >> name >> slabSize >> mapSize >> numChunks && tag == "slab") {
+      std::vector<SlabChunk> chunks;
+      std::vector<const AbstractBuffer*> storedChunks;
+      for (size_t i = 0; i < numChunks; ++i) {
+        SlabChunk chunk;
+        size_t chunkSize{0};
+        int epoch{0};
+        size_t keySize{0};
+        if (!(index >> chunk.startPage >> chunk.numBytes >> chunkSize >> epoch >>
+              keySize)) {
+          break;
+        }
+        chunk.key.resize(keySize);
+        for (auto& subKey : chunk.key) {
+          index >> subKey;
+        }
+        if (!index || !chunkStore->isBufferOnDevice(chunk.key)) {
+          continue;
+        }
+        // the data files may have moved on since, e.g. rolled back to the last
+        // checkpoint
+        const auto storedChunk = chunkStore->getBuffer(chunk.key);
+        if (storedChunk->isDirty() || storedChunk->size() != chunkSize ||
+            latest_epoch(storedChunk) != epoch) {
+          continue;
+        }
+        chunks.push_back(chunk);
+        storedChunks.push_back(storedChunk);
+      }
+      if (!index) {
+        LOG(WARNING) << "CPU buffer pool index " << indexPath << " is truncated.";
+        break;
+      }
+      const auto path = slabPath_ + "/" + name;
+      if (slabSize % pageSize_ != 0 || getAllocated() + slabSize > getMaxSize() ||
+          !boost::filesystem::exists(path) ||
+          boost::filesystem::file_size(path) != mapSize) {
+        continue;
+      }
+      int8_t* slab{nullptr};
+      try {
+        slab = mapSlabFile(path, mapSize, false);
+      } catch (const FailedToCreateSlab&) {
+        continue;
+      }
+      const auto buffers = adoptSlab(slab, slabSize, chunks);
+      for (size_t i = 0; i < buffers.size(); ++i) {
+        buffers[i]->syncEncoder(storedChunks[i]);
+      }
+      slabFiles_.push_back(path);
+      slabMapSizes_.push_back(mapSize);
+      adoptedFiles.insert(path);
+      numAdoptedChunks_ += chunks.size();
+    }
+  }
+  index.close();
+  // only a clean shutdown leaves an index behind, it mustn't outlive the next crash
+  boost::filesystem::remove(indexPath);
+  for (boost::filesystem::directory_iterator fileIt(slabPath_), endIt; fileIt != endIt;
+       ++fileIt) {
+    const auto path = fileIt->path().string();
+    if (fileIt->path().filename().string().find(slab_file_prefix) == 0 &&
+        !adoptedFiles.count(path)) {
+      boost::filesystem::remove(path);
+    }
+  }
+  LOG(INFO) << "Adopted " << numAdoptedChunks_ << " chunks in " << slabs_.size()
+            << " slabs (" << getAllocated() << "B) from " << slabPath_;
+}
+
+void CpuBufferMgr::saveSlabIndex(AbstractBufferMgr* chunkStore) {
+  if (slabPath_.empty()) {
+    return;
+  }
+  CHECK(chunkStore);
+  // keeps any request still running from moving or evicting the chunks being recorded
+  std::lock_guard<std::mutex> lock(globalMutex_);
+  std::lock_guard<std::mutex> sizedSegsLock(sizedSegsMutex_);
+  std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
+  const auto indexPath = getSlabIndexPath();
+  // written under a name of its own first, so that the next start only ever sees a
+  // whole index
+  const auto partialPath = indexPath + ".part";
+  std::ofstream index(partialPath);
+  index << slab_index_header << " " << slab_index_version << " " << pageSize_ << "\n";
+  size_t numChunks = 0;
+  for (size_t slabNum = 0; slabNum < slabSegments_.size(); ++slabNum) {
+    size_t slabPages = 0;
+    std::vector<const BufferSeg*> chunkSegs;
+    for (const auto& seg : slabSegments_[slabNum]) {
+      slabPages += seg.numPages;
+      if (seg.memStatus == USED && seg.buffer && !seg.chunkKey.empty() &&
+          seg.chunkKey[0] != -1 && !seg.buffer->isDirty() && seg.buffer->size() > 0 &&
+          chunkStore->isBufferOnDevice(seg.chunkKey)) {
+        chunkSegs.push_back(&seg);
+      }
+    }
+    // least recently used first, which is the order they're adopted in
+    std::sort(chunkSegs.begin(),
+              chunkSegs.end(),
+              [](const BufferSeg* lhs, const BufferSeg* rhs) {
+                return lhs->lastTouched < rhs->lastTouched;
+              });
+    index << "slab " << boost::filesystem::path(slabFiles_[slabNum]).filename().string()
+          << " " << slabPages * pageSize_ << " " << slabMapSizes_[slabNum] << " "
+          << chunkSegs.size() << "\n";
+    for (const auto seg : chunkSegs) {
+      const auto storedChunk = chunkStore->getBuffer(seg->chunkKey);
+      index << seg->startPage << " " << seg->buffer->size() << " " << storedChunk->size()
+            << " " << latest_epoch(storedChunk) << " " << seg->chunkKey.size();
+      for (const auto subKey : seg->chunkKey) {
+        index << " " << subKey;
+      }
+      index << "\n";
+    }
+    numChunks += chunkSegs.size();
+  }
+  index.close();
+  if (!index || std::rename(partialPath.c_str(), indexPath.c_str()) != 0) {
+    LOG(WARNING) << "Could not write the CPU buffer pool index " << indexPath
+                 << ", the error was: " << std::strerror(errno);
+    std::remove(partialPath.c_str());
+    return;
+  }
+  slabIndexSaved_ = true;
+  LOG(INFO) << "Saved " << numChunks << " chunks of the CPU buffer pool in " << slabPath_;
+}
+
+AbstractBuffer* CpuBufferMgr::getBuffer(const ChunkKey& key, const size_t numBytes) {
+  if (auto buffer = getMappedBuffer(key, numBytes)) {
+    return buffer;
+  }
+  return BufferMgr::getBuffer(key, numBytes);
+}
+
+void CpuBufferMgr::fetchBuffer(const ChunkKey& key,
+                               AbstractBuffer* destBuffer,
+                               const size_t numBytes) {
+  auto buffer = getMappedBuffer(key, numBytes);
+  if (!buffer) {
+    BufferMgr::fetchBuffer(key, destBuffer, numBytes);
+    return;
+  }
+  const size_t chunkSize = numBytes == 0 ? buffer->size() : numBytes;
+  destBuffer->reserve(chunkSize);
+  buffer->read(destBuffer->getMemoryPtr() + destBuffer->size(),
+               chunkSize - destBuffer->size(),
+               destBuffer->size(),
+               destBuffer->getType(),
+               destBuffer->getDeviceId());
+  destBuffer->setSize(chunkSize);
+  destBuffer->syncEncoder(buffer);
+  buffer->unPin();
+}
+
+bool CpuBufferMgr::isBufferOnDevice(const ChunkKey& key) {
+  {
+    std::lock_guard<std::mutex> mappedChunksLock(mappedChunksMutex_);
+    if (mappedChunks_.count(key)) {
+      return true;
+    }
+  }
+  return BufferMgr::isBufferOnDevice(key);
+}
+
+void CpuBufferMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
+  {
+    std::lock_guard<std::mutex> mappedChunksLock(mappedChunksMutex_);
+    auto chunkIt = mappedChunks_.find(key);
+    if (chunkIt != mappedChunks_.end()) {
+      dropMappedChunk(chunkIt);
+      if (!BufferMgr::isBufferOnDevice(key)) {
+        return;
+      }
+    }
+  }
+  BufferMgr::deleteBuffer(key, purge);
+}
+
+void CpuBufferMgr::deleteBuffersWithPrefix(const ChunkKey& keyPrefix, const bool purge) {
+  {
+    std::lock_guard<std::mutex> mappedChunksLock(mappedChunksMutex_);
+    auto chunkIt = mappedChunks_.lower_bound(keyPrefix);
+    while (chunkIt != mappedChunks_.end() && chunkIt->first.size() >= keyPrefix.size() &&
+           std::equal(keyPrefix.begin(), keyPrefix.end(), chunkIt->first.begin())) {
+      dropMappedChunk(chunkIt++);
+    }
+  }
+  BufferMgr::deleteBuffersWithPrefix(keyPrefix, purge);
+}
+
+std::string CpuBufferMgr::printSlabs() {
+  std::ostringstream tss;
+  tss << BufferMgr::printSlabs() << "Mapped chunks: " << getNumMappedChunks() << " ("
+      << getMappedSize() << "B)" << std::endl;
+  return tss.str();
+}
+
+void CpuBufferMgr::clearSlabs() {
+  {
+    // the page cache keeps what the OS sees fit, only the mappings in use are kept
+    std::lock_guard<std::mutex> mappedChunksLock(mappedChunksMutex_);
+    for (auto chunkIt = mappedChunks_.begin(); chunkIt != mappedChunks_.end();) {
+      if (chunkIt->second->getPinCount() < 1) {
+        dropMappedChunk(chunkIt++);
+      } else {
+        ++chunkIt;
+      }
+    }
+  }
+  BufferMgr::clearSlabs();
+}
+
+size_t CpuBufferMgr::getNumMappedChunks() {
+  std::lock_guard<std::mutex> mappedChunksLock(mappedChunksMutex_);
+  return mappedChunks_.size();
+}
+
+size_t CpuBufferMgr::getMappedSize() {
+  std::lock_guard<std::mutex> mappedChunksLock(mappedChunksMutex_);
+  return mappedSize_;
+}
+
+AbstractBuffer* CpuBufferMgr::getMappedBuffer(const ChunkKey& key,
+                                              const size_t numBytes) {
+  // a chunk in the pool, e.g. loaded while its extent was out of date, is used as is
+  if (!extentStore_ || BufferMgr::isBufferOnDevice(key)) {
+    return nullptr;
+  }
+  // looked up on every access, the chunk may have changed since it was mapped
+  const auto path = extentStore_->getChunkExtentPath(key);
+  std::lock_guard<std::mutex> mappedChunksLock(mappedChunksMutex_);
+  auto chunkIt = mappedChunks_.find(key);
+  if (chunkIt != mappedChunks_.end() && chunkIt->second->getPath() != path) {
+    if (chunkIt->second->getPinCount() > 0) {
+      return nullptr;  // still in use, the new contents go through the pool meanwhile
+    }
+    dropMappedChunk(chunkIt);
+    chunkIt = mappedChunks_.end();
+  }
+  if (path.empty()) {
+    return nullptr;
+  }
+  if (chunkIt == mappedChunks_.end()) {
+    std::unique_ptr<MappedCpuBuffer> buffer(
+        MappedCpuBuffer::map(path, deviceId_, cudaMgr_));
+    if (!buffer) {
+      return nullptr;
+    }
+    buffer->syncEncoder(extentStore_->getBuffer(key));
+    mappedSize_ += buffer->size();
+    chunkIt = mappedChunks_.emplace(key, std::move(buffer)).first;
+  }
+  if (chunkIt->second->size() < numBytes) {
+    return nullptr;
+  }
+  chunkIt->second->pin();
+  return chunkIt->second.get();
+}
+
+void CpuBufferMgr::dropMappedChunk(MappedChunkMap::iterator chunkIt) {
+  mappedSize_ -= chunkIt->second->size();
+  mappedChunks_.erase(chunkIt);
+}
+
 void CpuBufferMgr::addSlab(const size_t slabSize) {
   slabs_.resize(slabs_.size() + 1);
   try {
-    slabs_.back() = new int8_t[slabSize];
+    if (slabPath_.empty()) {
+      slabs_.back() = new int8_t[slabSize];
+    } else {
+      // hugetlbfs only maps whole huge pages
+      struct statvfs fsStats;
+      const size_t blockSize =
+          statvfs(slabPath_.c_str(), &fsStats) == 0 ? fsStats.f_bsize : 1;
+      const size_t mapSize = (slabSize + blockSize - 1) / blockSize * blockSize;
+      std::string path;
+      do {
+        path = slabPath_ + "/" + slab_file_prefix + std::to_string(numSlabFiles_++);
+      } while (boost::filesystem::exists(path));
+      slabs_.back() = mapSlabFile(path, mapSize, true);
+      slabFiles_.push_back(path);
+      slabMapSizes_.push_back(mapSize);
+    }
   } catch (std::bad_alloc&) {
     slabs_.resize(slabs_.size() - 1);
     throw FailedToCreateSlab();
+  } catch (const FailedToCreateSlab&) {
+    slabs_.resize(slabs_.size() - 1);
+    throw;
   }
   slabSegments_.resize(slabSegments_.size() + 1);
   slabSegments_[slabSegments_.size() - 1].push_back(BufferSeg(0, slabSize / pageSize_));
 }
 
 void CpuBufferMgr::freeAllMem() {
-  for (auto bufIt = slabs_.begin(); bufIt != slabs_.end(); ++bufIt) {
-    delete[] * bufIt;
+  if (slabPath_.empty()) {
+    for (auto bufIt = slabs_.begin(); bufIt != slabs_.end(); ++bufIt) {
+      delete[] * bufIt;
+    }
+    return;
   }
+  for (size_t slabNum = 0; slabNum < slabs_.size(); ++slabNum) {
+    munmap(slabs_[slabNum], slabMapSizes_[slabNum]);
+    if (!slabIndexSaved_) {
+      boost::filesystem::remove(slabFiles_[slabNum]);
+    }
+  }
+  slabFiles_.clear();
+  slabMapSizes_.clear();
 }
 
 void CpuBufferMgr::allocateBuffer(BufferList::iterator segIt,
@@ -66,4 +428,46 @@ void CpuBufferMgr::allocateBuffer(BufferList::iterator segIt,
                                // buffer member
 }
 
+int8_t* CpuBufferMgr::mapSlabFile(const std::string& path,
+                                  const size_t mapSize,
+                                  const bool create) {
+  const int fd = open(path.c_str(), create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0600);
+  if (fd < 0) {
+    LOG(WARNING) << "Could not open slab file " << path
+                 << ", the error was: " << std::strerror(errno);
+    throw FailedToCreateSlab();
+  }
+  if (create) {
+    // reserve the memory up front, so that running out of it fails here rather than
+    // with a SIGBUS on first touch
+#ifdef __APPLE__
+    const int err = ftruncate(fd, mapSize) == 0 ? 0 : errno;
+#else
+    const int err = posix_fallocate(fd, 0, mapSize);
+#endif
+    if (err != 0) {
+      LOG(WARNING) << "Could not allocate " << mapSize << "B for slab file " << path
+                   << ", the error was: " << std::strerror(err);
+      close(fd);
+      std::remove(path.c_str());
+      throw FailedToCreateSlab();
+    }
+  }
+  void* slab = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (slab == MAP_FAILED) {
+    LOG(WARNING) << "Could not map slab file " << path
+                 << ", the error was: " << std::strerror(errno);
+    if (create) {
+      std::remove(path.c_str());
+    }
+    throw FailedToCreateSlab();
+  }
+  return reinterpret_cast<int8_t*>(slab);
+}
+
+std::string CpuBufferMgr::getSlabIndexPath() const {
+  return slabPath_ + "/" + slab_index_file;
+}
+
 }  // namespace Buffer_Namespace
@@ -19,12 +19,40 @@
 
 #include "../BufferMgr.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 namespace CudaMgr_Namespace {
 class CudaMgr;
 }
 
+namespace File_Namespace {
+class GlobalFileMgr;
+}
+
 namespace Buffer_Namespace {
 
+class MappedCpuBuffer;
+
+/**
+ * @class   CpuBufferMgr
+ * @brief   Buffer pool in host memory.
+ *
+ * With a slab path, the slabs are files mapped from that directory instead of heap
+ * memory, which should be on a tmpfs such as /dev/shm or a hugetlbfs mount. The files
+ * outlive the server, so a pool saved by saveSlabIndex() on a clean shutdown is picked
+ * up by adoptSlabs() on the next start: chunks whose size and latest page epoch in the
+ * data files are still the ones they were saved with are adopted as they are, without
+ * being read again, and the others are dropped.
+ *
+ * With an extent store, the chunks of the tables which keep an extent file per chunk
+ * (table option MMAP) are served from those files mapped read-only instead of being
+ * copied into the slabs, as long as they aren't in the pool already. They take none of
+ * the pool's memory and are left to the OS page cache to keep or evict.
+ */
 class CpuBufferMgr : public BufferMgr {
  public:
   CpuBufferMgr(const int deviceId,
@@ -32,18 +60,69 @@ class CpuBufferMgr : public BufferMgr {
                CudaMgr_Namespace::CudaMgr* cudaMgr,
                const size_t bufferAllocIncrement = 2147483648,
                const size_t pageSize = 512,
-               AbstractBufferMgr* parentMgr = 0);
+               AbstractBufferMgr* parentMgr = 0,
+               const std::string& slabPath = "");
   virtual inline MgrType getMgrType() { return CPU_MGR; }
   virtual inline std::string getStringMgrType() { return ToString(CPU_MGR); }
   ~CpuBufferMgr();
 
+  /// Adopts the chunks of the slab files saved by the previous run which still match
+  /// their copy in chunkStore, and removes the other slab files. To be called before
+  /// the pool is used.
+  void adoptSlabs(AbstractBufferMgr* chunkStore);
+
+  /// Records the clean chunks of the pool next to the slab files, along with their size
+  /// and latest page epoch in chunkStore, and keeps the files when the pool is
+  /// destroyed. Holds the pool's locks while it does, but is only meant for a clean
+  /// shutdown, once the servers have stopped taking requests.
+  void saveSlabIndex(AbstractBufferMgr* chunkStore);
+
+  size_t getNumAdoptedChunks() const { return numAdoptedChunks_; }
+
+  /// Serves the chunks which have a current extent file in extentStore from the mapped
+  /// file. To be called before the pool is used.
+  void setExtentStore(File_Namespace::GlobalFileMgr* extentStore) {
+    extentStore_ = extentStore;
+  }
+
+  virtual AbstractBuffer* getBuffer(const ChunkKey& key, const size_t numBytes = 0);
+  virtual void fetchBuffer(const ChunkKey& key,
+                           AbstractBuffer* destBuffer,
+                           const size_t numBytes = 0);
+  virtual bool isBufferOnDevice(const ChunkKey& key);
+  virtual void deleteBuffer(const ChunkKey& key, const bool purge = true);
+  virtual void deleteBuffersWithPrefix(const ChunkKey& keyPrefix,
+                                       const bool purge = true);
+  virtual std::string printSlabs();
+  virtual void clearSlabs();
+
+  size_t getNumMappedChunks();
+  /// Returns the bytes of the mapped chunks, which aren't part of getInUseSize().
+  size_t getMappedSize();
+
  private:
   virtual void addSlab(const size_t slabSize);
   virtual void freeAllMem();
   virtual void allocateBuffer(BufferList::iterator segIt,
                               const size_t pageSize,
                               const size_t initialSize);
+  int8_t* mapSlabFile(const std::string& path, const size_t mapSize, const bool create);
+  std::string getSlabIndexPath() const;
+  AbstractBuffer* getMappedBuffer(const ChunkKey& key, const size_t numBytes);
+  typedef std::map<ChunkKey, std::unique_ptr<MappedCpuBuffer>> MappedChunkMap;
+  void dropMappedChunk(MappedChunkMap::iterator chunkIt);
+
   CudaMgr_Namespace::CudaMgr* cudaMgr_;
+  std::string slabPath_;
+  std::vector<std::string> slabFiles_;  // file mapped by each slab
+  std::vector<size_t> slabMapSizes_;    // bytes mapped by each slab
+  size_t numSlabFiles_;
+  size_t numAdoptedChunks_;
+  bool slabIndexSaved_;
+  File_Namespace::GlobalFileMgr* extentStore_;
+  MappedChunkMap mappedChunks_;
+  size_t mappedSize_;  // bytes of the mapped chunks
+  std::mutex mappedChunksMutex_;
 };
 
 }  // namespace Buffer_Namespace
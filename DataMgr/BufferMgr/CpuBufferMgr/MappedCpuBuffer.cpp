@@ -0,0 +1,117 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file        MappedCpuBuffer.cpp
+ * @brief       Read-only CPU buffer of a chunk mapped from its extent file.
+ */
+
+#include "MappedCpuBuffer.h"
+#include <glog/logging.h>
+#include "../../../CudaMgr/CudaMgr.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace Buffer_Namespace {
+
+MappedCpuBuffer::MappedCpuBuffer(int8_t* mem,
+                                 const size_t numBytes,
+                                 const std::string& path,
+                                 const int deviceId,
+                                 CudaMgr_Namespace::CudaMgr* cudaMgr)
+    : AbstractBuffer(deviceId), mem_(mem), path_(path), cudaMgr_(cudaMgr), pinCount_(0) {
+  size_ = numBytes;
+}
+
+MappedCpuBuffer::~MappedCpuBuffer() {
+  if (munmap(mem_, size_) != 0) {
+    LOG(WARNING) << "Could not unmap " << path_
+                 << ", the error was: " << std::strerror(errno);
+  }
+}
+
+MappedCpuBuffer* MappedCpuBuffer::map(const std::string& path,
+                                      const int deviceId,
+                                      CudaMgr_Namespace::CudaMgr* cudaMgr) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(WARNING) << "Could not open " << path
+                 << ", the error was: " << std::strerror(errno);
+    return nullptr;
+  }
+  struct stat fileStat;
+  void* mem = MAP_FAILED;
+  if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+    mem = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  const int mapErrno = errno;
+  close(fd);  // the mapping keeps the file
+  if (mem == MAP_FAILED) {
+    LOG(WARNING) << "Could not map " << path
+                 << ", the error was: " << std::strerror(mapErrno);
+    return nullptr;
+  }
+  return new MappedCpuBuffer(
+      reinterpret_cast<int8_t*>(mem), fileStat.st_size, path, deviceId, cudaMgr);
+}
+
+void MappedCpuBuffer::read(int8_t* const dst,
+                           const size_t numBytes,
+                           const size_t offset,
+                           const MemoryLevel dstBufferType,
+                           const int dstDeviceId) {
+  if (numBytes + offset > size_) {
+    LOG(FATAL) << "Buffer size is smaller than requested read: " << numBytes + offset
+               << " > " << size_;
+  }
+  if (dstBufferType == CPU_LEVEL) {
+    memcpy(dst, mem_ + offset, numBytes);
+  } else if (dstBufferType == GPU_LEVEL) {
+    CHECK_GE(dstDeviceId, 0);
+    cudaMgr_->copyHostToDevice(dst, mem_ + offset, numBytes, dstDeviceId);
+  } else {
+    LOG(FATAL) << "Unsupported buffer type";
+  }
+}
+
+void MappedCpuBuffer::write(int8_t* src,
+                            const size_t numBytes,
+                            const size_t offset,
+                            const MemoryLevel srcBufferType,
+                            const int srcDeviceId) {
+  LOG(FATAL) << "Attempt to write to the read-only mapped chunk " << path_;
+}
+
+void MappedCpuBuffer::reserve(size_t numBytes) {
+  if (numBytes > size_) {
+    LOG(FATAL) << "Attempt to grow the read-only mapped chunk " << path_;
+  }
+}
+
+void MappedCpuBuffer::append(int8_t* src,
+                             const size_t numBytes,
+                             const MemoryLevel srcBufferType,
+                             const int deviceId) {
+  LOG(FATAL) << "Attempt to append to the read-only mapped chunk " << path_;
+}
+
+}  // namespace Buffer_Namespace
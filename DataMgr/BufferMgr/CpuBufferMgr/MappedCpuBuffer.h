@@ -0,0 +1,101 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file        MappedCpuBuffer.h
+ * @brief       Read-only CPU buffer of a chunk mapped from its extent file.
+ */
+
+#ifndef MAPPEDCPUBUFFER_H
+#define MAPPEDCPUBUFFER_H
+
+#include "../../AbstractBuffer.h"
+
+#include <atomic>
+#include <string>
+
+using namespace Data_Namespace;
+
+namespace CudaMgr_Namespace {
+class CudaMgr;
+}
+
+namespace Buffer_Namespace {
+
+/**
+ * @class   MappedCpuBuffer
+ * @brief   Chunk in host memory whose pages are those of a mapped file.
+ *
+ * The buffer owns the mapping, which is read-only: the pages are the file's pages in the
+ * OS page cache, so they are neither copied nor counted against the buffer pool, and
+ * they are evicted by the OS when memory runs short.
+ */
+class MappedCpuBuffer : public AbstractBuffer {
+ public:
+  MappedCpuBuffer(int8_t* mem,
+                  const size_t numBytes,
+                  const std::string& path,
+                  const int deviceId,
+                  CudaMgr_Namespace::CudaMgr* cudaMgr);
+  ~MappedCpuBuffer();
+
+  /// Maps the whole file read-only. Returns nullptr, with a warning, if it can't.
+  static MappedCpuBuffer* map(const std::string& path,
+                              const int deviceId,
+                              CudaMgr_Namespace::CudaMgr* cudaMgr);
+
+  virtual void read(int8_t* const dst,
+                    const size_t numBytes,
+                    const size_t offset = 0,
+                    const MemoryLevel dstBufferType = CPU_LEVEL,
+                    const int dstDeviceId = -1);
+  virtual void write(int8_t* src,
+                     const size_t numBytes,
+                     const size_t offset = 0,
+                     const MemoryLevel srcBufferType = CPU_LEVEL,
+                     const int srcDeviceId = -1);
+  virtual void reserve(size_t numBytes);
+  virtual void append(int8_t* src,
+                      const size_t numBytes,
+                      const MemoryLevel srcBufferType = CPU_LEVEL,
+                      const int deviceId = -1);
+  virtual int8_t* getMemoryPtr() { return mem_; }
+
+  virtual size_t pageCount() const { return 1; }
+  virtual size_t pageSize() const { return size_; }
+  virtual size_t size() const { return size_; }
+  virtual size_t reservedSize() const { return size_; }
+  virtual MemoryLevel getType() const { return CPU_LEVEL; }
+
+  virtual int pin() { return ++pinCount_; }
+  virtual int unPin() { return --pinCount_; }
+  virtual int getPinCount() { return pinCount_; }
+
+  const std::string& getPath() const { return path_; }
+
+ private:
+  MappedCpuBuffer(const MappedCpuBuffer&);
+  MappedCpuBuffer& operator=(const MappedCpuBuffer&);
+
+  int8_t* mem_;
+  std::string path_;
+  CudaMgr_Namespace::CudaMgr* cudaMgr_;
+  std::atomic<int> pinCount_;
+};
+
+}  // namespace Buffer_Namespace
+
+#endif  // MAPPEDCPUBUFFER_H
@@ -21,8 +21,10 @@
 
 #include "DataMgr.h"
 #include "../CudaMgr/CudaMgr.h"
+#include "BufferMgr/BufferPoolPrewarmer.h"
 #include "BufferMgr/CpuBufferMgr/CpuBufferMgr.h"
 #include "BufferMgr/GpuCudaBufferMgr/GpuCudaBufferMgr.h"
+#include "FileMgr/DiskCacheMgr.h"
 #include "FileMgr/GlobalFileMgr.h"
 
 #ifdef __APPLE__
@@ -68,6 +70,7 @@ DataMgr::DataMgr(const string& dataDir,
 }
 
 DataMgr::~DataMgr() {
+  cpuBufferPrewarmer_.reset();
   int numLevels = bufferMgrs_.size();
   for (int level = numLevels - 1; level >= 0; --level) {
     for (size_t device = 0; device < bufferMgrs_[level].size(); device++) {
@@ -98,7 +101,10 @@ size_t DataMgr::getTotalSystemMemory() {
 void DataMgr::populateMgrs(const MapDParameters& mapd_parameters,
                            const size_t userSpecifiedNumReaderThreads) {
   bufferMgrs_.resize(2);
-  bufferMgrs_[0].push_back(new GlobalFileMgr(0, dataDir_, userSpecifiedNumReaderThreads));
+  auto globalFileMgr = new GlobalFileMgr(0, dataDir_, userSpecifiedNumReaderThreads);
+  globalFileMgr->setNarrowChunks(mapd_parameters.narrow_chunks);
+  globalFileMgr->setChunkGrowthPages(mapd_parameters.chunk_growth_pages);
+  bufferMgrs_[0].push_back(globalFileMgr);
   levelSizes_.push_back(1);
   size_t cpuBufferSize = mapd_parameters.cpu_buffer_mem_bytes;
   if (cpuBufferSize == 0) {  // if size is not specified
@@ -109,12 +115,31 @@ void DataMgr::populateMgrs(const MapDParameters& mapd_parameters,
   // cpuSlabSize -= cpuSlabSize % 512 == 0 ? 0 : 512 - (cpuSlabSize % 512);
   cpuSlabSize = (cpuSlabSize / 512) * 512;
   LOG(INFO) << "cpuSlabSize is " << (float)cpuSlabSize / (1024 * 1024) << "M";
+  AbstractBufferMgr* cpuParentMgr = bufferMgrs_[0][0];
+  if (!mapd_parameters.disk_cache_path.empty() && mapd_parameters.disk_cache_bytes > 0) {
+    diskCacheMgr_ = std::make_unique<DiskCacheMgr>(0,
+                                                   mapd_parameters.disk_cache_path,
+                                                   mapd_parameters.disk_cache_bytes,
+                                                   bufferMgrs_[0][0]);
+    cpuParentMgr = diskCacheMgr_.get();
+    LOG(INFO) << "disk cache is "
+              << (float)mapd_parameters.disk_cache_bytes / (1024 * 1024) << "M in "
+              << mapd_parameters.disk_cache_path;
+  }
+  auto cpuBufferMgr = new CpuBufferMgr(0,
+                                       cpuBufferSize,
+                                       cudaMgr_.get(),
+                                       cpuSlabSize,
+                                       512,
+                                       cpuParentMgr,
+                                       mapd_parameters.cpu_buffer_mem_path);
+  cpuBufferMgr->adoptSlabs(globalFileMgr);
+  cpuBufferMgr->setExtentStore(globalFileMgr);
   if (hasGpus_) {
     LOG(INFO) << "reserved GPU memory is " << (float)reservedGpuMem_ / (1024 * 1024)
               << "M includes render buffer allocation";
     bufferMgrs_.resize(3);
-    bufferMgrs_[1].push_back(new CpuBufferMgr(
-        0, cpuBufferSize, cudaMgr_.get(), cpuSlabSize, 512, bufferMgrs_[0][0]));
+    bufferMgrs_[1].push_back(cpuBufferMgr);
     levelSizes_.push_back(1);
     int numGpus = cudaMgr_->getDeviceCount();
     for (int gpuNum = 0; gpuNum < numGpus; ++gpuNum) {
@@ -130,10 +155,17 @@ void DataMgr::populateMgrs(const MapDParameters& mapd_parameters,
     }
     levelSizes_.push_back(numGpus);
   } else {
-    bufferMgrs_[1].push_back(new CpuBufferMgr(
-        0, cpuBufferSize, cudaMgr_.get(), cpuSlabSize, 512, bufferMgrs_[0][0]));
+    bufferMgrs_[1].push_back(cpuBufferMgr);
     levelSizes_.push_back(1);
   }
+  cpuBufferPrewarmer_ = std::make_unique<BufferPoolPrewarmer>(
+      cpuBufferMgr,
+      globalFileMgr,
+      mapd_parameters.cpu_buffer_prewarm ? dataDir_ + "/cpu_buffer_access_history" : "",
+      mapd_parameters.cpu_buffer_prewarm_rate * 1024 * 1024);
+  if (mapd_parameters.cpu_buffer_prewarm) {
+    cpuBufferPrewarmer_->prewarmFromHistory();
+  }
 }
 
 void DataMgr::convertDB(const std::string basePath) {
@@ -283,6 +315,12 @@ bufferMgrs_[MemoryLevel::GPU_LEVEL][gpuNum]->isAllocationCapped(); memInfo.push_
 //  return tss.str();
 //}
 
+size_t DataMgr::getBufferPoolSize(const MemoryLevel memLevel, const int deviceId) {
+  CHECK_LT(static_cast<size_t>(memLevel), bufferMgrs_.size());
+  CHECK_LT(static_cast<size_t>(deviceId), bufferMgrs_[memLevel].size());
+  return bufferMgrs_[memLevel][deviceId]->getMaxSize();
+}
+
 std::string DataMgr::dumpLevel(const MemoryLevel memLevel) {
   // if gpu we need to iterate through all the buffermanagers for each card
   if (memLevel == MemoryLevel::GPU_LEVEL) {
@@ -310,10 +348,39 @@ void DataMgr::clearMemory(const MemoryLevel memLevel) {
       throw std::runtime_error("Unable to clear GPU memory: No GPUs detected");
     }
   } else {
+    cpuBufferPrewarmer_->stopPrewarm();
     bufferMgrs_[memLevel][0]->clearSlabs();
   }
 }
 
+void DataMgr::prewarmCpuBufferPool() {
+  cpuBufferPrewarmer_->prewarmFromHistory();
+}
+
+size_t DataMgr::prewarmChunksWithPrefix(const std::vector<ChunkKey>& keyPrefixes) {
+  std::vector<ChunkKey> keys;
+  for (const auto& keyPrefix : keyPrefixes) {
+    std::vector<std::pair<ChunkKey, ChunkMetadata>> chunkMetadataVec;
+    bufferMgrs_[MemoryLevel::DISK_LEVEL][0]->getChunkMetadataVecForKeyPrefix(
+        chunkMetadataVec, keyPrefix);
+    for (const auto& chunkMetadata : chunkMetadataVec) {
+      keys.push_back(chunkMetadata.first);
+      if (chunkMetadata.first.size() == 5 && chunkMetadata.first[4] == 1) {
+        // the index buffer of a variable length chunk has no metadata of its own
+        keys.push_back(chunkMetadata.first);
+        keys.back()[4] = 2;
+      }
+    }
+  }
+  return cpuBufferPrewarmer_->prewarmChunks(keys);
+}
+
+void DataMgr::saveCpuBufferPool() {
+  auto cpuBufferMgr = dynamic_cast<CpuBufferMgr*>(bufferMgrs_[MemoryLevel::CPU_LEVEL][0]);
+  CHECK(cpuBufferMgr);
+  cpuBufferMgr->saveSlabIndex(bufferMgrs_[MemoryLevel::DISK_LEVEL][0]);
+}
+
 bool DataMgr::isBufferOnDevice(const ChunkKey& key,
                                const MemoryLevel memLevel,
                                const int deviceId) {
@@ -352,6 +419,9 @@ AbstractBuffer* DataMgr::getChunkBuffer(const ChunkKey& key,
 }
 
 void DataMgr::deleteChunksWithPrefix(const ChunkKey& keyPrefix) {
+  if (diskCacheMgr_) {
+    diskCacheMgr_->invalidateChunksWithPrefix(keyPrefix);
+  }
   int numLevels = bufferMgrs_.size();
   for (int level = numLevels - 1; level >= 0; --level) {
     for (int device = 0; device < levelSizes_[level]; ++device) {
@@ -366,6 +436,9 @@ void DataMgr::deleteChunksWithPrefix(const ChunkKey& keyPrefix,
   if (bufferMgrs_.size() <= memLevel) {
     return;
   }
+  if (memLevel == DISK_LEVEL && diskCacheMgr_) {
+    diskCacheMgr_->invalidateChunksWithPrefix(keyPrefix);
+  }
   for (int device = 0; device < levelSizes_[memLevel]; ++device) {
     bufferMgrs_[memLevel][device]->deleteBuffersWithPrefix(keyPrefix);
   }
@@ -422,14 +495,37 @@ void DataMgr::checkpoint() {
 }
 
 void DataMgr::removeTableRelatedDS(const int db_id, const int tb_id) {
+  if (diskCacheMgr_) {
+    diskCacheMgr_->invalidateChunksWithPrefix({db_id, tb_id});
+  }
   dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])->removeTableRelatedDS(db_id, tb_id);
 }
 
 void DataMgr::setTableEpoch(const int db_id, const int tb_id, const int start_epoch) {
+  if (diskCacheMgr_) {
+    diskCacheMgr_->invalidateChunksWithPrefix({db_id, tb_id});
+  }
   dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])
       ->setTableEpoch(db_id, tb_id, start_epoch);
 }
 
+void DataMgr::setTableMmapChunks(const int db_id,
+                                 const int tb_id,
+                                 const bool mmap_chunks) {
+  dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])
+      ->setMmapChunks(db_id, tb_id, mmap_chunks);
+}
+
+size_t DataMgr::compactTableChunks(const int db_id, const int tb_id) {
+  return dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])->compactChunks(db_id, tb_id);
+}
+
+File_Namespace::ChunkLayoutStats DataMgr::getTableChunkLayoutStats(const int db_id,
+                                                                   const int tb_id) {
+  return dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])
+      ->getChunkLayoutStats(db_id, tb_id);
+}
+
 size_t DataMgr::getTableEpoch(const int db_id, const int tb_id) {
   return dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])->getTableEpoch(db_id, tb_id);
 }
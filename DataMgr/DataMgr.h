@@ -37,6 +37,12 @@
 
 namespace File_Namespace {
 class FileBuffer;
+class DiskCacheMgr;
+struct ChunkLayoutStats;
+}
+
+namespace Buffer_Namespace {
+class BufferPoolPrewarmer;
 }
 
 namespace CudaMgr_Namespace {
@@ -97,7 +103,16 @@ class DataMgr {
                         const int deviceId);
   std::vector<MemoryInfo> getMemoryInfo(const MemoryLevel memLevel);
   std::string dumpLevel(const MemoryLevel memLevel);
+  // the most the buffer pool of the device may grow to, in bytes
+  size_t getBufferPoolSize(const MemoryLevel memLevel, const int deviceId);
   void clearMemory(const MemoryLevel memLevel);
+  // keeps the CPU buffer pool for the next start, on a clean shutdown
+  void saveCpuBufferPool();
+  // reloads the chunks used most into the CPU buffer pool, in the background
+  void prewarmCpuBufferPool();
+  // loads the chunks with the given key prefixes into the CPU buffer pool, returns how
+  // many were loaded
+  size_t prewarmChunksWithPrefix(const std::vector<ChunkKey>& keyPrefixes);
 
   // const std::map<ChunkKey, File_Namespace::FileBuffer *> & getChunkMap();
   const std::map<ChunkKey, File_Namespace::FileBuffer*>& getChunkMap();
@@ -112,6 +127,14 @@ class DataMgr {
   void removeTableRelatedDS(const int db_id, const int tb_id);
   void setTableEpoch(const int db_id, const int tb_id, const int start_epoch);
   size_t getTableEpoch(const int db_id, const int tb_id);
+  // serves the table's chunks to the CPU level from files mapped read-only, written
+  // contiguously at its checkpoints
+  void setTableMmapChunks(const int db_id, const int tb_id, const bool mmap_chunks);
+  // moves the table's chunks which are scattered over its files into one page run each,
+  // as of the next checkpoint, returns how many were moved
+  size_t compactTableChunks(const int db_id, const int tb_id);
+  File_Namespace::ChunkLayoutStats getTableChunkLayoutStats(const int db_id,
+                                                            const int tb_id);
 
   CudaMgr_Namespace::CudaMgr* getCudaMgr() const { return cudaMgr_.get(); }
 
@@ -127,6 +150,9 @@ class DataMgr {
   void createTopLevelMetadata() const;
 
   std::vector<std::vector<AbstractBufferMgr*>> bufferMgrs_;
+  // optional tier between the CPU and DISK levels, caching chunks on a local disk
+  std::unique_ptr<File_Namespace::DiskCacheMgr> diskCacheMgr_;
+  std::unique_ptr<Buffer_Namespace::BufferPoolPrewarmer> cpuBufferPrewarmer_;
   std::unique_ptr<CudaMgr_Namespace::CudaMgr> cudaMgr_;
   std::string dataDir_;
   bool hasGpus_;
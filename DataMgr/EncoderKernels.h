@@ -0,0 +1,158 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    EncoderKernels.h
+ * @brief   Branch-free kernels for the append path of the fixed width encoders.
+ *
+ * The loops work on a fixed number of independent lanes with selects instead of
+ * branches, which the compiler turns into SIMD code for every element type, floating
+ * point included, without relying on any particular instruction set.
+ */
+
+#ifndef ENCODER_KERNELS_H
+#define ENCODER_KERNELS_H
+
+#include "AbstractBuffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace EncoderKernels {
+
+constexpr size_t kLanes = 16;
+
+template <typename T>
+struct AppendStats {
+  T min;
+  T max;
+  bool has_nulls;
+  size_t num_unencodable;  // values which don't survive the narrowing to the encoding
+};
+
+/**
+ * Computes the min, max and nulls of values encoded as V, the way the encoders keep
+ * them: values equal to null_val once encoded only set has_nulls, and values which
+ * change when narrowed to V are counted and left out of the stats.
+ */
+template <typename T, typename V>
+AppendStats<T> compute_append_stats(const T* values,
+                                    const size_t num_values,
+                                    const V null_val) {
+  // flags and counts as wide as T, so that every lane accumulator fits the same vector
+  typedef typename std::conditional<
+      sizeof(T) == 8,
+      uint64_t,
+      typename std::conditional<
+          sizeof(T) == 4,
+          uint32_t,
+          typename std::conditional<sizeof(T) == 2, uint16_t, uint8_t>::type>::type>::
+      type LaneCount;
+  T lane_min[kLanes];
+  T lane_max[kLanes];
+  LaneCount lane_nulls[kLanes];
+  LaneCount lane_unencodable[kLanes];
+  std::fill(lane_min, lane_min + kLanes, std::numeric_limits<T>::max());
+  std::fill(lane_max, lane_max + kLanes, std::numeric_limits<T>::lowest());
+  std::fill(lane_nulls, lane_nulls + kLanes, 0);
+  std::fill(lane_unencodable, lane_unencodable + kLanes, 0);
+  AppendStats<T> stats{
+      std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest(), false, 0};
+  // narrow counters are drained before they can wrap around
+  const size_t max_block =
+      kLanes * std::min<size_t>(std::numeric_limits<LaneCount>::max(), size_t(1) << 20);
+  for (size_t block = 0; block < num_values; block += max_block) {
+    const size_t block_end = std::min(num_values, block + max_block);
+    size_t i = block;
+    for (; i + kLanes <= block_end; i += kLanes) {
+      for (size_t lane = 0; lane < kLanes; ++lane) {
+        const T value = values[i + lane];
+        const V encoded = static_cast<V>(value);
+        // no narrowing for V == T, which also keeps NaN from counting as unencodable
+        const bool fits =
+            std::is_same<T, V>::value || static_cast<T>(encoded) == value;
+        const bool is_null = fits & (encoded == null_val);
+        const bool valid = fits & !is_null;
+        lane_min[lane] = (valid & (value < lane_min[lane])) ? value : lane_min[lane];
+        lane_max[lane] = (valid & (lane_max[lane] < value)) ? value : lane_max[lane];
+        lane_nulls[lane] |= is_null;
+        lane_unencodable[lane] += !fits;
+      }
+    }
+    for (; i < block_end; ++i) {
+      const T value = values[i];
+      const V encoded = static_cast<V>(value);
+      const bool fits = std::is_same<T, V>::value || static_cast<T>(encoded) == value;
+      const bool is_null = fits & (encoded == null_val);
+      if (fits && !is_null) {
+        stats.min = std::min(stats.min, value);
+        stats.max = std::max(stats.max, value);
+      }
+      stats.has_nulls |= is_null;
+      stats.num_unencodable += !fits;
+    }
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      stats.num_unencodable += lane_unencodable[lane];
+      lane_unencodable[lane] = 0;
+    }
+  }
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    stats.min = std::min(stats.min, lane_min[lane]);
+    stats.max = std::max(stats.max, lane_max[lane]);
+    stats.has_nulls |= lane_nulls[lane] != 0;
+  }
+  return stats;
+}
+
+/**
+ * Appends num_elems elements of type V to the buffer, produced by
+ * encode_fn(V* dst, size_t first_elem, size_t num_elems). Buffers in CPU memory are
+ * encoded into in place; for the others the elements are staged through a small block,
+ * so the input is never copied as a whole.
+ */
+template <typename V, typename ENCODE_FN>
+void append_encoded(Data_Namespace::AbstractBuffer* buffer,
+                    const size_t num_elems,
+                    ENCODE_FN encode_fn) {
+  if (!num_elems) {
+    return;
+  }
+  const size_t num_bytes = num_elems * sizeof(V);
+  if (buffer->getType() == Data_Namespace::CPU_LEVEL) {
+    const size_t old_size = buffer->size();
+    if (old_size + num_bytes > buffer->reservedSize()) {
+      buffer->reserve(old_size + num_bytes);
+    }
+    encode_fn(reinterpret_cast<V*>(buffer->getMemoryPtr() + old_size), 0, num_elems);
+    buffer->setSize(old_size + num_bytes);
+    buffer->setAppended();
+    return;
+  }
+  constexpr size_t block_elems = 16384 / sizeof(V);
+  V block[block_elems];
+  for (size_t first = 0; first < num_elems; first += block_elems) {
+    const size_t count = std::min(block_elems, num_elems - first);
+    encode_fn(block, first, count);
+    buffer->append(reinterpret_cast<int8_t*>(block), count * sizeof(V));
+  }
+}
+
+}  // namespace EncoderKernels
+
+#endif  // ENCODER_KERNELS_H
@@ -0,0 +1,294 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file        DiskCacheMgr.cpp
+ * @brief       Caches chunks of the data directory in files on a fast local disk.
+ */
+
+#include "DiskCacheMgr.h"
+#include "../../Shared/File.h"
+#include "FileBuffer.h"
+
+#include <glog/logging.h>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace File_Namespace {
+
+namespace {
+
+const char* cached_chunk_ext = ".chunk";
+const char* partial_chunk_ext = ".part";
+
+int latest_epoch(const AbstractBuffer* chunk) {
+  const auto file_buffer = dynamic_cast<const FileBuffer*>(chunk);
+  return file_buffer ? file_buffer->latestEpoch() : -1;
+}
+
+bool has_prefix(const ChunkKey& key, const ChunkKey& keyPrefix) {
+  return key.size() >= keyPrefix.size() &&
+         std::equal(keyPrefix.begin(), keyPrefix.end(), key.begin());
+}
+
+}  // namespace
+
+DiskCacheMgr::DiskCacheMgr(const int deviceId,
+                           const std::string& cachePath,
+                           const size_t maxSize,
+                           AbstractBufferMgr* parentMgr)
+    : AbstractBufferMgr(deviceId)
+    , cachePath_(cachePath)
+    , maxSize_(maxSize)
+    , inUseSize_(0)
+    , numHits_(0)
+    , numMisses_(0)
+    , numTempFiles_(0) {
+  CHECK(parentMgr);
+  parentMgr_ = parentMgr;
+  boost::filesystem::path path(cachePath_);
+  if (boost::filesystem::exists(path)) {
+    if (!boost::filesystem::is_directory(path)) {
+      LOG(FATAL) << "Disk cache path " << cachePath_ << " is not a directory.";
+    }
+    // whatever is left over from a previous run may no longer match the data directory
+    for (boost::filesystem::directory_iterator fileIt(path), endIt; fileIt != endIt;
+         ++fileIt) {
+      const auto ext = fileIt->path().extension().string();
+      if (ext == cached_chunk_ext || ext == partial_chunk_ext) {
+        boost::filesystem::remove(fileIt->path());
+      }
+    }
+  } else if (!boost::filesystem::create_directories(path)) {
+    LOG(FATAL) << "Could not create the disk cache directory " << cachePath_;
+  }
+}
+
+DiskCacheMgr::~DiskCacheMgr() {
+  clearSlabs();
+}
+
+void DiskCacheMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
+  {
+    std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+    auto chunkIt = cachedChunks_.find(key);
+    if (chunkIt != cachedChunks_.end()) {
+      dropChunk(chunkIt);
+    }
+  }
+  parentMgr_->deleteBuffer(key, purge);
+}
+
+void DiskCacheMgr::deleteBuffersWithPrefix(const ChunkKey& keyPrefix, const bool purge) {
+  invalidateChunksWithPrefix(keyPrefix);
+  parentMgr_->deleteBuffersWithPrefix(keyPrefix, purge);
+}
+
+void DiskCacheMgr::fetchBuffer(const ChunkKey& key,
+                               AbstractBuffer* destBuffer,
+                               const size_t numBytes) {
+  const auto chunk = parentMgr_->getBuffer(key);
+  const size_t chunkSize = numBytes == 0 ? chunk->size() : numBytes;
+  if (destBuffer->getType() != CPU_LEVEL || destBuffer->isDirty() || chunk->isDirty() ||
+      chunkSize > chunk->size()) {
+    // not cacheable, or an error the parent reports
+    parentMgr_->fetchBuffer(key, destBuffer, numBytes);
+    return;
+  }
+  if (readCachedChunk(key, chunk, destBuffer, chunkSize)) {
+    return;
+  }
+  const int epoch = latest_epoch(chunk);
+  parentMgr_->fetchBuffer(key, destBuffer, numBytes);
+  // a write racing with the fetch would leave the chunk dirty or advance its epoch
+  if (!chunk->isDirty() && latest_epoch(chunk) == epoch) {
+    cacheChunk(key, chunk, epoch, destBuffer);
+  }
+}
+
+AbstractBuffer* DiskCacheMgr::putBuffer(const ChunkKey& key,
+                                        AbstractBuffer* srcBuffer,
+                                        const size_t numBytes) {
+  {
+    std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+    auto chunkIt = cachedChunks_.find(key);
+    if (chunkIt != cachedChunks_.end()) {
+      dropChunk(chunkIt);
+    }
+  }
+  return parentMgr_->putBuffer(key, srcBuffer, numBytes);
+}
+
+bool DiskCacheMgr::isBufferOnDevice(const ChunkKey& key) {
+  std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+  return cachedChunks_.find(key) != cachedChunks_.end();
+}
+
+std::string DiskCacheMgr::printSlabs() {
+  std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+  std::ostringstream tss;
+  tss << "Disk cache " << cachePath_ << ": " << cachedChunks_.size() << " chunks, "
+      << inUseSize_ << " of " << maxSize_ << " bytes, " << numHits_ << " hits, "
+      << numMisses_ << " misses" << std::endl;
+  return tss.str();
+}
+
+void DiskCacheMgr::clearSlabs() {
+  std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+  while (!cachedChunks_.empty()) {
+    dropChunk(cachedChunks_.begin());
+  }
+}
+
+size_t DiskCacheMgr::getInUseSize() {
+  std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+  return inUseSize_;
+}
+
+size_t DiskCacheMgr::getNumChunks() {
+  std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+  return cachedChunks_.size();
+}
+
+void DiskCacheMgr::invalidateChunksWithPrefix(const ChunkKey& keyPrefix) {
+  std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+  auto chunkIt = cachedChunks_.lower_bound(keyPrefix);
+  while (chunkIt != cachedChunks_.end() && has_prefix(chunkIt->first, keyPrefix)) {
+    dropChunk(chunkIt++);
+  }
+}
+
+std::string DiskCacheMgr::getChunkPath(const ChunkKey& key) const {
+  std::string path = cachePath_ + "/";
+  for (size_t i = 0; i < key.size(); ++i) {
+    path += (i ? "_" : "") + std::to_string(key[i]);
+  }
+  return path + cached_chunk_ext;
+}
+
+bool DiskCacheMgr::readCachedChunk(const ChunkKey& key,
+                                   const AbstractBuffer* chunk,
+                                   AbstractBuffer* destBuffer,
+                                   const size_t chunkSize) {
+  FILE* f{nullptr};
+  {
+    std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+    auto chunkIt = cachedChunks_.find(key);
+    if (chunkIt == cachedChunks_.end()) {
+      ++numMisses_;
+      return false;
+    }
+    auto& cachedChunk = chunkIt->second;
+    if (cachedChunk.chunkSize != chunk->size() ||
+        cachedChunk.epoch != latest_epoch(chunk)) {
+      dropChunk(chunkIt);  // stale
+      ++numMisses_;
+      return false;
+    }
+    if (cachedChunk.numBytes < chunkSize) {
+      ++numMisses_;
+      return false;
+    }
+    // opened with the lock held so that the file can't be dropped in between; once
+    // open, it stays readable even if it is dropped before we're done
+    f = fopen(getChunkPath(key).c_str(), "rb");
+    if (!f) {
+      LOG(WARNING) << "Could not open cached chunk " << getChunkPath(key)
+                   << ", the error was: " << std::strerror(errno);
+      dropChunk(chunkIt, false);
+      ++numMisses_;
+      return false;
+    }
+    lru_.splice(lru_.end(), lru_, cachedChunk.lruIt);
+    ++numHits_;
+  }
+  destBuffer->reserve(chunkSize);
+  const size_t offset = chunk->isUpdated() ? 0 : destBuffer->size();
+  if (chunkSize > offset) {
+    File_Namespace::read(
+        f, offset, chunkSize - offset, destBuffer->getMemoryPtr() + offset);
+  }
+  fclose(f);
+  destBuffer->setSize(chunkSize);
+  destBuffer->syncEncoder(chunk);
+  return true;
+}
+
+void DiskCacheMgr::cacheChunk(const ChunkKey& key,
+                              const AbstractBuffer* chunk,
+                              const int epoch,
+                              AbstractBuffer* srcBuffer) {
+  const size_t numBytes = srcBuffer->size();
+  if (numBytes == 0 || numBytes > maxSize_) {
+    return;
+  }
+  const auto path = getChunkPath(key);
+  // written under a name of its own first, so that readers only ever see whole chunks
+  const auto partialPath =
+      path + "." + std::to_string(numTempFiles_++) + partial_chunk_ext;
+  FILE* f = fopen(partialPath.c_str(), "wb");
+  if (!f) {
+    LOG(WARNING) << "Could not create cached chunk " << partialPath
+                 << ", the error was: " << std::strerror(errno);
+    return;
+  }
+  const bool written = fwrite(srcBuffer->getMemoryPtr(), 1, numBytes, f) == numBytes;
+  if (fclose(f) != 0 || !written) {
+    LOG(WARNING) << "Could not write cached chunk " << partialPath
+                 << ", the error was: " << std::strerror(errno);
+    std::remove(partialPath.c_str());
+    return;
+  }
+
+  std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+  auto chunkIt = cachedChunks_.find(key);
+  if (chunkIt != cachedChunks_.end()) {
+    dropChunk(chunkIt, false);  // replaced by the rename below
+  }
+  if (std::rename(partialPath.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Could not rename cached chunk " << partialPath << " to " << path
+                 << ", the error was: " << std::strerror(errno);
+    std::remove(partialPath.c_str());
+    std::remove(path.c_str());
+    return;
+  }
+  CachedChunk cachedChunk;
+  cachedChunk.numBytes = numBytes;
+  cachedChunk.chunkSize = chunk->size();
+  cachedChunk.epoch = epoch;
+  cachedChunk.lruIt = lru_.insert(lru_.end(), key);
+  cachedChunks_.emplace(key, cachedChunk);
+  inUseSize_ += numBytes;
+  while (inUseSize_ > maxSize_) {
+    dropChunk(cachedChunks_.find(lru_.front()));
+  }
+}
+
+void DiskCacheMgr::dropChunk(CachedChunkMap::iterator chunkIt, const bool removeFile) {
+  CHECK(chunkIt != cachedChunks_.end());
+  if (removeFile) {
+    std::remove(getChunkPath(chunkIt->first).c_str());
+  }
+  inUseSize_ -= chunkIt->second.numBytes;
+  lru_.erase(chunkIt->second.lruIt);
+  cachedChunks_.erase(chunkIt);
+}
+
+}  // namespace File_Namespace
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file        DiskCacheMgr.h
+ * @brief       Caches chunks of the data directory in files on a fast local disk.
+ */
+
+#ifndef DATAMGR_MEMORY_FILE_DISKCACHEMGR_H
+#define DATAMGR_MEMORY_FILE_DISKCACHEMGR_H
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "../AbstractBuffer.h"
+#include "../AbstractBufferMgr.h"
+
+using namespace Data_Namespace;
+
+namespace File_Namespace {
+
+/**
+ * @class   DiskCacheMgr
+ * @brief   Cache tier between the CPU buffer pool and the GlobalFileMgr.
+ *
+ * Chunks fetched from the data directory are copied to one file each in the cache
+ * directory, and chunks evicted from the CPU buffer pool are read back from there while
+ * they're still cached. The least recently used chunks are dropped once the cache grows
+ * past its capacity.
+ *
+ * Writes may reach the data directory without going through this tier, so only clean
+ * chunks are cached, and a cached copy is only used while the size and latest page epoch
+ * of the chunk still match the ones it was cached with. The cache is emptied on start.
+ */
+class DiskCacheMgr : public AbstractBufferMgr {
+ public:
+  DiskCacheMgr(const int deviceId,
+               const std::string& cachePath,
+               const size_t maxSize,
+               AbstractBufferMgr* parentMgr);
+
+  virtual ~DiskCacheMgr();
+
+  virtual AbstractBuffer* createBuffer(const ChunkKey& key,
+                                       const size_t pageSize = 0,
+                                       const size_t numBytes = 0) {
+    return parentMgr_->createBuffer(key, pageSize, numBytes);
+  }
+
+  virtual void deleteBuffer(const ChunkKey& key, const bool purge = true);
+  virtual void deleteBuffersWithPrefix(const ChunkKey& keyPrefix,
+                                       const bool purge = true);
+
+  virtual AbstractBuffer* getBuffer(const ChunkKey& key, const size_t numBytes = 0) {
+    return parentMgr_->getBuffer(key, numBytes);
+  }
+
+  /// Reads the chunk from the cache if it holds a current copy, else from the parent,
+  /// caching what was read.
+  virtual void fetchBuffer(const ChunkKey& key,
+                           AbstractBuffer* destBuffer,
+                           const size_t numBytes = 0);
+
+  virtual AbstractBuffer* putBuffer(const ChunkKey& key,
+                                    AbstractBuffer* srcBuffer,
+                                    const size_t numBytes = 0);
+
+  virtual void getChunkMetadataVec(
+      std::vector<std::pair<ChunkKey, ChunkMetadata>>& chunkMetadataVec) {
+    parentMgr_->getChunkMetadataVec(chunkMetadataVec);
+  }
+  virtual void getChunkMetadataVecForKeyPrefix(
+      std::vector<std::pair<ChunkKey, ChunkMetadata>>& chunkMetadataVec,
+      const ChunkKey& keyPrefix) {
+    parentMgr_->getChunkMetadataVecForKeyPrefix(chunkMetadataVec, keyPrefix);
+  }
+
+  virtual bool isBufferOnDevice(const ChunkKey& key);
+  virtual std::string printSlabs();
+  virtual void clearSlabs();
+  virtual size_t getMaxSize() { return maxSize_; }
+  virtual size_t getInUseSize();
+  virtual size_t getAllocated() { return getInUseSize(); }
+  virtual bool isAllocationCapped() { return false; }
+
+  virtual void checkpoint() { parentMgr_->checkpoint(); }
+  virtual void checkpoint(const int db_id, const int tb_id) {
+    parentMgr_->checkpoint(db_id, tb_id);
+  }
+
+  // Buffer API
+  virtual AbstractBuffer* alloc(const size_t numBytes = 0) {
+    LOG(FATAL) << "Operation not supported";
+    return nullptr;
+  }
+  virtual void free(AbstractBuffer* buffer) { LOG(FATAL) << "Operation not supported"; }
+
+  virtual inline MgrType getMgrType() { return DISK_CACHE_MGR; }
+  virtual inline std::string getStringMgrType() { return ToString(DISK_CACHE_MGR); }
+  virtual size_t getNumChunks();
+
+  /// Drops the cached copies of the chunks with the given key prefix, for changes made
+  /// to them directly in the parent, such as rolling a table back to an earlier epoch.
+  void invalidateChunksWithPrefix(const ChunkKey& keyPrefix);
+
+  size_t getNumHits() const { return numHits_; }
+  size_t getNumMisses() const { return numMisses_; }
+
+ private:
+  struct CachedChunk {
+    size_t numBytes;   // bytes of the chunk held in the cache file
+    size_t chunkSize;  // size of the chunk in the parent when it was cached
+    int epoch;         // latest page epoch of the chunk when it was cached
+    std::list<ChunkKey>::iterator lruIt;
+  };
+  typedef std::map<ChunkKey, CachedChunk> CachedChunkMap;
+
+  std::string getChunkPath(const ChunkKey& key) const;
+  bool readCachedChunk(const ChunkKey& key,
+                       const AbstractBuffer* chunk,
+                       AbstractBuffer* destBuffer,
+                       const size_t chunkSize);
+  void cacheChunk(const ChunkKey& key,
+                  const AbstractBuffer* chunk,
+                  const int epoch,
+                  AbstractBuffer* srcBuffer);
+  void dropChunk(CachedChunkMap::iterator chunkIt, const bool removeFile = true);
+
+  std::string cachePath_;
+  size_t maxSize_;
+  size_t inUseSize_;
+  CachedChunkMap cachedChunks_;
+  std::list<ChunkKey> lru_;  // least recently used first
+  std::mutex cacheMutex_;
+  std::atomic<size_t> numHits_;
+  std::atomic<size_t> numMisses_;
+  std::atomic<size_t> numTempFiles_;
+};
+
+}  // namespace File_Namespace
+
+#endif  // DATAMGR_MEMORY_FILE_DISKCACHEMGR_H
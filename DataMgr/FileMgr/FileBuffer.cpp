@@ -22,10 +22,13 @@
 
 #include "FileBuffer.h"
 #include <glog/logging.h>
+#include <algorithm>
 #include <future>
 #include <map>
+#include <limits>
 #include <thread>
 #include "../../Shared/File.h"
+#include "../EncoderKernels.h"
 #include "FileMgr.h"
 
 #define METADATA_PAGE_SIZE 4096
@@ -35,6 +38,155 @@ using namespace std;
 namespace File_Namespace {
 size_t FileBuffer::headerBufferOffset_ = 32;
 
+namespace {
+
+// Returns the width of the elements of types whose chunks may be stored narrower, or 0.
+// All of them keep their elements as signed integers, with the smallest one for null.
+size_t narrowable_elem_size(const SQLTypeInfo& ti) {
+  const auto elem_size = ti.get_size();
+  if (ti.is_string()) {
+    // dictionary ids narrower than 32 bits are unsigned
+    return ti.get_compression() == kENCODING_DICT && elem_size == 4 ? elem_size : 0;
+  }
+  if (!ti.is_integer() && !ti.is_decimal() && !ti.is_time()) {
+    return 0;
+  }
+  return elem_size == 2 || elem_size == 4 || elem_size == 8 ? elem_size : 0;
+}
+
+// Range of the non-null elements about to be stored.
+struct ElemRange {
+  int64_t min;
+  int64_t max;
+  bool nullsOnly;
+};
+
+template <typename T>
+ElemRange get_elem_range(const T* elems, const size_t numElems) {
+  const auto stats = EncoderKernels::compute_append_stats<T, T>(
+      elems, numElems, std::numeric_limits<T>::min());
+  return {stats.min, stats.max, stats.min > stats.max};
+}
+
+ElemRange get_elem_range(const int8_t* elems,
+                         const size_t elemSize,
+                         const size_t numElems) {
+  switch (elemSize) {
+    case 2:
+      return get_elem_range(reinterpret_cast<const int16_t*>(elems), numElems);
+    case 4:
+      return get_elem_range(reinterpret_cast<const int32_t*>(elems), numElems);
+    case 8:
+      return get_elem_range(reinterpret_cast<const int64_t*>(elems), numElems);
+    default:
+      CHECK(false);
+  }
+  return {0, 0, true};
+}
+
+// Returns whether value - base lies strictly between -bound and bound.
+bool offset_fits(const int64_t value, const int64_t base, const uint64_t bound) {
+  return value >= base
+             ? static_cast<uint64_t>(value) - static_cast<uint64_t>(base) < bound
+             : static_cast<uint64_t>(base) - static_cast<uint64_t>(value) < bound;
+}
+
+// Returns the narrowest width the offsets of the range from base fit in, the smallest
+// value of the width standing for null, or elemSize if none narrower does.
+size_t required_elem_size(const ElemRange& range,
+                          const int64_t base,
+                          const size_t elemSize) {
+  if (range.nullsOnly) {
+    return 1;
+  }
+  for (size_t width = 1; width < elemSize; width *= 2) {
+    const uint64_t bound = uint64_t(1) << (8 * width - 1);
+    if (offset_fits(range.min, base, bound) && offset_fits(range.max, base, bound)) {
+      return width;
+    }
+  }
+  return elemSize;
+}
+
+int64_t get_midpoint(const ElemRange& range) {
+  if (range.nullsOnly) {
+    return 0;
+  }
+  return range.min + static_cast<int64_t>((static_cast<uint64_t>(range.max) -
+                                           static_cast<uint64_t>(range.min)) /
+                                          2);
+}
+
+template <typename SRC, typename DST>
+void convert_elems(const int8_t* src,
+                   int8_t* dst,
+                   const size_t numElems,
+                   const int64_t srcBase,
+                   const int64_t dstBase) {
+  const auto srcElems = reinterpret_cast<const SRC*>(src);
+  auto dstElems = reinterpret_cast<DST*>(dst);
+  // the results fit DST, so wrapping around on the way there is fine
+  const uint64_t delta = static_cast<uint64_t>(srcBase) - static_cast<uint64_t>(dstBase);
+  for (size_t i = 0; i < numElems; ++i) {
+    dstElems[i] = srcElems[i] == std::numeric_limits<SRC>::min()
+                      ? std::numeric_limits<DST>::min()
+                      : static_cast<DST>(static_cast<uint64_t>(srcElems[i]) + delta);
+  }
+}
+
+template <typename SRC>
+void convert_elems(const int8_t* src,
+                   int8_t* dst,
+                   const size_t dstElemSize,
+                   const size_t numElems,
+                   const int64_t srcBase,
+                   const int64_t dstBase) {
+  switch (dstElemSize) {
+    case 1:
+      convert_elems<SRC, int8_t>(src, dst, numElems, srcBase, dstBase);
+      break;
+    case 2:
+      convert_elems<SRC, int16_t>(src, dst, numElems, srcBase, dstBase);
+      break;
+    case 4:
+      convert_elems<SRC, int32_t>(src, dst, numElems, srcBase, dstBase);
+      break;
+    case 8:
+      convert_elems<SRC, int64_t>(src, dst, numElems, srcBase, dstBase);
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+// Converts elements between widths and frames of reference, mapping null to null.
+void convert_elems(const int8_t* src,
+                   const size_t srcElemSize,
+                   const int64_t srcBase,
+                   int8_t* dst,
+                   const size_t dstElemSize,
+                   const int64_t dstBase,
+                   const size_t numElems) {
+  switch (srcElemSize) {
+    case 1:
+      convert_elems<int8_t>(src, dst, dstElemSize, numElems, srcBase, dstBase);
+      break;
+    case 2:
+      convert_elems<int16_t>(src, dst, dstElemSize, numElems, srcBase, dstBase);
+      break;
+    case 4:
+      convert_elems<int32_t>(src, dst, dstElemSize, numElems, srcBase, dstBase);
+      break;
+    case 8:
+      convert_elems<int64_t>(src, dst, dstElemSize, numElems, srcBase, dstBase);
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+}  // namespace
+
 FileBuffer::FileBuffer(FileMgr* fm,
                        const size_t pageSize,
                        const ChunkKey& chunkKey,
@@ -43,7 +195,9 @@ FileBuffer::FileBuffer(FileMgr* fm,
     , fm_(fm)
     , metadataPages_(METADATA_PAGE_SIZE)
     , pageSize_(pageSize)
-    , chunkKey_(chunkKey) {
+    , chunkKey_(chunkKey)
+    , storedElemSize_(0)
+    , storedElemBase_(0) {
   // Create a new FileBuffer
   CHECK(fm_);
   calcHeaderBuffer();
@@ -72,7 +226,9 @@ FileBuffer::FileBuffer(FileMgr* fm,
     , fm_(fm)
     , metadataPages_(METADATA_PAGE_SIZE)
     , pageSize_(pageSize)
-    , chunkKey_(chunkKey) {
+    , chunkKey_(chunkKey)
+    , storedElemSize_(0)
+    , storedElemBase_(0) {
   CHECK(fm_);
   calcHeaderBuffer();
   pageDataSize_ = pageSize_ - reservedHeaderSize_;
@@ -86,7 +242,9 @@ FileBuffer::FileBuffer(FileMgr* fm,
     , fm_(fm)
     , metadataPages_(METADATA_PAGE_SIZE)
     , pageSize_(0)
-    , chunkKey_(chunkKey) {
+    , chunkKey_(chunkKey)
+    , storedElemSize_(0)
+    , storedElemBase_(0) {
   // We are being assigned an existing FileBuffer on disk
 
   CHECK(fm_);
@@ -137,10 +295,22 @@ FileBuffer::~FileBuffer() {
 }
 
 void FileBuffer::reserve(const size_t numBytes) {
-  size_t numPagesRequested = (numBytes + pageSize_ - 1) / pageSize_;
+  size_t storedBytes = numBytes;
+  {
+    mapd_shared_lock<mapd_shared_mutex> storedElemSizeLock(storedElemSizeMutex_);
+    if (storedElemSize_) {
+      // narrowed chunks take fewer pages than their logical size
+      const size_t elemSize = sqlType.get_size();
+      storedBytes = (numBytes + elemSize - 1) / elemSize * storedElemSize_;
+    }
+  }
+  size_t numPagesRequested = (storedBytes + pageSize_ - 1) / pageSize_;
   size_t numCurrentPages = multiPages_.size();
   int epoch = fm_->epoch();
 
+  if (numPagesRequested > numCurrentPages) {
+    reservePageRun(numPagesRequested - numCurrentPages);
+  }
   for (size_t pageNum = numCurrentPages; pageNum < numPagesRequested; ++pageNum) {
     Page page = addNewMultiPage(epoch);
     writeHeader(page, pageNum, epoch);
@@ -180,6 +350,17 @@ void FileBuffer::freePages() {
       fileInfo->freePage(pageIt->pageNum);
     }
   }
+  freeReservedPages();
+}
+
+int FileBuffer::latestEpoch() const {
+  int epoch = -1;
+  for (const auto& multiPage : multiPages_) {
+    if (!multiPage.epochs.empty()) {
+      epoch = std::max(epoch, multiPage.epochs.back());
+    }
+  }
+  return epoch;
 }
 
 struct readThreadDS {
@@ -242,7 +423,32 @@ void FileBuffer::read(int8_t* const dst,
   if (dstBufferType != CPU_LEVEL) {
     LOG(FATAL) << "Unsupported Buffer type";
   }
+  mapd_shared_lock<mapd_shared_mutex> storedElemSizeLock(storedElemSizeMutex_);
+  if (!storedElemSize_) {
+    readPages(dst, numBytes, offset);
+    return;
+  }
+  const size_t elemSize = sqlType.get_size();
+  CHECK_EQ(offset % elemSize, size_t(0));
+  CHECK_EQ(numBytes % elemSize, size_t(0));
+  const size_t numElems = numBytes / elemSize;
+  if (numElems == 0) {
+    return;
+  }
+  std::vector<int8_t> storedElems(numElems * storedElemSize_);
+  readPages(storedElems.data(), storedElems.size(), offset / elemSize * storedElemSize_);
+  convert_elems(storedElems.data(),
+                storedElemSize_,
+                storedElemBase_,
+                dst,
+                elemSize,
+                0,
+                numElems);
+}
 
+void FileBuffer::readPages(int8_t* const dst,
+                           const size_t numBytes,
+                           const size_t offset) {
   // variable declarations
   size_t startPage = offset / pageDataSize_;
   size_t startPageOffset = offset % pageDataSize_;
@@ -358,7 +564,13 @@ void FileBuffer::copyPage(Page& srcPage,
 }
 
 Page FileBuffer::addNewMultiPage(const int epoch) {
-  Page page = fm_->requestFreePage(pageSize_, false);
+  Page page;
+  if (!reservedPages_.empty()) {
+    page = reservedPages_.front();
+    reservedPages_.pop_front();
+  } else {
+    page = fm_->requestFreePage(pageSize_, false);
+  }
   MultiPage multiPage(pageSize_);
   multiPage.epochs.push_back(epoch);
   multiPage.pageVersions.push_back(page);
@@ -394,7 +606,20 @@ void FileBuffer::readMetadata(const Page& page) {
                                        // encodingType, encodingBits all as int
   fread((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
   int version = typeData[0];
-  CHECK(version == METADATA_VERSION);  // add backward compatibility code here
+  CHECK(version == METADATA_VERSION || version == METADATA_VERSION_STORED_ELEM_SIZE ||
+        version == METADATA_VERSION_STORED_ELEM_BASE);  // add backward compatibility
+                                                        // code here
+  storedElemSize_ = 0;
+  storedElemBase_ = 0;
+  if (version == METADATA_VERSION_STORED_ELEM_SIZE ||
+      version == METADATA_VERSION_STORED_ELEM_BASE) {
+    int storedElemSize{0};
+    fread((int8_t*)&storedElemSize, sizeof(int), 1, f);
+    storedElemSize_ = storedElemSize;
+  }
+  if (version == METADATA_VERSION_STORED_ELEM_BASE) {
+    fread((int8_t*)&storedElemBase_, sizeof(int64_t), 1, f);
+  }
   hasEncoder = static_cast<bool>(typeData[1]);
   if (hasEncoder) {
     sqlType.set_type(static_cast<SQLTypes>(typeData[2]));
@@ -421,7 +646,8 @@ void FileBuffer::writeMetadata(const int epoch) {
   fwrite((int8_t*)&size_, sizeof(size_t), 1, f);
   vector<int> typeData(NUM_METADATA);  // assumes we will encode hasEncoder, bufferType,
                                        // encodingType, encodingBits all as int
-  typeData[0] = METADATA_VERSION;
+  // chunks stored at full width keep the original format
+  typeData[0] = storedElemSize_ ? METADATA_VERSION_STORED_ELEM_BASE : METADATA_VERSION;
   typeData[1] = static_cast<int>(hasEncoder);
   if (hasEncoder) {
     typeData[2] = static_cast<int>(sqlType.get_type());
@@ -434,6 +660,11 @@ void FileBuffer::writeMetadata(const int epoch) {
     typeData[9] = sqlType.get_size();
   }
   fwrite((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
+  if (storedElemSize_) {
+    const int storedElemSize = storedElemSize_;
+    fwrite((int8_t*)&storedElemSize, sizeof(int), 1, f);
+    fwrite((int8_t*)&storedElemBase_, sizeof(int64_t), 1, f);
+  }
   if (hasEncoder) {  // redundant
     encoder->writeMetadata(f);
   }
@@ -457,18 +688,37 @@ void FileBuffer::append(int8_t* src,
                         const size_t numBytes,
                         const MemoryLevel srcBufferType,
                         const int deviceId) {
+  mapd_unique_lock<mapd_shared_mutex> storedElemSizeLock(storedElemSizeMutex_);
+  adaptStoredElemSize(src, numBytes, size_);
   isDirty_ = true;
   isAppended_ = true;
+  if (!storedElemSize_) {
+    appendPages(src, numBytes, size_);
+    size_ += numBytes;
+    return;
+  }
+  const size_t elemSize = sqlType.get_size();
+  const size_t numElems = numBytes / elemSize;
+  std::vector<int8_t> storedElems(numElems * storedElemSize_);
+  convert_elems(
+      src, elemSize, 0, storedElems.data(), storedElemSize_, storedElemBase_, numElems);
+  appendPages(
+      storedElems.data(), storedElems.size(), size_ / elemSize * storedElemSize_);
+  size_ += numBytes;
+}
 
-  size_t startPage = size_ / pageDataSize_;
-  size_t startPageOffset = size_ % pageDataSize_;
+void FileBuffer::appendPages(int8_t* src, const size_t numBytes, const size_t offset) {
+  size_t startPage = offset / pageDataSize_;
+  size_t startPageOffset = offset % pageDataSize_;
   size_t numPagesToWrite =
       (numBytes + startPageOffset + pageDataSize_ - 1) / pageDataSize_;
   size_t bytesLeft = numBytes;
   int8_t* curPtr = src;  // a pointer to the current location in dst being written to
   size_t initialNumPages = multiPages_.size();
-  size_ = size_ + numBytes;
   int epoch = fm_->epoch();
+  if (startPage + numPagesToWrite > initialNumPages) {
+    reservePageRun(startPage + numPagesToWrite - initialNumPages);
+  }
   for (size_t pageNum = startPage; pageNum < startPage + numPagesToWrite; ++pageNum) {
     Page page;
     if (pageNum >= initialNumPages) {
@@ -506,6 +756,8 @@ void FileBuffer::write(int8_t* src,
   if (srcBufferType != CPU_LEVEL) {
     LOG(FATAL) << "Unsupported Buffer type";
   }
+  mapd_unique_lock<mapd_shared_mutex> storedElemSizeLock(storedElemSizeMutex_);
+  adaptStoredElemSize(src, numBytes, offset);
   isDirty_ = true;
   if (offset < size_) {
     isUpdated_ = true;
@@ -518,7 +770,25 @@ void FileBuffer::write(int8_t* src,
     isAppended_ = true;
     size_ = offset + numBytes;
   }
+  if (!storedElemSize_) {
+    writePages(src, numBytes, offset, tempIsAppended);
+    return;
+  }
+  const size_t elemSize = sqlType.get_size();
+  const size_t numElems = numBytes / elemSize;
+  std::vector<int8_t> storedElems(numElems * storedElemSize_);
+  convert_elems(
+      src, elemSize, 0, storedElems.data(), storedElemSize_, storedElemBase_, numElems);
+  writePages(storedElems.data(),
+             storedElems.size(),
+             offset / elemSize * storedElemSize_,
+             tempIsAppended);
+}
 
+void FileBuffer::writePages(int8_t* src,
+                            const size_t numBytes,
+                            const size_t offset,
+                            const bool isAppend) {
   size_t startPage = offset / pageDataSize_;
   size_t startPageOffset = offset % pageDataSize_;
   size_t numPagesToWrite =
@@ -528,6 +798,9 @@ void FileBuffer::write(int8_t* src,
   size_t initialNumPages = multiPages_.size();
   int epoch = fm_->epoch();
 
+  if (startPage + numPagesToWrite > initialNumPages) {
+    reservePageRun(startPage + numPagesToWrite - initialNumPages);
+  }
   if (startPage >
       initialNumPages) {  // means there is a gap we need to allocate pages for
     for (size_t pageNum = initialNumPages; pageNum < startPage; ++pageNum) {
@@ -582,7 +855,7 @@ void FileBuffer::write(int8_t* src,
     }
     curPtr += bytesWritten;
     bytesLeft -= bytesWritten;
-    if (tempIsAppended && pageNum == startPage + numPagesToWrite - 1) {  // if last page
+    if (isAppend && pageNum == startPage + numPagesToWrite - 1) {  // if last page
       //@todo below can lead to undefined - we're overwriting num
       // bytes valid at checkpoint
       writeHeader(page, 0, multiPages_[0].epochs.back(), true);
@@ -591,4 +864,139 @@ void FileBuffer::write(int8_t* src,
   CHECK(bytesLeft == 0);
 }
 
+size_t FileBuffer::pageRunCount() const {
+  mapd_shared_lock<mapd_shared_mutex> storedElemSizeLock(storedElemSizeMutex_);
+  return countPageRuns();
+}
+
+size_t FileBuffer::countPageRuns() const {
+  size_t numPageRuns = 0;
+  Page prevPage;
+  for (const auto& multiPage : multiPages_) {
+    const Page page = multiPage.current();
+    if (page.fileId != prevPage.fileId || page.pageNum != prevPage.pageNum + 1) {
+      ++numPageRuns;
+    }
+    prevPage = page;
+  }
+  return numPageRuns;
+}
+
+void FileBuffer::reservePageRun(const size_t numNewPages) {
+  const size_t growthPages = fm_->getChunkGrowthPages();
+  if (!growthPages || numNewPages <= reservedPages_.size()) {
+    return;
+  }
+  Page prevPage;
+  if (!reservedPages_.empty()) {
+    prevPage = reservedPages_.back();
+  } else if (!multiPages_.empty()) {
+    prevPage = multiPages_.back().current();
+  }
+  std::vector<Page> pages;
+  fm_->requestFreePageRun(
+      pageSize_, numNewPages - reservedPages_.size() + growthPages, prevPage, pages);
+  reservedPages_.insert(reservedPages_.end(), pages.begin(), pages.end());
+}
+
+void FileBuffer::freeReservedPages() {
+  // never written to, so they can be reused right away
+  for (const auto& page : reservedPages_) {
+    fm_->getFileInfoForFileId(page.fileId)->freePageDeferred(page.pageNum);
+  }
+  reservedPages_.clear();
+}
+
+bool FileBuffer::relocatePages() {
+  mapd_unique_lock<mapd_shared_mutex> storedElemSizeLock(storedElemSizeMutex_);
+  // every version of a clean buffer predates the epoch, so a restart before the next
+  // checkpoint drops the moved pages and recovers the freed ones
+  if (isDirty_ || countPageRuns() < 2) {
+    return false;
+  }
+  freeReservedPages();
+  std::vector<Page> pages;
+  fm_->requestFreePageRun(pageSize_, multiPages_.size(), Page(), pages);
+  const int epoch = fm_->epoch();
+  std::vector<int8_t> pageData(pageDataSize_);
+  for (size_t pageNum = 0; pageNum < multiPages_.size(); ++pageNum) {
+    auto& multiPage = multiPages_[pageNum];
+    const Page srcPage = multiPage.current();
+    Page& destPage = pages[pageNum];
+    size_t bytesRead = fm_->getFileInfoForFileId(srcPage.fileId)
+                           ->read(srcPage.pageNum * pageSize_ + reservedHeaderSize_,
+                                  pageDataSize_,
+                                  pageData.data());
+    CHECK(bytesRead == pageDataSize_);
+    size_t bytesWritten = fm_->getFileInfoForFileId(destPage.fileId)
+                              ->write(destPage.pageNum * pageSize_ + reservedHeaderSize_,
+                                      pageDataSize_,
+                                      pageData.data());
+    CHECK(bytesWritten == pageDataSize_);
+    writeHeader(destPage, pageNum, epoch);
+    for (const auto& page : multiPage.pageVersions) {
+      fm_->getFileInfoForFileId(page.fileId)->freePage(page.pageNum);
+    }
+    multiPage.pageVersions.clear();
+    multiPage.epochs.clear();
+    multiPage.push(destPage, epoch);
+  }
+  return true;
+}
+
+void FileBuffer::adaptStoredElemSize(const int8_t* src,
+                                     const size_t numBytes,
+                                     const size_t offset) {
+  const size_t elemSize = hasEncoder ? narrowable_elem_size(sqlType) : 0;
+  if (!elemSize || numBytes == 0) {
+    return;
+  }
+  const bool firstElems = size_ == 0 && fm_->getNarrowChunks();
+  if (!storedElemSize_ && !firstElems) {
+    return;  // stored at full width for good
+  }
+  CHECK_EQ(offset % elemSize, size_t(0));
+  CHECK_EQ(numBytes % elemSize, size_t(0));
+  const auto range = get_elem_range(src, elemSize, numBytes / elemSize);
+  if (firstElems) {
+    // centered on the first elements, to leave room on both sides for the next ones
+    storedElemBase_ = get_midpoint(range);
+    storedElemSize_ = required_elem_size(range, storedElemBase_, elemSize);
+    if (storedElemSize_ == elemSize) {
+      storedElemSize_ = 0;
+      storedElemBase_ = 0;
+    }
+    return;
+  }
+  const auto requiredElemSize = required_elem_size(range, storedElemBase_, elemSize);
+  if (requiredElemSize > storedElemSize_) {
+    rewriteStoredElems(requiredElemSize < elemSize ? requiredElemSize : 0);
+  }
+}
+
+void FileBuffer::rewriteStoredElems(const size_t storedElemSize) {
+  const size_t elemSize = sqlType.get_size();
+  const size_t numElems = size_ / elemSize;
+  // full width elements are stored as they are
+  const size_t newElemSize = storedElemSize ? storedElemSize : elemSize;
+  const int64_t newElemBase = storedElemSize ? storedElemBase_ : 0;
+  VLOG(1) << "Rewriting the " << numElems << " elements of chunk " << showChunk(chunkKey_)
+          << " from " << storedElemSize_ << " to " << newElemSize << " bytes wide";
+  std::vector<int8_t> oldElems(numElems * storedElemSize_);
+  readPages(oldElems.data(), oldElems.size(), 0);
+  std::vector<int8_t> newElems(numElems * newElemSize);
+  convert_elems(oldElems.data(),
+                storedElemSize_,
+                storedElemBase_,
+                newElems.data(),
+                newElemSize,
+                newElemBase,
+                numElems);
+  // the logical size doesn't change, so there's no new size to record in the headers
+  writePages(newElems.data(), newElems.size(), 0, false);
+  storedElemSize_ = storedElemSize;
+  storedElemBase_ = newElemBase;
+  isDirty_ = true;
+}
+
 }  // namespace File_Namespace
@@ -23,9 +23,11 @@
 #ifndef DATAMGR_MEMORY_FILE_FILEBUFFER_H
 #define DATAMGR_MEMORY_FILE_FILEBUFFER_H
 
+#include "../../Shared/mapd_shared_mutex.h"
 #include "../AbstractBuffer.h"
 #include "Page.h"
 
+#include <deque>
 #include <iostream>
 #include <stdexcept>
 
@@ -33,6 +35,8 @@ using namespace Data_Namespace;
 
 #define NUM_METADATA 10
 #define METADATA_VERSION 0
+#define METADATA_VERSION_STORED_ELEM_SIZE 1  // followed by the stored element size
+#define METADATA_VERSION_STORED_ELEM_BASE 2  // and by the stored elements' base too
 
 namespace File_Namespace {
 
@@ -49,6 +53,11 @@ class FileMgr;  // forward declaration
  *
  * Note that a "Chunk" is brought into a FileBuffer by the FileMgr.
  *
+ * Chunks of integer-like fixed width types may be stored in the pages narrower than
+ * their type, as offsets from a base value of the chunk (see storedElemSize()). read(),
+ * write() and append() still work on the elements at the width of the type, converting
+ * to and from the stored elements, so the narrowing is only visible on disk.
+ *
  * Note(s): Forbid Copying Idiom 4.1
  */
 class FileBuffer : public AbstractBuffer {
@@ -77,12 +86,26 @@ class FileBuffer : public AbstractBuffer {
   /// Destructor
   virtual ~FileBuffer();
 
+  /// Adds a logical page, placed in the pages reserved for the buffer to grow into if
+  /// there are any left.
   Page addNewMultiPage(const int epoch);
 
   void reserve(const size_t numBytes);
 
   void freePages();
 
+  /// Returns the most recent epoch any page of the buffer was written in, or -1 if it
+  /// has no pages. Once checkpointed, writes to the buffer always advance it.
+  int latestEpoch() const;
+
+  /// Returns the width in bytes the elements are stored in, if it's narrower than the
+  /// width of the buffer's type, else 0. Appending values which don't fit the stored
+  /// width rewrites the buffer wider, so it never shrinks back.
+  size_t storedElemSize() const { return storedElemSize_; }
+
+  /// Returns the value the elements stored narrower are offsets from.
+  int64_t storedElemBase() const { return storedElemBase_; }
+
   virtual void read(int8_t* const dst,
                     const size_t numBytes = 0,
                     const size_t offset = 0,
@@ -119,6 +142,10 @@ class FileBuffer : public AbstractBuffer {
   /// Returns the number of pages in the FileBuffer.
   inline virtual size_t pageCount() const { return multiPages_.size(); }
 
+  /// Returns the number of runs of pages directly following each other in one file the
+  /// current versions of the pages form; 1 if the buffer is contiguous on disk.
+  size_t pageRunCount() const;
+
   /// Returns the size in bytes of each page in the FileBuffer.
   inline virtual size_t pageSize() const { return pageSize_; }
 
@@ -160,15 +187,41 @@ class FileBuffer : public AbstractBuffer {
   void readMetadata(const Page& page);
   void calcHeaderBuffer();
 
+  // page level I/O, with offsets and sizes in stored bytes
+  void readPages(int8_t* const dst, const size_t numBytes, const size_t offset);
+  void writePages(int8_t* src,
+                  const size_t numBytes,
+                  const size_t offset,
+                  const bool isAppend);
+  void appendPages(int8_t* src, const size_t numBytes, const size_t offset);
+
+  // Picks the stored element size for the elements about to be written to offset, and
+  // rewrites the buffer wider if they don't fit the current one.
+  void adaptStoredElemSize(const int8_t* src, const size_t numBytes, const size_t offset);
+  void rewriteStoredElems(const size_t storedElemSize);
+
+  // Sets aside enough pages for the buffer to grow by numNewPages, plus those the
+  // FileMgr takes along for later growth, in a run continuing the buffer's last page.
+  void reservePageRun(const size_t numNewPages);
+  void freeReservedPages();
+  // Moves the current versions of the pages into a single run (see
+  // FileMgr::compactChunks()), returns false if they already are or the buffer is dirty.
+  bool relocatePages();
+  size_t countPageRuns() const;
+
   FileMgr* fm_;  // a reference to FileMgr is needed for writing to new pages in available
                  // files
   static size_t headerBufferOffset_;
   MultiPage metadataPages_;
   std::vector<MultiPage> multiPages_;
+  std::deque<Page> reservedPages_;  // free pages set aside to grow into, in order
   size_t pageSize_;
   size_t pageDataSize_;
   size_t reservedHeaderSize_;  // lets make this a constant now for simplicity - 128 bytes
   ChunkKey chunkKey_;
+  size_t storedElemSize_;
+  int64_t storedElemBase_;
+  mutable mapd_shared_mutex storedElemSizeMutex_;  // held exclusively while it can change
 };
 
 }  // namespace File_Namespace
@@ -21,6 +21,7 @@
 #include "FileMgr.h"
 #include "Page.h"
 
+#include <iterator>
 #include <utility>
 using namespace std;
 
@@ -236,6 +237,30 @@ int FileInfo::getFreePage() {
   return pageNum;
 }
 
+int FileInfo::getFreePageRun(const size_t numPages, const int startPage) {
+  CHECK_GT(numPages, size_t(0));
+  std::lock_guard<std::mutex> lock(freePagesMutex_);
+  auto runIt = freePages.end();
+  size_t runLength = 0;
+  for (auto pageIt = startPage >= 0 ? freePages.find(startPage) : freePages.begin();
+       pageIt != freePages.end();
+       ++pageIt) {
+    if (runLength == 0 || *pageIt != *runIt + runLength) {
+      if (runLength > 0 && startPage >= 0) {
+        break;  // the pages from startPage on aren't free for long enough
+      }
+      runIt = pageIt;
+      runLength = 0;
+    }
+    if (++runLength == numPages) {
+      const int pageNum = *runIt;
+      freePages.erase(runIt, std::next(pageIt));
+      return pageNum;
+    }
+  }
+  return -1;
+}
+
 void FileInfo::print(bool pagesummary) {
   std::cout << "File: " << fileId << std::endl;
   std::cout << "Size: " << size() << std::endl;
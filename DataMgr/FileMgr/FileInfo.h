@@ -78,6 +78,9 @@ struct FileInfo {
   void freePageDeferred(int pageId);
   void freePage(int pageId);
   int getFreePage();
+  /// Takes numPages free pages following each other, starting at startPage if given
+  /// (else the lowest such run) and returns the first, or -1 if there is no such run.
+  int getFreePageRun(const size_t numPages, const int startPage = -1);
   size_t write(const size_t offset, const size_t size, int8_t* buf);
   size_t read(const size_t offset, const size_t size, int8_t* buf);
 
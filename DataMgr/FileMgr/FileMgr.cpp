@@ -21,6 +21,7 @@
  */
 
 #include "FileMgr.h"
+#include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/system/error_code.hpp>
@@ -30,8 +31,12 @@
 #include "Shared/measure.h"
 
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <future>
 #include <thread>
 #include <utility>
@@ -39,6 +44,8 @@
 
 #define EPOCH_FILENAME "epoch"
 #define DB_META_FILENAME "dbmeta"
+#define CHUNK_EXTENT_DIRNAME "chunk_extents"
+#define CHUNK_EXTENT_EXT ".extent"
 
 using namespace std;
 
@@ -256,6 +263,7 @@ void FileMgr::init(const size_t num_reader_threads) {
     }
     nextFileId_ = maxFileId + 1;
     // std::cout << "next file id: " << nextFileId_ << std::endl;
+    openChunkExtents();
   } else {
     if (!boost::filesystem::create_directory(path)) {
       LOG(FATAL) << "Could not create data directory: " << path;
@@ -582,6 +590,10 @@ void FileMgr::checkpoint() {
     }
     cout << "Is dirty: " << chunkIt->second->isDirty_ << endl;
     */
+    if (!chunkIt->second->isAppended_) {
+      // pages set aside for a chunk which stopped growing go back to the others
+      chunkIt->second->freeReservedPages();
+    }
     if (chunkIt->second->isDirty_) {
       chunkIt->second->writeMetadata(epoch_);
       chunkIt->second->clearDirtyBits();
@@ -604,6 +616,9 @@ void FileMgr::checkpoint() {
     free_page.first->freePageDeferred(free_page.second);
   }
   free_pages.clear();
+  freePagesWriteLock.unlock();
+
+  writeChunkExtents();
 }
 
 AbstractBuffer* FileMgr::createBuffer(const ChunkKey& key,
@@ -642,10 +657,13 @@ void FileMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
   // chunkIt->second->writeMetadata(-1); // writes -1 as epoch - signifies deleted
   if (purge) {
     chunkIt->second->freePages();
+  } else {
+    chunkIt->second->freeReservedPages();
   }
   //@todo need a way to represent delete in non purge case
   delete chunkIt->second;
   chunkIndex_.erase(chunkIt);
+  removeChunkExtent(key);
 }
 
 void FileMgr::deleteBuffersWithPrefix(const ChunkKey& keyPrefix, const bool purge) {
@@ -668,9 +686,12 @@ void FileMgr::deleteBuffersWithPrefix(const ChunkKey& keyPrefix, const bool purg
     */
     if (purge) {
       chunkIt->second->freePages();
+    } else {
+      chunkIt->second->freeReservedPages();
     }
     //@todo need a way to represent delete in non purge case
     delete chunkIt->second;
+    removeChunkExtent(chunkIt->first);
     chunkIndex_.erase(chunkIt++);
   }
 }
@@ -742,6 +763,11 @@ AbstractBuffer* FileMgr::putBuffer(const ChunkKey& key,
     chunk = chunkIt->second;
   }
   chunkIndexWriteLock.unlock();
+  if (srcBuffer->hasEncoder && !chunk->hasEncoder) {
+    // the chunk's type decides whether its elements can be stored narrower, so it
+    // has to be known before the first append
+    chunk->initEncoder(srcBuffer->sqlType);
+  }
   size_t oldChunkSize = chunk->size();
   // write the buffer's data to the Chunk
   // size_t newChunkSize = numBytes == 0 ? srcBuffer->size() : numBytes;
@@ -778,6 +804,184 @@ AbstractBuffer* FileMgr::putBuffer(const ChunkKey& key,
   return chunk;
 }
 
+bool FileMgr::getNarrowChunks() const {
+  return gfm_ && gfm_->getNarrowChunks();
+}
+
+size_t FileMgr::getChunkGrowthPages() const {
+  return gfm_ ? gfm_->getChunkGrowthPages() : 0;
+}
+
+bool FileMgr::getMmapChunks() const {
+  return gfm_ && gfm_->getMmapChunks(fileMgrKey_.first, fileMgrKey_.second);
+}
+
+std::string FileMgr::getChunkExtentPath(const ChunkKey& key) const {
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  auto chunkIt = chunkIndex_.find(key);
+  if (chunkIt == chunkIndex_.end()) {
+    return "";
+  }
+  const auto chunk = chunkIt->second;
+  std::lock_guard<std::mutex> chunkExtentsLock(chunkExtentsMutex_);
+  auto extentIt = chunkExtents_.find(key);
+  if (extentIt == chunkExtents_.end() || chunk->isDirty() ||
+      extentIt->second.numBytes != chunk->size() ||
+      extentIt->second.epoch != chunk->latestEpoch()) {
+    return "";
+  }
+  return getExtentPath(key, extentIt->second);
+}
+
+std::string FileMgr::getChunkExtentDir() const {
+  return fileMgrBasePath_ + "/" + CHUNK_EXTENT_DIRNAME;
+}
+
+std::string FileMgr::getExtentPath(const ChunkKey& key, const ChunkExtent& extent) const {
+  // the size and epoch are part of the name, so that a rewritten extent never replaces
+  // a file which may still be mapped
+  std::string path = getChunkExtentDir() + "/";
+  for (size_t i = 0; i < key.size(); ++i) {
+    path += (i ? "_" : "") + std::to_string(key[i]);
+  }
+  return path + "." + std::to_string(extent.epoch) + "." +
+         std::to_string(extent.numBytes) + CHUNK_EXTENT_EXT;
+}
+
+void FileMgr::openChunkExtents() {
+  boost::filesystem::path path(getChunkExtentDir());
+  if (!boost::filesystem::is_directory(path)) {
+    return;
+  }
+  // extents of chunks which changed or were dropped since are removed, they'd only be
+  // rewritten by the next checkpoint anyway
+  std::vector<boost::filesystem::path> staleFiles;
+  for (boost::filesystem::directory_iterator fileIt(path), endIt; fileIt != endIt;
+       ++fileIt) {
+    std::vector<std::string> parts;
+    boost::split(parts, fileIt->path().filename().string(), boost::is_any_of("."));
+    if (parts.size() != 4 || "." + parts[3] != CHUNK_EXTENT_EXT) {
+      staleFiles.push_back(fileIt->path());
+      continue;
+    }
+    std::vector<std::string> ids;
+    boost::split(ids, parts[0], boost::is_any_of("_"));
+    ChunkKey key;
+    ChunkExtent extent;
+    try {
+      for (const auto& id : ids) {
+        key.push_back(boost::lexical_cast<int>(id));
+      }
+      extent.epoch = boost::lexical_cast<int>(parts[1]);
+      extent.numBytes = boost::lexical_cast<size_t>(parts[2]);
+    } catch (const boost::bad_lexical_cast&) {
+      staleFiles.push_back(fileIt->path());
+      continue;
+    }
+    auto chunkIt = chunkIndex_.find(key);
+    if (chunkIt == chunkIndex_.end() || chunkIt->second->size() != extent.numBytes ||
+        chunkIt->second->latestEpoch() != extent.epoch ||
+        chunkExtents_.count(key)) {
+      staleFiles.push_back(fileIt->path());
+      continue;
+    }
+    chunkExtents_[key] = extent;
+  }
+  for (const auto& staleFile : staleFiles) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(staleFile, ec);
+  }
+  VLOG(1) << "Opened " << chunkExtents_.size() << " chunk extents, removed "
+          << staleFiles.size() << " stale files in " << path;
+}
+
+void FileMgr::writeChunkExtents() {
+  if (!getMmapChunks()) {
+    return;
+  }
+  boost::filesystem::path path(getChunkExtentDir());
+  if (!boost::filesystem::is_directory(path) &&
+      !boost::filesystem::create_directory(path)) {
+    LOG(WARNING) << "Could not create the chunk extent directory " << path;
+    return;
+  }
+  auto clock_begin = timer_start();
+  size_t numWritten = 0;
+  size_t numBytesWritten = 0;
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  for (const auto& chunk : chunkIndex_) {
+    const ChunkExtent extent{chunk.second->size(), chunk.second->latestEpoch()};
+    {
+      std::lock_guard<std::mutex> chunkExtentsLock(chunkExtentsMutex_);
+      auto extentIt = chunkExtents_.find(chunk.first);
+      if (extentIt != chunkExtents_.end() &&
+          extentIt->second.numBytes == extent.numBytes &&
+          extentIt->second.epoch == extent.epoch) {
+        continue;
+      }
+    }
+    removeChunkExtent(chunk.first);
+    if (extent.numBytes == 0) {
+      continue;
+    }
+    const auto extentPath = getExtentPath(chunk.first, extent);
+    if (!writeChunkExtent(chunk.second, extentPath)) {
+      continue;
+    }
+    std::lock_guard<std::mutex> chunkExtentsLock(chunkExtentsMutex_);
+    chunkExtents_[chunk.first] = extent;
+    ++numWritten;
+    numBytesWritten += extent.numBytes;
+  }
+  if (numWritten) {
+    LOG(INFO) << "Wrote " << numWritten << " chunk extents (" << numBytesWritten
+              << "B) in " << timer_stop(clock_begin) << "ms, table location: '"
+              << fileMgrBasePath_ << "'";
+  }
+}
+
+bool FileMgr::writeChunkExtent(FileBuffer* chunk, const std::string& path) {
+  // written under a name of its own first, so that only whole extents are ever mapped
+  const auto partialPath = path + ".part";
+  const size_t numBytes = chunk->size();
+  int fd = ::open(partialPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    LOG(WARNING) << "Could not create chunk extent " << partialPath
+                 << ", the error was: " << std::strerror(errno);
+    return false;
+  }
+  bool written = false;
+  if (ftruncate(fd, numBytes) == 0) {
+    // the pages are read straight into the file's pages in the page cache
+    auto mem = mmap(nullptr, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem != MAP_FAILED) {
+      chunk->read(reinterpret_cast<int8_t*>(mem), numBytes, 0, CPU_LEVEL, -1);
+      written = munmap(mem, numBytes) == 0 && fdatasync(fd) == 0;
+    }
+  }
+  if (!written) {
+    LOG(WARNING) << "Could not write chunk extent " << partialPath
+                 << ", the error was: " << std::strerror(errno);
+  }
+  if (::close(fd) != 0 || !written ||
+      std::rename(partialPath.c_str(), path.c_str()) != 0) {
+    std::remove(partialPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+void FileMgr::removeChunkExtent(const ChunkKey& key) {
+  std::lock_guard<std::mutex> chunkExtentsLock(chunkExtentsMutex_);
+  auto extentIt = chunkExtents_.find(key);
+  if (extentIt == chunkExtents_.end()) {
+    return;
+  }
+  // mappings of the file stay valid until they are unmapped
+  std::remove(getExtentPath(key, extentIt->second).c_str());
+  chunkExtents_.erase(extentIt);
+}
+
 AbstractBuffer* FileMgr::alloc(const size_t numBytes = 0) {
   LOG(FATAL) << "Operation not supported";
 }
@@ -859,6 +1063,35 @@ void FileMgr::requestFreePages(size_t numPagesRequested,
   assert(pages.size() == numPagesRequested);
 }
 
+void FileMgr::requestFreePageRun(const size_t pageSize,
+                                 const size_t numPages,
+                                 const Page& prevPage,
+                                 std::vector<Page>& pages) {
+  std::lock_guard<std::mutex> lock(getPageMutex_);
+  FileInfo* fileInfo = nullptr;
+  int pageNum = -1;
+  if (prevPage.fileId >= 0) {
+    fileInfo = files_[prevPage.fileId];
+    pageNum = fileInfo->getFreePageRun(numPages, prevPage.pageNum + 1);
+  }
+  auto candidateFiles = fileIndex_.equal_range(pageSize);
+  for (auto fileIt = candidateFiles.first;
+       pageNum == -1 && fileIt != candidateFiles.second;
+       ++fileIt) {
+    fileInfo = files_[fileIt->second];
+    pageNum = fileInfo->getFreePageRun(numPages);
+  }
+  if (pageNum == -1) {
+    // sized for the run if it doesn't fit a file of the usual size
+    fileInfo = createFile(pageSize, std::max(numPages, size_t(MAX_FILE_N_PAGES)));
+    pageNum = fileInfo->getFreePageRun(numPages);
+    CHECK_NE(pageNum, -1);
+  }
+  for (size_t i = 0; i < numPages; ++i) {
+    pages.emplace_back(fileInfo->fileId, pageNum + i);
+  }
+}
+
 FileInfo* FileMgr::openExistingFile(const std::string& path,
                                     const int fileId,
                                     const size_t pageSize,
@@ -911,6 +1144,28 @@ FILE* FileMgr::getFileForFileId(const int fileId) {
   assert(fileId >= 0);
   return files_[fileId]->f;
 }
+
+size_t FileMgr::compactChunks() {
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  size_t numRelocated = 0;
+  for (auto& chunk : chunkIndex_) {
+    numRelocated += chunk.second->relocatePages();
+  }
+  return numRelocated;
+}
+
+ChunkLayoutStats FileMgr::getChunkLayoutStats() const {
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  ChunkLayoutStats stats;
+  for (const auto& chunk : chunkIndex_) {
+    const size_t numPageRuns = chunk.second->pageRunCount();
+    ++stats.numChunks;
+    stats.numPages += chunk.second->pageCount();
+    stats.numPageRuns += numPageRuns;
+    stats.numScatteredChunks += numPageRuns > 1;
+  }
+  return stats;
+}
 /*
 void FileMgr::getAllChunkMetaInfo(std::vector<std::pair<ChunkKey, int64_t> > &metadata) {
     metadata.reserve(chunkIndex_.size());
@@ -79,6 +79,21 @@ typedef FileBuffer Chunk;
  */
 typedef std::map<ChunkKey, FileBuffer*> ChunkKeyToChunkMap;
 
+/**
+ * @type ChunkLayoutStats
+ * @brief How scattered the pages of the chunks of a table are over its files.
+ *
+ * A page run is a range of pages which directly follow each other in one file, and so
+ * are read sequentially. A chunk whose pages form a single run is contiguous; every
+ * further run costs a chunk read another seek.
+ */
+struct ChunkLayoutStats {
+  size_t numChunks{0};
+  size_t numPages{0};
+  size_t numPageRuns{0};
+  size_t numScatteredChunks{0};  /// chunks with more than one run
+};
+
 /**
  * @class   FileMgr
  * @brief
@@ -184,6 +199,23 @@ class FileMgr : public AbstractBufferMgr {  // implements
                         std::vector<Page>& pages,
                         const bool isMetadata);
 
+  /**
+   * @brief Obtains free pages which directly follow each other in one file.
+   *
+   * The run starts right after prevPage if the pages there are free, so that a chunk
+   * growing into it stays in one run, else it is the first run long enough in any of
+   * the files of the page size. If there is none, a new file is created for it.
+   *
+   * @param pageSize     The size of each requested page
+   * @param numPages     The number of free pages requested
+   * @param prevPage     The page the run should continue, if valid
+   * @param pages        A vector the pages of the run are appended to, in order
+   */
+  void requestFreePageRun(const size_t pageSize,
+                          const size_t numPages,
+                          const Page& prevPage,
+                          std::vector<Page>& pages);
+
   virtual void getChunkMetadataVec(
       std::vector<std::pair<ChunkKey, ChunkMetadata>>& chunkMetadataVec);
   virtual void getChunkMetadataVecForKeyPrefix(
@@ -211,6 +243,24 @@ class FileMgr : public AbstractBufferMgr {  // implements
    */
   inline size_t getNumReaderThreads() { return num_reader_threads_; }
 
+  /// Returns whether new chunks are stored in the narrowest width their values fit.
+  bool getNarrowChunks() const;
+
+  /// Returns how many pages past the ones it needs a chunk which grows takes along in one
+  /// run, for its next appends to continue it, or 0 if pages are taken one at a time.
+  size_t getChunkGrowthPages() const;
+
+  /// Returns whether each chunk is also written out to an extent file of its own at the
+  /// checkpoints, for the CPU buffer pool to map (see CpuBufferMgr).
+  bool getMmapChunks() const;
+
+  /**
+   * @brief Returns the path of the extent file which holds the chunk as one contiguous
+   * range of bytes, as read from its pages, or an empty string if there is no such file
+   * or the chunk changed since it was written.
+   */
+  std::string getChunkExtentPath(const ChunkKey& key) const;
+
   /**
    * @brief Returns FILE pointer associated with
    * requested fileId
@@ -220,6 +270,19 @@ class FileMgr : public AbstractBufferMgr {  // implements
 
   FILE* getFileForFileId(const int fileId);
 
+  /**
+   * @brief Moves the pages of each chunk which is spread over several page runs into a
+   * single run, and returns the number of chunks moved.
+   *
+   * The moved pages are written as new versions at the current epoch, and the pages they
+   * replace are freed as of it, so the move only takes effect, and the old pages are
+   * only reused, with the next checkpoint. Chunks changed since the last checkpoint are
+   * left where they are.
+   */
+  size_t compactChunks();
+
+  ChunkLayoutStats getChunkLayoutStats() const;
+
   inline size_t getNumChunks() {
     // @todo should be locked - but this is more for testing now
     return chunkIndex_.size();
@@ -258,6 +321,21 @@ class FileMgr : public AbstractBufferMgr {  // implements
   mutable mapd_shared_mutex mutex_free_page;
   std::vector<std::pair<FileInfo*, int>> free_pages;
 
+  /// An extent file, by the size and latest page epoch of the chunk it was written from
+  struct ChunkExtent {
+    size_t numBytes;
+    int epoch;
+  };
+  std::map<ChunkKey, ChunkExtent> chunkExtents_;
+  mutable std::mutex chunkExtentsMutex_;
+
+  std::string getChunkExtentDir() const;
+  std::string getExtentPath(const ChunkKey& key, const ChunkExtent& extent) const;
+  void openChunkExtents();
+  void writeChunkExtents();
+  bool writeChunkExtent(FileBuffer* chunk, const std::string& path);
+  void removeChunkExtent(const ChunkKey& key);
+
   /**
    * @brief Adds a file to the file manager repository.
    *
@@ -44,6 +44,8 @@ GlobalFileMgr::GlobalFileMgr(const int deviceId,
     : AbstractBufferMgr(deviceId)
     , basePath_(basePath)
     , num_reader_threads_(num_reader_threads)
+    , narrow_chunks_(false)
+    , chunk_growth_pages_(0)
     , epoch_(-1)
     ,  // set the default epoch for all tables corresponding to the time of
        // last checkpoint
@@ -145,6 +147,47 @@ FileMgr* GlobalFileMgr::findFileMgr(const int db_id,
   return fm;
 }
 
+bool GlobalFileMgr::isBufferOnDevice(const ChunkKey& key) {
+  // without a directory the table has no chunks, and no FileMgr needs to be created
+  if (!findFileMgr(key[0], key[1]) &&
+      !boost::filesystem::exists(basePath_ + "table_" + std::to_string(key[0]) + "_" +
+                                 std::to_string(key[1]))) {
+    return false;
+  }
+  return getFileMgr(key)->isBufferOnDevice(key);
+}
+
+bool GlobalFileMgr::getMmapChunks(const int db_id, const int tb_id) {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(mmap_tables_mutex_);
+  return mmap_tables_.count(std::make_pair(db_id, tb_id)) > 0;
+}
+
+void GlobalFileMgr::setMmapChunks(const int db_id,
+                                  const int tb_id,
+                                  const bool mmap_chunks) {
+  mapd_lock_guard<mapd_shared_mutex> write_lock(mmap_tables_mutex_);
+  if (mmap_chunks) {
+    mmap_tables_.insert(std::make_pair(db_id, tb_id));
+  } else {
+    mmap_tables_.erase(std::make_pair(db_id, tb_id));
+  }
+}
+
+std::string GlobalFileMgr::getChunkExtentPath(const ChunkKey& key) {
+  if (!getMmapChunks(key[0], key[1]) || !isBufferOnDevice(key)) {
+    return "";
+  }
+  return getFileMgr(key)->getChunkExtentPath(key);
+}
+
+size_t GlobalFileMgr::compactChunks(const int db_id, const int tb_id) {
+  return getFileMgr(db_id, tb_id)->compactChunks();
+}
+
+ChunkLayoutStats GlobalFileMgr::getChunkLayoutStats(const int db_id, const int tb_id) {
+  return getFileMgr(db_id, tb_id)->getChunkLayoutStats();
+}
+
 FileMgr* GlobalFileMgr::getFileMgr(const int db_id, const int tb_id) {
   { /* check if FileMgr already exists for (db_id, tb_id) */
     FileMgr* fm = findFileMgr(db_id, tb_id);
@@ -196,6 +239,7 @@ void GlobalFileMgr::removeTableRelatedDS(const int db_id, const int tb_id) {
   }
   fm->closeRemovePhysical();
   /* remove table related in-memory DS only if directory was removed successfully */
+  setMmapChunks(db_id, tb_id, false);
 
   delete fm;
 }
@@ -63,9 +63,7 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
     return getFileMgr(key)->createBuffer(key, pageSize, numBytes);
   }
 
-  virtual bool isBufferOnDevice(const ChunkKey& key) {
-    return getFileMgr(key)->isBufferOnDevice(key);
-  }
+  virtual bool isBufferOnDevice(const ChunkKey& key);
 
   /// Deletes the chunk with the specified key
   // Purge == true means delete the data chunks -
@@ -142,6 +140,37 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
    */
   inline size_t getNumReaderThreads() { return num_reader_threads_; }
 
+  /**
+   * @brief Whether chunks of integer-like columns created from now on are stored in the
+   * narrowest width their values fit (see FileBuffer::storedElemSize()).
+   */
+  inline bool getNarrowChunks() const { return narrow_chunks_; }
+  inline void setNarrowChunks(const bool narrow_chunks) { narrow_chunks_ = narrow_chunks; }
+
+  /**
+   * @brief How many pages past those they need growing chunks take along in one run, for
+   * their later appends to stay contiguous on disk; 0 takes them one at a time.
+   */
+  inline size_t getChunkGrowthPages() const { return chunk_growth_pages_; }
+  inline void setChunkGrowthPages(const size_t chunk_growth_pages) {
+    chunk_growth_pages_ = chunk_growth_pages;
+  }
+
+  /**
+   * @brief Whether the chunks of the table are written out to an extent file each at
+   * its checkpoints, for the CPU buffer pool to map instead of copying them (table
+   * option MMAP, see FileMgr::getChunkExtentPath()).
+   */
+  bool getMmapChunks(const int db_id, const int tb_id);
+  void setMmapChunks(const int db_id, const int tb_id, const bool mmap_chunks);
+  /// Returns the path of the current extent file of the chunk, if its table has them.
+  std::string getChunkExtentPath(const ChunkKey& key);
+
+  /// Moves each chunk of the table spread over several page runs into a single one, as
+  /// of the next checkpoint (see FileMgr::compactChunks()).
+  size_t compactChunks(const int db_id, const int tb_id);
+  ChunkLayoutStats getChunkLayoutStats(const int db_id, const int tb_id);
+
   size_t getNumChunks();
 
   FileMgr* findFileMgr(const int db_id,
@@ -165,6 +194,8 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
  private:
   std::string basePath_;       /// The OS file system path containing the files.
   size_t num_reader_threads_;  /// number of threads used when loading data
+  bool narrow_chunks_;         /// store new chunks in the narrowest width that fits
+  size_t chunk_growth_pages_;  /// extra pages growing chunks take along in one run
   int epoch_; /* the current epoch (time of last checkpoint) will be used for all
                * tables except of the one for which the value of the epoch has been reset
                * using --start-epoch option at start up to rollback this table's updates.
@@ -181,6 +212,8 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
                     /// "mapd_db_version_"
   std::map<std::pair<int, int>, FileMgr*> fileMgrs_;
   mapd_shared_mutex fileMgrs_mutex_;
+  std::set<std::pair<int, int>> mmap_tables_;  /// tables with chunk extent files
+  mapd_shared_mutex mmap_tables_mutex_;
 };
 
 }  // namespace File_Namespace
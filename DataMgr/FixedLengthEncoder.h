@@ -22,6 +22,7 @@
 #include <stdexcept>
 #include "AbstractBuffer.h"
 #include "Encoder.h"
+#include "EncoderKernels.h"
 
 #include <Shared/DatumFetchers.h>
 
@@ -38,40 +39,42 @@ class FixedLengthEncoder : public Encoder {
                            const size_t numAppendElems,
                            const SQLTypeInfo& ti,
                            const bool replicating = false) {
-    T* unencodedData = reinterpret_cast<T*>(srcData);
-    auto encodedData = std::unique_ptr<V[]>(new V[numAppendElems]);
-    for (size_t i = 0; i < numAppendElems; ++i) {
-      size_t ri = replicating ? 0 : i;
-      encodedData.get()[i] = static_cast<V>(unencodedData[ri]);
-      if (unencodedData[ri] != encodedData.get()[i]) {
-        decimal_overflow_validator_.validate(unencodedData[ri]);
-        LOG(ERROR) << "Fixed encoding failed, Unencoded: " +
-                          std::to_string(unencodedData[ri]) +
-                          " encoded: " + std::to_string(encodedData.get()[i]);
+    const T* unencodedData = reinterpret_cast<const T*>(srcData);
+    // a replicated value only needs to be looked at once
+    const size_t numValues =
+        replicating ? std::min(numAppendElems, size_t(1)) : numAppendElems;
+    const auto stats = EncoderKernels::compute_append_stats<T, V>(
+        unencodedData, numValues, std::numeric_limits<V>::min());
+    if (stats.num_unencodable) {
+      reportUnencodable(unencodedData, numValues);
+    }
+    if (stats.min <= stats.max) {
+      // all values are checked once the extremes are
+      decimal_overflow_validator_.validate(stats.max);
+      decimal_overflow_validator_.validate(stats.min);
+      if (ti.is_date_in_days()) {
+        // convert days -> seconds for metadata
+        dataMin = std::min(dataMin, static_cast<T>(stats.min * SECSPERDAY));
+        dataMax = std::max(dataMax, static_cast<T>(stats.max * SECSPERDAY));
       } else {
-        T data = unencodedData[ri];
-        if (data == std::numeric_limits<V>::min())
-          has_nulls = true;
-        else {
-          decimal_overflow_validator_.validate(data);
-          if (ti.is_date_in_days()) {
-            // convert days -> seconds for metadata
-            auto convert_days_to_seconds = [](const int64_t days) {
-              return days * SECSPERDAY;
-            };
-            dataMin = std::min(dataMin, static_cast<T>(convert_days_to_seconds(data)));
-            dataMax = std::max(dataMax, static_cast<T>(convert_days_to_seconds(data)));
-          } else {
-            dataMin = std::min(dataMin, data);
-            dataMax = std::max(dataMax, data);
-          }
-        }
+        dataMin = std::min(dataMin, stats.min);
+        dataMax = std::max(dataMax, stats.max);
       }
     }
+    has_nulls |= stats.has_nulls;
     num_elems_ += numAppendElems;
 
-    // assume always CPU_BUFFER?
-    buffer_->append((int8_t*)(encodedData.get()), numAppendElems * sizeof(V));
+    EncoderKernels::append_encoded<V>(
+        buffer_, numAppendElems, [&](V* dst, const size_t first, const size_t count) {
+          if (replicating) {
+            std::fill(dst, dst + count, static_cast<V>(unencodedData[0]));
+          } else {
+            const T* src = unencodedData + first;
+            for (size_t i = 0; i < count; ++i) {
+              dst[i] = static_cast<V>(src[i]);
+            }
+          }
+        });
     ChunkMetadata chunkMetadata;
     getMetadata(chunkMetadata);
     if (!replicating)
@@ -166,6 +169,20 @@ class FixedLengthEncoder : public Encoder {
   T dataMax;
   bool has_nulls;
 
+ private:
+  // Slow path for appends with values which don't fit the encoding.
+  void reportUnencodable(const T* unencodedData, const size_t numElems) {
+    for (size_t i = 0; i < numElems; ++i) {
+      const auto encoded = static_cast<V>(unencodedData[i]);
+      if (unencodedData[i] != encoded) {
+        decimal_overflow_validator_.validate(unencodedData[i]);
+        LOG(ERROR) << "Fixed encoding failed, Unencoded: " +
+                          std::to_string(unencodedData[i]) +
+                          " encoded: " + std::to_string(encoded);
+      }
+    }
+  }
+
 };  // FixedLengthEncoder
 
 #endif  // FIXED_LENGTH_ENCODER_H
@@ -17,29 +17,26 @@
 #include "LockMgr.h"
 #include "Fragmenter/InsertOrderFragmenter.h"
 #include "QueryEngine/JsonAccessors.h"
+#include "QueryEngine/RelAlgBinaryPlan.h"
 #include "gen-cpp/CalciteServer.h"
 
 namespace Lock_Namespace {
 
 using namespace rapidjson;
 
-void getTableNames(std::map<std::string, bool>& tableNames, const std::string query_ra) {
-  rapidjson::Document query_ast;
-  query_ast.Parse(query_ra.c_str());
-  CHECK(!query_ast.HasParseError());
-  CHECK(query_ast.IsObject());
-  getTableNames(tableNames, query_ast);
-}
+namespace {
 
-void getTableNames(std::map<std::string, bool>& tableNames, const Value& value) {
+template <typename JsonValue>
+void collect_table_names(std::map<std::string, bool>& tableNames,
+                         const JsonValue& value) {
   if (value.IsArray()) {
-    for (SizeType i = 0; i < value.Size(); ++i) {
-      getTableNames(tableNames, value[i]);
+    for (auto it = value.Begin(); it != value.End(); ++it) {
+      collect_table_names(tableNames, *it);
     }
     return;
   } else if (value.IsObject()) {
     for (auto mit = value.MemberBegin(); mit != value.MemberEnd(); ++mit) {
-      getTableNames(tableNames, mit->value);
+      collect_table_names(tableNames, mit->value);
     }
   } else {
     return;
@@ -50,12 +47,13 @@ void getTableNames(std::map<std::string, bool>& tableNames, const Value& value)
   }
   const auto& rels = value["rels"];
   CHECK(rels.IsArray());
-  for (SizeType i = 0; i < rels.Size(); ++i) {
-    const auto& rel = rels[i];
+  for (auto rel_it = rels.Begin(); rel_it != rels.End(); ++rel_it) {
+    const auto& rel = *rel_it;
     const auto& relop = json_str(rel["relOp"]);
     if (rel.FindMember("table") != rel.MemberEnd()) {
       if ("EnumerableTableScan" == relop || "LogicalTableModify" == relop) {
-        const auto t = rel["table"].GetArray();
+        const auto& t = rel["table"];
+        CHECK(t.IsArray());
         CHECK(t[1].IsString());
         tableNames[t[1].GetString()] |= "LogicalTableModify" == relop;
       }
@@ -63,6 +61,30 @@ void getTableNames(std::map<std::string, bool>& tableNames, const Value& value)
   }
 }
 
+}  // namespace
+
+void getTableNames(std::map<std::string, bool>& tableNames, const std::string query_ra) {
+  if (RelAlgBinaryPlan::isBinaryPlan(query_ra)) {
+    const RelAlgBinaryPlan plan(query_ra);
+    getTableNames(tableNames, plan.root());
+    return;
+  }
+  rapidjson::Document query_ast;
+  query_ast.Parse(query_ra.c_str());
+  CHECK(!query_ast.HasParseError());
+  CHECK(query_ast.IsObject());
+  getTableNames(tableNames, query_ast);
+}
+
+void getTableNames(std::map<std::string, bool>& tableNames, const Value& value) {
+  collect_table_names(tableNames, value);
+}
+
+void getTableNames(std::map<std::string, bool>& tableNames,
+                   const RelAlgBinaryValue& value) {
+  collect_table_names(tableNames, value);
+}
+
 ChunkKey getTableChunkKey(const Catalog_Namespace::Catalog& cat,
                           const std::string& tableName) {
   if (const auto tdp = cat.getMetadataForTable(tableName, false)) {
@@ -28,6 +28,8 @@
 
 #include <rapidjson/document.h>
 
+class RelAlgBinaryValue;
+
 namespace Lock_Namespace {
 using namespace rapidjson;
 using VLock = boost::variant<mapd_shared_lock<mapd_shared_mutex>,
@@ -75,6 +77,8 @@ std::shared_ptr<MutexType> LockMgr<MutexType, KeyType>::getMutex(const LockType
 ChunkKey getTableChunkKey(const Catalog_Namespace::Catalog& cat,
                           const std::string& tableName);
 void getTableNames(std::map<std::string, bool>& tableNames, const Value& value);
+void getTableNames(std::map<std::string, bool>& tableNames,
+                   const RelAlgBinaryValue& value);
 void getTableNames(std::map<std::string, bool>& tableNames, const std::string query_ra);
 std::string parse_to_ra(const Catalog_Namespace::Catalog& cat,
                         const std::string& query_str,
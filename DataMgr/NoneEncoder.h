@@ -19,6 +19,7 @@
 
 #include "AbstractBuffer.h"
 #include "Encoder.h"
+#include "EncoderKernels.h"
 
 #include <Shared/DatumFetchers.h>
 
@@ -41,26 +42,29 @@ class NoneEncoder : public Encoder {
                            const size_t numAppendElems,
                            const SQLTypeInfo&,
                            const bool replicating = false) {
-    T* unencodedData = reinterpret_cast<T*>(srcData);
-    std::unique_ptr<T> encodedData;
-    if (replicating)
-      encodedData.reset(new T[numAppendElems]);
-    for (size_t i = 0; i < numAppendElems; ++i) {
-      size_t ri = replicating ? 0 : i;
-      T data = unencodedData[ri];
-      if (replicating)
-        encodedData.get()[i] = data;
-      if (data == none_encoded_null_value<T>())
-        has_nulls = true;
-      else {
-        decimal_overflow_validator_.validate(data);
-        dataMin = std::min(dataMin, data);
-        dataMax = std::max(dataMax, data);
-      }
+    const T* unencodedData = reinterpret_cast<const T*>(srcData);
+    // a replicated value only needs to be looked at once
+    const size_t numValues =
+        replicating ? std::min(numAppendElems, size_t(1)) : numAppendElems;
+    const auto stats = EncoderKernels::compute_append_stats<T, T>(
+        unencodedData, numValues, none_encoded_null_value<T>());
+    if (stats.min <= stats.max) {
+      // all values are checked once the extremes are
+      decimal_overflow_validator_.validate(stats.max);
+      decimal_overflow_validator_.validate(stats.min);
+      dataMin = std::min(dataMin, stats.min);
+      dataMax = std::max(dataMax, stats.max);
     }
+    has_nulls |= stats.has_nulls;
     num_elems_ += numAppendElems;
-    buffer_->append(replicating ? (int8_t*)encodedData.get() : srcData,
-                    numAppendElems * sizeof(T));
+    if (replicating) {
+      EncoderKernels::append_encoded<T>(
+          buffer_, numAppendElems, [&](T* dst, const size_t first, const size_t count) {
+            std::fill(dst, dst + count, unencodedData[0]);
+          });
+    } else {
+      buffer_->append(srcData, numAppendElems * sizeof(T));
+    }
     ChunkMetadata chunkMetadata;
     getMetadata(chunkMetadata);
     if (!replicating)
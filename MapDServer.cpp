@@ -41,6 +41,8 @@
 #include <boost/filesystem.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/program_options.hpp>
+#include <atomic>
+#include <chrono>
 #include <csignal>
 #include <sstream>
 #include <thread>
@@ -92,6 +94,10 @@ mapd::shared_ptr<MapDHandler> g_warmup_handler =
         // between "MapDHandler" & function "run_warmup_queries"
 mapd::shared_ptr<MapDHandler> g_mapd_handler = 0;
 
+// set while main() serves requests, so that SIGTERM can leave the shutdown to it
+std::atomic<bool> g_serving{false};
+std::atomic<bool> g_shutdown_requested{false};
+
 void shutdown_handler() {
   if (g_mapd_handler) {
     g_mapd_handler->shutdown();
@@ -100,6 +106,11 @@ void shutdown_handler() {
 
 void mapd_signal_handler(int signal_number) {
   LOG(INFO) << "Interrupt signal (" << signal_number << ") received.\n";
+  if (signal_number == SIGTERM && g_serving) {
+    // main() stops the servers, waits for the requests they're running and shuts down
+    g_shutdown_requested = true;
+    return;
+  }
   shutdown_handler();
   // shut down logging force a flush
   google::ShutdownGoogleLogging();
@@ -256,14 +267,70 @@ void MapDProgramOptions::fillOptions(po::options_description& desc) {
                      po::value<size_t>(&mapd_parameters.cpu_buffer_mem_bytes)
                          ->default_value(mapd_parameters.cpu_buffer_mem_bytes),
                      "Size of memory reserved for CPU buffers [bytes]");
+  desc.add_options()("cpu-buffer-mem-path",
+                     po::value<std::string>(&mapd_parameters.cpu_buffer_mem_path)
+                         ->default_value(mapd_parameters.cpu_buffer_mem_path),
+                     "Directory on a tmpfs (e.g. /dev/shm) or hugetlbfs mount to keep "
+                     "the CPU buffers in, so that they survive a clean restart (empty "
+                     "to use the heap)");
+  desc.add_options()("cpu-buffer-prewarm",
+                     po::value<bool>(&mapd_parameters.cpu_buffer_prewarm)
+                         ->default_value(mapd_parameters.cpu_buffer_prewarm)
+                         ->implicit_value(true),
+                     "Record how often chunks are used and reload the ones used most "
+                     "into the CPU buffers on start and after clear_cpu_memory");
+  desc.add_options()("cpu-buffer-prewarm-rate",
+                     po::value<size_t>(&mapd_parameters.cpu_buffer_prewarm_rate)
+                         ->default_value(mapd_parameters.cpu_buffer_prewarm_rate),
+                     "Max rate of the CPU buffer prewarm reloads [MB/s] (0 for no "
+                     "limit)");
   desc.add_options()("gpu-buffer-mem-bytes",
                      po::value<size_t>(&mapd_parameters.gpu_buffer_mem_bytes)
                          ->default_value(mapd_parameters.gpu_buffer_mem_bytes),
                      "Size of memory reserved for GPU buffers [bytes] (per GPU)");
+  desc.add_options()("disk-cache-path",
+                     po::value<std::string>(&mapd_parameters.disk_cache_path)
+                         ->default_value(mapd_parameters.disk_cache_path),
+                     "Directory on a fast local disk caching chunks read from the data "
+                     "directory (empty to disable)");
+  desc.add_options()("disk-cache-bytes",
+                     po::value<size_t>(&mapd_parameters.disk_cache_bytes)
+                         ->default_value(mapd_parameters.disk_cache_bytes),
+                     "Size of the local disk cache [bytes]");
+  desc.add_options()("narrow-chunks",
+                     po::value<bool>(&mapd_parameters.narrow_chunks)
+                         ->default_value(mapd_parameters.narrow_chunks)
+                         ->implicit_value(true),
+                     "Store the chunks of integer, decimal, time and dictionary encoded "
+                     "columns written from now on as the narrowest offsets from a base "
+                     "value of the chunk their values fit. Chunks stored this way can't "
+                     "be read by earlier versions.");
+  desc.add_options()("chunk-growth-pages",
+                     po::value<size_t>(&mapd_parameters.chunk_growth_pages)
+                         ->default_value(mapd_parameters.chunk_growth_pages),
+                     "Number of pages past those it needs a growing chunk sets aside in "
+                     "the same run of pages of a data file, so that its next appends "
+                     "keep it contiguous (0 to allocate pages one at a time)");
   desc.add_options()("calcite-max-mem",
                      po::value<size_t>(&mapd_parameters.calcite_max_mem)
                          ->default_value(mapd_parameters.calcite_max_mem),
                      "Max memory available to calcite JVM");
+  desc.add_options()("calcite-in-process",
+                     po::value<bool>(&mapd_parameters.calcite_in_process)
+                         ->default_value(mapd_parameters.calcite_in_process)
+                         ->implicit_value(true),
+                     "Host the Calcite planner in-process through JNI instead of "
+                     "running it as a separate server");
+  desc.add_options()("calcite-planner-pool-size",
+                     po::value<size_t>(&mapd_parameters.calcite_planner_pool_size)
+                         ->default_value(mapd_parameters.calcite_planner_pool_size),
+                     "Number of planner instances for the in-process Calcite planner");
+  desc.add_options()("calcite-binary-plan",
+                     po::value<bool>(&mapd_parameters.calcite_binary_plan)
+                         ->default_value(mapd_parameters.calcite_binary_plan)
+                         ->implicit_value(true),
+                     "Receive query plans from Calcite in the binary plan format instead "
+                     "of JSON");
   desc.add_options()(
       "res-gpu-mem",
       po::value<size_t>(&reserved_gpu_mem)->default_value(reserved_gpu_mem),
@@ -361,6 +428,18 @@ void MapDProgramOptions::fillOptions(po::options_description& desc) {
                          ->default_value(g_inner_join_fragment_skipping)
                          ->implicit_value(true),
                      "Enable/disable inner join fragment skipping.");
+  desc.add_options()("limit-fragment-skipping",
+                     po::value<bool>(&g_limit_fragment_skipping)
+                         ->default_value(g_limit_fragment_skipping)
+                         ->implicit_value(true),
+                     "Enable/disable skipping the fragments which can't hold any of the "
+                     "rows kept by an ORDER BY ... LIMIT, going by their metadata.");
+  desc.add_options()("fragment-sample-rate",
+                     po::value<double>(&g_fragment_sample_rate)
+                         ->default_value(g_fragment_sample_rate),
+                     "Fraction of the fragments of a table the aggregate queries over it "
+                     "run on, for approximate answers. Counts and sums are scaled up to "
+                     "the whole table. 1 runs them on all of the fragments.");
   desc.add_options()("enable-filter-push-down",
                      po::value<bool>(&g_enable_filter_push_down)
                          ->default_value(g_enable_filter_push_down)
@@ -441,6 +520,13 @@ void MapDProgramOptions::fillAdvancedOptions(po::options_description& desc_adv)
                          po::value<bool>(&g_enable_columnar_output)
                              ->default_value(g_enable_columnar_output)
                              ->implicit_value(true));
+  desc_adv.add_options()(
+      "enable-columnar-intermediate-results",
+      po::value<bool>(&g_enable_columnar_intermediate_results)
+          ->default_value(g_enable_columnar_intermediate_results)
+          ->implicit_value(true),
+      "Output projections read by later steps of a query columnar, so that those steps "
+      "read them in place instead of converting them to columns");
   desc_adv.add_options()("disable-shared-mem-group-by",
                          po::value<bool>(&g_enable_smem_group_by)
                              ->default_value(g_enable_smem_group_by)
@@ -452,6 +538,37 @@ void MapDProgramOptions::fillAdvancedOptions(po::options_description& desc_adv)
                              ->implicit_value(true),
                          "Remove quals from the filtered count if they are covered by a "
                          "join condition (currently only ST_Contains)");
+  desc_adv.add_options()(
+      "buffer-pool-scan-hint-fraction",
+      po::value<double>(&g_buffer_pool_scan_hint_fraction)
+          ->default_value(g_buffer_pool_scan_hint_fraction),
+      "Chunks read by scans whose input takes at least this fraction of a buffer pool "
+      "are evicted first from it (0 to disable)");
+  desc_adv.add_options()(
+      "group-by-buffer-pool-bytes",
+      po::value<size_t>(&g_group_by_buffer_pool_bytes)
+          ->default_value(g_group_by_buffer_pool_bytes),
+      "Host memory kept for reuse by the group by buffers of later queries (0 to "
+      "disable)");
+  desc_adv.add_options()(
+      "enable-cpu-radix-sort",
+      po::value<bool>(&g_enable_cpu_radix_sort)
+          ->default_value(g_enable_cpu_radix_sort)
+          ->implicit_value(true),
+      "Sort large results on CPU with a parallel radix sort instead of comparisons");
+  desc_adv.add_options()(
+      "enable-limited-scan-early-exit",
+      po::value<bool>(&g_enable_limited_scan_early_exit)
+          ->default_value(g_enable_limited_scan_early_exit)
+          ->implicit_value(true),
+      "Stop issuing the kernels of a projection with a LIMIT and no ORDER BY once the "
+      "earlier fragments have produced enough rows");
+  desc_adv.add_options()(
+      "limited-scan-max-kernels",
+      po::value<size_t>(&g_limited_scan_max_kernels)
+          ->default_value(g_limited_scan_max_kernels),
+      "Kernels of such a projection in flight at a time, 0 for as many as there are CPU "
+      "threads");
 };
 
 namespace {
@@ -694,6 +811,7 @@ bool MapDProgramOptions::parse_command_line(int argc, char** argv, int& return_c
   LOG(INFO) << " calcite JVM max memory  " << mapd_parameters.calcite_max_mem;
   LOG(INFO) << " OmniSci Server Port  " << mapd_parameters.omnisci_server_port;
   LOG(INFO) << " OmniSci Calcite Port  " << mapd_parameters.calcite_port;
+  LOG(INFO) << " OmniSci Calcite in-process  " << mapd_parameters.calcite_in_process;
 
   boost::algorithm::trim_if(authMetadata.distinguishedName, boost::is_any_of("\"'"));
   boost::algorithm::trim_if(authMetadata.uri, boost::is_any_of("\"'"));
@@ -789,18 +907,39 @@ int main(int argc, char** argv) {
     TThreadedServer httpServer(
         processor, httpServerTransport, httpTransportFactory, httpProtocolFactory);
 
+    g_serving = true;
     std::thread bufThread(start_server, std::ref(bufServer));
     std::thread httpThread(start_server, std::ref(httpServer));
+    // stopping the servers isn't safe from within the signal handler itself; stopped
+    // again until they're done, in case they were still starting to listen
+    std::thread stopThread([&bufServer, &httpServer] {
+      while (g_serving) {
+        if (g_shutdown_requested) {
+          bufServer.stop();
+          httpServer.stop();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+    });
 
     // run warm up queries if any exists
     run_warmup_queries(g_mapd_handler, desc_all.base_path, desc_all.db_query_file);
 
     bufThread.join();
     httpThread.join();
+    g_serving = false;
+    stopThread.join();
   } else {  // running ha server
     LOG(FATAL) << "No High Availability module available, please contact OmniSci support";
   }
 
+  if (g_shutdown_requested) {
+    shutdown_handler();
+    // only a clean shutdown hands the CPU buffers over to the next start, now that no
+    // request uses them any more
+    g_mapd_handler->save_cpu_buffer_pool();
+  }
+
   running = false;
   file_delete_thread.join();
 
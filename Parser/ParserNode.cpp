@@ -2312,10 +2312,22 @@ void CreateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
         } else {
           td.hasDeletedCol = true;
         }
+      } else if (boost::iequals(*p->get_name(), "mmap")) {
+        const auto mmap =
+            static_cast<const StringLiteral*>(p->get_value())->get_stringval();
+        CHECK(mmap);
+        const auto mmap_uc = boost::to_upper_copy<std::string>(*mmap);
+        if (mmap_uc != "TRUE" && mmap_uc != "FALSE") {
+          throw std::runtime_error("MMAP must be TRUE or FALSE");
+        }
+        if (mmap_uc == "TRUE" && is_temporary_) {
+          throw std::runtime_error("MMAP cannot be set on temporary tables");
+        }
+        td.mmapChunks = mmap_uc == "TRUE";
       } else {
         throw std::runtime_error("Invalid CREATE TABLE option " + *p->get_name() +
                                  ".  Should be FRAGMENT_SIZE, PAGE_SIZE, MAX_ROWS, "
-                                 "PARTITIONS, VACUUM or SHARD_COUNT.");
+                                 "PARTITIONS, VACUUM, MMAP or SHARD_COUNT.");
       }
     }
   }
@@ -2514,11 +2526,23 @@ void CreateTableAsSelectStmt::execute(const Catalog_Namespace::SessionInfo& sess
         } else {
           td.hasDeletedCol = true;
         }
+      } else if (boost::iequals(*p->get_name(), "mmap")) {
+        const auto mmap =
+            static_cast<const StringLiteral*>(p->get_value())->get_stringval();
+        CHECK(mmap);
+        const auto mmap_uc = boost::to_upper_copy<std::string>(*mmap);
+        if (mmap_uc != "TRUE" && mmap_uc != "FALSE") {
+          throw std::runtime_error("MMAP must be TRUE or FALSE");
+        }
+        if (mmap_uc == "TRUE" && is_temporary_) {
+          throw std::runtime_error("MMAP cannot be set on temporary tables");
+        }
+        td.mmapChunks = mmap_uc == "TRUE";
       } else {
         throw std::runtime_error(
             "Invalid CREATE TABLE option " + *p->get_name() +
             ".  Should be FRAGMENT_SIZE, PAGE_SIZE, MAX_CHUNK_SIZE, MAX_ROWS, "
-            "PARTITIONS or VACUUM.");
+            "PARTITIONS, VACUUM or MMAP.");
       }
     }
   }
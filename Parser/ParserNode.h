@@ -1094,6 +1094,15 @@ class OptimizeTableStmt : public DDLStmt {
     return false;
   }
 
+  bool shouldCompactChunks() const {
+    for (const auto& e : options_) {
+      if (boost::iequals(*(e->get_name()), "COMPACT")) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   virtual void execute(const Catalog_Namespace::SessionInfo& session) override {
     // Should pass optimize params to the table optimizer
     CHECK(false);
@@ -32,29 +32,27 @@
 extern "C" DEVICE uint32_t array_size(int8_t* chunk_iter_,
                                       const uint64_t row_pos,
                                       const uint32_t elem_log_sz) {
-  ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);
-  ArrayDatum ad;
-  bool is_end;
-  ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);
-  return ad.is_null ? 0 : ad.length >> elem_log_sz;
+  const ChunkIter* chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_);
+  size_t length;
+  int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, row_pos, &length);
+  return ChunkIter_is_null_varlen(chunk_iter, pointer, length) ? 0
+                                                                : length >> elem_log_sz;
 }
 
 extern "C" DEVICE bool array_is_null(int8_t* chunk_iter_, const uint64_t row_pos) {
-  ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);
-  ArrayDatum ad;
-  bool is_end;
-  ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);
-  return ad.is_null;
+  const ChunkIter* chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_);
+  size_t length;
+  int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, row_pos, &length);
+  return ChunkIter_is_null_varlen(chunk_iter, pointer, length);
 }
 
-#define ARRAY_AT(type)                                                        \
-  extern "C" DEVICE type array_at_##type(                                     \
-      int8_t* chunk_iter_, const uint64_t row_pos, const uint32_t elem_idx) { \
-    ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);        \
-    ArrayDatum ad;                                                            \
-    bool is_end;                                                              \
-    ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                     \
-    return reinterpret_cast<type*>(ad.pointer)[elem_idx];                     \
+#define ARRAY_AT(type)                                                             \
+  extern "C" DEVICE type array_at_##type(                                          \
+      int8_t* chunk_iter_, const uint64_t row_pos, const uint32_t elem_idx) {      \
+    const ChunkIter* chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_); \
+    size_t length;                                                                 \
+    int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, row_pos, &length);      \
+    return reinterpret_cast<type*>(pointer)[elem_idx];                             \
   }
 
 ARRAY_AT(int8_t)
@@ -66,44 +64,42 @@ ARRAY_AT(double)
 
 #undef ARRAY_AT
 
-#define ARRAY_ANY(type, needle_type, oper_name, oper)                    \
-  extern "C" DEVICE bool array_any_##oper_name##_##type##_##needle_type( \
-      int8_t* chunk_iter_,                                               \
-      const uint64_t row_pos,                                            \
-      const needle_type needle,                                          \
-      const type null_val) {                                             \
-    ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);   \
-    ArrayDatum ad;                                                       \
-    bool is_end;                                                         \
-    ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                \
-    const size_t elem_count = ad.length / sizeof(type);                  \
-    for (size_t i = 0; i < elem_count; ++i) {                            \
-      const needle_type val = reinterpret_cast<type*>(ad.pointer)[i];    \
-      if (val != null_val && val oper needle) {                          \
-        return true;                                                     \
-      }                                                                  \
-    }                                                                    \
-    return false;                                                        \
+#define ARRAY_ANY(type, needle_type, oper_name, oper)                              \
+  extern "C" DEVICE bool array_any_##oper_name##_##type##_##needle_type(           \
+      int8_t* chunk_iter_,                                                         \
+      const uint64_t row_pos,                                                      \
+      const needle_type needle,                                                    \
+      const type null_val) {                                                       \
+    const ChunkIter* chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_); \
+    size_t length;                                                                 \
+    int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, row_pos, &length);      \
+    const size_t elem_count = length / sizeof(type);                               \
+    for (size_t i = 0; i < elem_count; ++i) {                                      \
+      const needle_type val = reinterpret_cast<type*>(pointer)[i];                 \
+      if (val != null_val && val oper needle) {                                    \
+        return true;                                                               \
+      }                                                                            \
+    }                                                                              \
+    return false;                                                                  \
   }
 
-#define ARRAY_ALL(type, needle_type, oper_name, oper)                    \
-  extern "C" DEVICE bool array_all_##oper_name##_##type##_##needle_type( \
-      int8_t* chunk_iter_,                                               \
-      const uint64_t row_pos,                                            \
-      const needle_type needle,                                          \
-      const type null_val) {                                             \
-    ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);   \
-    ArrayDatum ad;                                                       \
-    bool is_end;                                                         \
-    ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                \
-    const size_t elem_count = ad.length / sizeof(type);                  \
-    for (size_t i = 0; i < elem_count; ++i) {                            \
-      const needle_type val = reinterpret_cast<type*>(ad.pointer)[i];    \
-      if (!(val != null_val && val oper needle)) {                       \
-        return false;                                                    \
-      }                                                                  \
-    }                                                                    \
-    return true;                                                         \
+#define ARRAY_ALL(type, needle_type, oper_name, oper)                              \
+  extern "C" DEVICE bool array_all_##oper_name##_##type##_##needle_type(           \
+      int8_t* chunk_iter_,                                                         \
+      const uint64_t row_pos,                                                      \
+      const needle_type needle,                                                    \
+      const type null_val) {                                                       \
+    const ChunkIter* chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_); \
+    size_t length;                                                                 \
+    int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, row_pos, &length);      \
+    const size_t elem_count = length / sizeof(type);                               \
+    for (size_t i = 0; i < elem_count; ++i) {                                      \
+      const needle_type val = reinterpret_cast<type*>(pointer)[i];                 \
+      if (!(val != null_val && val oper needle)) {                                 \
+        return false;                                                              \
+      }                                                                            \
+    }                                                                              \
+    return true;                                                                   \
   }
 
 #define ARRAY_ALL_ANY_ALL_TYPES(oper_name, oper, needle_type) \
@@ -166,22 +162,22 @@ ARRAY_ALL_ANY_ALL_TYPES(ge, >=, double)
 #undef ARRAY_ALL
 #undef ARRAY_ANY
 
-#define ARRAY_AT_CHECKED(type)                                                    \
-  extern "C" DEVICE type array_at_##type##_checked(int8_t* chunk_iter_,           \
-                                                   const uint64_t row_pos,        \
-                                                   const int64_t elem_idx,        \
-                                                   const type null_val) {         \
-    if (elem_idx <= 0) {                                                          \
-      return null_val;                                                            \
-    }                                                                             \
-    ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);            \
-    ArrayDatum ad;                                                                \
-    bool is_end;                                                                  \
-    ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                         \
-    if (ad.is_null || static_cast<size_t>(elem_idx) > ad.length / sizeof(type)) { \
-      return null_val;                                                            \
-    }                                                                             \
-    return reinterpret_cast<type*>(ad.pointer)[elem_idx - 1];                     \
+#define ARRAY_AT_CHECKED(type)                                                     \
+  extern "C" DEVICE type array_at_##type##_checked(int8_t* chunk_iter_,            \
+                                                   const uint64_t row_pos,         \
+                                                   const int64_t elem_idx,         \
+                                                   const type null_val) {          \
+    if (elem_idx <= 0) {                                                           \
+      return null_val;                                                             \
+    }                                                                              \
+    const ChunkIter* chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_); \
+    size_t length;                                                                 \
+    int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, row_pos, &length);      \
+    if (ChunkIter_is_null_varlen(chunk_iter, pointer, length) ||                   \
+        static_cast<size_t>(elem_idx) > length / sizeof(type)) {                   \
+      return null_val;                                                             \
+    }                                                                              \
+    return reinterpret_cast<type*>(pointer)[elem_idx - 1];                         \
   }
 
 ARRAY_AT_CHECKED(int8_t)
@@ -205,11 +201,9 @@ extern "C" DEVICE int8_t* allocate_varlen_buffer(int64_t element_count,
 }
 
 extern "C" DEVICE int8_t* array_buff(int8_t* chunk_iter_, const uint64_t row_pos) {
-  ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);
-  ArrayDatum ad;
-  bool is_end;
-  ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);
-  return ad.pointer;
+  size_t length;
+  return ChunkIter_get_nth_varlen(
+      reinterpret_cast<const ChunkIter*>(chunk_iter_), row_pos, &length);
 }
 
 #ifndef __CUDACC__
@@ -244,13 +238,12 @@ extern "C" ALWAYS_INLINE int64_t elem_bitcast_double(const double val) {
 #define COUNT_DISTINCT_ARRAY(type)                                                      \
   extern "C" void agg_count_distinct_array_##type(                                      \
       int64_t* agg, int8_t* chunk_iter_, const uint64_t row_pos, const type null_val) { \
-    ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);                  \
-    ArrayDatum ad;                                                                      \
-    bool is_end;                                                                        \
-    ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                               \
-    const size_t elem_count{ad.length / sizeof(type)};                                  \
+    const ChunkIter* chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_);      \
+    size_t length;                                                                      \
+    int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, row_pos, &length);           \
+    const size_t elem_count{length / sizeof(type)};                                     \
     for (size_t i = 0; i < elem_count; ++i) {                                           \
-      const auto val = reinterpret_cast<type*>(ad.pointer)[i];                          \
+      const auto val = reinterpret_cast<type*>(pointer)[i];                             \
       if (val != null_val) {                                                            \
         reinterpret_cast<std::set<int64_t>*>(*agg)->insert(elem_bitcast_##type(val));   \
       }                                                                                 \
@@ -278,14 +271,13 @@ extern "C" uint64_t string_decompress(const int32_t string_id,
                                                      const uint32_t needle_len,        \
                                                      const int64_t string_dict_handle, \
                                                      const type null_val) {            \
-    ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);                 \
-    ArrayDatum ad;                                                                     \
-    bool is_end;                                                                       \
-    ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                              \
-    const size_t elem_count = ad.length / sizeof(type);                                \
+    const ChunkIter* chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_);     \
+    size_t length;                                                                     \
+    int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, row_pos, &length);          \
+    const size_t elem_count = length / sizeof(type);                                   \
     std::string needle_str(needle_ptr, needle_len);                                    \
     for (size_t i = 0; i < elem_count; ++i) {                                          \
-      const type val = reinterpret_cast<type*>(ad.pointer)[i];                         \
+      const type val = reinterpret_cast<type*>(pointer)[i];                            \
       if (val != null_val) {                                                           \
         uint64_t str_and_len = string_decompress(val, string_dict_handle);             \
         const char* str = reinterpret_cast<const char*>(str_and_len & 0xffffffffffff); \
@@ -306,14 +298,13 @@ extern "C" uint64_t string_decompress(const int32_t string_id,
                                                      const uint32_t needle_len,        \
                                                      const int64_t string_dict_handle, \
                                                      const type null_val) {            \
-    ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);                 \
-    ArrayDatum ad;                                                                     \
-    bool is_end;                                                                       \
-    ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                              \
-    const size_t elem_count = ad.length / sizeof(type);                                \
+    const ChunkIter* chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_);     \
+    size_t length;                                                                     \
+    int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, row_pos, &length);          \
+    const size_t elem_count = length / sizeof(type);                                   \
     std::string needle_str(needle_ptr, needle_len);                                    \
     for (size_t i = 0; i < elem_count; ++i) {                                          \
-      const type val = reinterpret_cast<type*>(ad.pointer)[i];                         \
+      const type val = reinterpret_cast<type*>(pointer)[i];                            \
       if (val == null_val) {                                                           \
         return false;                                                                  \
       }                                                                                \
@@ -16,6 +16,7 @@
 
 #include "CalciteAdapter.h"
 #include "CalciteDeserializerUtils.h"
+#include "RelAlgBinaryPlan.h"
 
 #include "../Parser/ParserNode.h"
 #include "../Shared/StringTransform.h"
@@ -477,6 +478,9 @@ class CalciteAdapter {
     const auto& expr_type = expr["type"];
     CHECK(expr_type.IsObject());
     const auto agg_kind = to_agg_kind(expr["agg"].GetString());
+    if (agg_kind == kAPPROX_PERCENTILE) {
+      throw std::runtime_error("APPROX_PERCENTILE not supported by the legacy planner");
+    }
     const bool is_distinct = expr["distinct"].GetBool();
     const auto operand = get_agg_operand_idx(expr);
     const bool takes_arg{operand >= 0};
@@ -1122,7 +1126,12 @@ bool query_is_supported(const rapidjson::Value& rels) {
 Planner::RootPlan* translate_query(const std::string& query,
                                    const Catalog_Namespace::Catalog& cat) {
   rapidjson::Document query_ast;
-  query_ast.Parse(query.c_str());
+  // the legacy translation still walks the JSON document
+  if (RelAlgBinaryPlan::isBinaryPlan(query)) {
+    query_ast.Parse(RelAlgBinaryPlan(query).toJsonString().c_str());
+  } else {
+    query_ast.Parse(query.c_str());
+  }
   CHECK(!query_ast.HasParseError());
   CHECK(query_ast.IsObject());
   const auto& rels = query_ast["rels"];
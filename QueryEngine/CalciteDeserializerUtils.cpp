@@ -38,6 +38,8 @@ SQLTypeInfo get_agg_type(const SQLAgg agg_kind, const Analyzer::Expr* arg_expr)
       return SQLTypeInfo(kBIGINT, false);
     case kSAMPLE:
       return arg_expr->get_type_info();
+    case kAPPROX_PERCENTILE:
+      return SQLTypeInfo(kDOUBLE, false);
     default:
       CHECK(false);
   }
@@ -41,14 +41,18 @@ int64_t fixed_encoding_nullable_val(const int64_t val, const SQLTypeInfo& type_i
 
 ColumnarResults::ColumnarResults(
     const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
-    const ResultSet& rows,
+    const std::shared_ptr<const ResultSet>& rows_ptr,
     const size_t num_columns,
     const std::vector<SQLTypeInfo>& target_types)
     : column_buffers_(num_columns)
-    , num_rows_(use_parallel_algorithms(rows) || rows.isFastColumnarConversionPossible()
-                    ? rows.entryCount()
-                    : rows.rowCount())
+    , columns_in_place_(num_columns, false)
+    , num_rows_(use_parallel_algorithms(*rows_ptr) ||
+                        rows_ptr->isFastColumnarConversionPossible()
+                    ? rows_ptr->entryCount()
+                    : rows_ptr->rowCount())
     , target_types_(target_types) {
+  CHECK(rows_ptr);
+  const auto& rows = *rows_ptr;
   column_buffers_.resize(num_columns);
   for (size_t i = 0; i < num_columns; ++i) {
     const bool is_varlen = target_types[i].is_array() ||
@@ -58,6 +62,14 @@ ColumnarResults::ColumnarResults(
     if (is_varlen) {
       throw ColumnarConversionNotSupported();
     }
+    if (rows.isFastColumnarConversionPossible()) {
+      column_buffers_[i] = rows.getColumnBufferInPlace(i, target_types[i].get_size());
+      if (column_buffers_[i]) {
+        columns_in_place_[i] = true;
+        rows_ = rows_ptr;
+        continue;
+      }
+    }
     column_buffers_[i] = reinterpret_cast<const int8_t*>(
         checked_malloc(num_rows_ * target_types[i].get_size()));
     row_set_mem_owner->addColBuffer(column_buffers_[i]);
@@ -123,7 +135,10 @@ ColumnarResults::ColumnarResults(
     const int8_t* one_col_buffer,
     const size_t num_rows,
     const SQLTypeInfo& target_type)
-    : column_buffers_(1), num_rows_(num_rows), target_types_{target_type} {
+    : column_buffers_(1)
+    , columns_in_place_(1, false)
+    , num_rows_(num_rows)
+    , target_types_{target_type} {
   const bool is_varlen =
       target_type.is_array() ||
       (target_type.is_string() && target_type.get_compression() == kENCODING_NONE) ||
@@ -275,7 +290,7 @@ void ColumnarResults::copyAllNonLazyColumns(
   // parallelized by assigning each column to a thread
   std::vector<std::future<void>> direct_copy_threads;
   for (size_t col_idx = 0; col_idx < num_columns; col_idx++) {
-    if (is_column_non_lazily_fetched(col_idx)) {
+    if (is_column_non_lazily_fetched(col_idx) && !columns_in_place_[col_idx]) {
       direct_copy_threads.push_back(std::async(
           std::launch::async,
           [&rows, this](const size_t column_index) {
@@ -33,8 +33,10 @@ class ColumnarConversionNotSupported : public std::runtime_error {
 
 class ColumnarResults {
  public:
+  // Columns which the result set already holds as columns are used in place, with the
+  // result set kept alive for as long as they are.
   ColumnarResults(const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
-                  const ResultSet& rows,
+                  const std::shared_ptr<const ResultSet>& rows,
                   const size_t num_columns,
                   const std::vector<SQLTypeInfo>& target_types);
 
@@ -72,6 +74,8 @@ class ColumnarResults {
                                  const size_t num_columns);
 
   std::vector<const int8_t*> column_buffers_;
+  std::vector<bool> columns_in_place_;
+  std::shared_ptr<const ResultSet> rows_;  // owns the buffers of the columns in place
   size_t num_rows_;
   const std::vector<SQLTypeInfo> target_types_;
 };
@@ -75,10 +75,18 @@ float g_filter_push_down_low_frac{-1.0f};
 float g_filter_push_down_high_frac{-1.0f};
 size_t g_filter_push_down_passing_row_ubound{0};
 bool g_enable_columnar_output{false};
+bool g_enable_columnar_intermediate_results{false};
 bool g_enable_overlaps_hashjoin{false};
 double g_overlaps_hashjoin_bucket_threshold{0.1};
 bool g_strip_join_covered_quals{false};
 size_t g_constrained_by_in_threshold{10};
+double g_buffer_pool_scan_hint_fraction{0.5};
+size_t g_group_by_buffer_pool_bytes{1UL << 26};
+bool g_enable_cpu_radix_sort{true};
+bool g_limit_fragment_skipping{true};
+bool g_enable_limited_scan_early_exit{true};
+size_t g_limited_scan_max_kernels{0};  // 0 for as many as there are CPU threads
+double g_fragment_sample_rate{1.0};
 
 Executor::Executor(const int db_id,
                    const size_t block_size_x,
@@ -1116,10 +1124,14 @@ ResultSetPtr Executor::executeWorkUnit(
     if (is_agg) {
       try {
         OOM_TRACE_PUSH();
-        return collectAllDeviceResults(execution_dispatch,
-                                       ra_exe_unit.target_exprs,
-                                       query_mem_desc,
-                                       row_set_mem_owner);
+        auto result = collectAllDeviceResults(execution_dispatch,
+                                              ra_exe_unit.target_exprs,
+                                              query_mem_desc,
+                                              row_set_mem_owner);
+        if (fragment_descriptor.getSampleScale() != 1.0) {
+          result->scaleAggregates(fragment_descriptor.getSampleScale());
+        }
+        return result;
       } catch (ReductionRanOutOfSlots&) {
         *error_code = ERR_OUT_OF_SLOTS;
         std::vector<TargetInfo> targets;
@@ -1277,7 +1289,9 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
       }
     }
     const bool float_argument_input = takes_float_argument(agg_info);
-    if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+    if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        agg_info.agg_kind == kAPPROX_PERCENTILE) {
+      // no TDigest for the percentile, read back as NULL
       entry.push_back(0);
     } else if (agg_info.agg_kind == kAVG) {
       entry.push_back(inline_null_val(agg_info.agg_arg_type, float_argument_input));
@@ -1438,7 +1452,7 @@ void Executor::dispatchFragments(
                              const FragmentsList& frag_list,
                              const size_t ctx_idx,
                              const int64_t rowid_lookup_key)> dispatch,
-    const ExecutionDispatch& execution_dispatch,
+    ExecutionDispatch& execution_dispatch,
     const ExecutionOptions& eo,
     const bool is_agg,
     const size_t context_count,
@@ -1476,6 +1490,7 @@ void Executor::dispatchFragments(
   if (eo.with_watchdog && fragment_descriptor.shouldCheckWorkUnitWatchdog()) {
     checkWorkUnitWatchdog(ra_exe_unit, *catalog_);
   }
+  execution_dispatch.setLargeScan(isLargeScan(fragment_descriptor, device_type));
 
   if (use_multifrag_kernel) {
     // NB: We should never be on this path when the query is retried because of
@@ -1497,16 +1512,39 @@ void Executor::dispatchFragments(
 
   } else {
     size_t frag_list_idx{0};
-
-    auto fragment_per_kernel_dispatch =
-        [&query_threads, &dispatch, &context_count, &frag_list_idx, &device_type](
-            const int device_id,
-            const FragmentsList& frag_list,
-            const int64_t rowid_lookup_key) {
+    size_t num_skipped_kernels{0};
+    const bool is_limited_scan = execution_dispatch.isLimitedScan();
+    const size_t max_limited_scan_kernels =
+        g_limited_scan_max_kernels ? g_limited_scan_max_kernels
+                                   : std::max(available_cpus, 1);
+
+    auto fragment_per_kernel_dispatch = [&query_threads,
+                                         &dispatch,
+                                         &context_count,
+                                         &frag_list_idx,
+                                         &num_skipped_kernels,
+                                         &device_type,
+                                         &execution_dispatch,
+                                         is_limited_scan,
+                                         max_limited_scan_kernels](
+                                            const int device_id,
+                                            const FragmentsList& frag_list,
+                                            const int64_t rowid_lookup_key) {
           if (!frag_list.size()) {
             return;
           }
           CHECK_GE(device_id, 0);
+          if (is_limited_scan) {
+            // issued a few at a time, so that the rows found by the earlier kernels can
+            // make the later ones unnecessary before they start
+            if (query_threads.size() >= max_limited_scan_kernels) {
+              query_threads[query_threads.size() - max_limited_scan_kernels].wait();
+            }
+            if (execution_dispatch.isScanLimitReached(frag_list)) {
+              ++num_skipped_kernels;
+              return;
+            }
+          }
 
           query_threads.push_back(std::async(std::launch::async,
                                              dispatch,
@@ -1521,6 +1559,9 @@ void Executor::dispatchFragments(
 
     fragment_descriptor.assignFragsToKernelDispatch(fragment_per_kernel_dispatch,
                                                     ra_exe_unit);
+    if (num_skipped_kernels) {
+      VLOG(1) << "Skipped " << num_skipped_kernels << " of the kernels of a limited scan";
+    }
   }
   for (auto& child : query_threads) {
     child.wait();
@@ -1726,6 +1767,25 @@ bool Executor::needFetchAllFragments(const InputColDescriptor& inner_col_desc,
   return fragments.size() > 1;
 }
 
+bool Executor::isLargeScan(const QueryFragmentDescriptor& fragment_descriptor,
+                           const ExecutorDeviceType device_type) const {
+  if (g_buffer_pool_scan_hint_fraction <= 0) {
+    return false;
+  }
+  const auto memory_level = device_type == ExecutorDeviceType::GPU
+                                ? Data_Namespace::GPU_LEVEL
+                                : Data_Namespace::CPU_LEVEL;
+  auto& data_mgr = catalog_->getDataMgr();
+  for (const auto& device_input_bytes : fragment_descriptor.getInputBytesPerDevice()) {
+    const auto pool_bytes =
+        data_mgr.getBufferPoolSize(memory_level, device_input_bytes.first);
+    if (device_input_bytes.second >= g_buffer_pool_scan_hint_fraction * pool_bytes) {
+      return true;
+    }
+  }
+  return false;
+}
+
 Executor::FetchResult Executor::fetchChunks(
     const ExecutionDispatch& execution_dispatch,
     const RelAlgExecutionUnit& ra_exe_unit,
@@ -1737,6 +1797,8 @@ Executor::FetchResult Executor::fetchChunks(
     std::list<ChunkIter>& chunk_iterators,
     std::list<std::shared_ptr<Chunk_NS::Chunk>>& chunks) {
   INJECT_TIMER(fetchChunks);
+  // chunks of a scan taking up much of the buffer pool are evicted first from it
+  Buffer_Namespace::ScanHint scan_hint(execution_dispatch.isLargeScan());
   const auto& col_global_ids = ra_exe_unit.input_col_descs;
   std::vector<std::vector<size_t>> selected_fragments_crossjoin;
   std::vector<size_t> local_col_to_frag_pos;
@@ -1896,8 +1958,9 @@ class AggregateReductionEgress {
                         QueryExecutionContext* query_exe_context) {
     int64_t val1;
     const bool float_argument_input = takes_float_argument(agg_info);
-    if (is_distinct_target(agg_info)) {
-      CHECK(agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT);
+    if (is_distinct_target(agg_info) || is_approx_percentile_target(agg_info)) {
+      CHECK(agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+            agg_info.agg_kind == kAPPROX_PERCENTILE);
       val1 = out_vec[out_vec_idx][0];
       error_code = 0;
     } else {
@@ -2990,6 +3053,152 @@ std::pair<bool, int64_t> Executor::skipFragmentInnerJoins(
   return skip_frag;
 }
 
+std::vector<bool> Executor::skipFragmentsPastLimit(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments) {
+  std::vector<bool> skip_frags(fragments.size(), false);
+  const auto& sort_info = ra_exe_unit.sort_info;
+  if (!g_limit_fragment_skipping || !sort_info.limit ||
+      sort_info.order_entries.size() != 1 || ra_exe_unit.input_descs.size() != 1 ||
+      !ra_exe_unit.simple_quals.empty() || !ra_exe_unit.quals.empty() ||
+      !ra_exe_unit.join_quals.empty() || ra_exe_unit.estimator ||
+      ra_exe_unit.groupby_exprs.size() != 1 || ra_exe_unit.groupby_exprs.front()) {
+    return skip_frags;
+  }
+  const auto& table_desc = ra_exe_unit.input_descs.front();
+  if (table_desc.getSourceType() != InputSourceType::TABLE) {
+    return skip_frags;
+  }
+  const auto td = catalog_->getMetadataForTable(table_desc.getTableId());
+  CHECK(td);
+  if (catalog_->getDeletedColumnIfRowsDeleted(td)) {
+    // the deleted rows are filtered out by the generated code, so row counts don't hold
+    return skip_frags;
+  }
+  const auto& order_entry = sort_info.order_entries.front();
+  CHECK_GE(order_entry.tle_no, 1);
+  CHECK_LE(static_cast<size_t>(order_entry.tle_no), ra_exe_unit.target_exprs.size());
+  const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(
+      ra_exe_unit.target_exprs[order_entry.tle_no - 1]);
+  if (!col_var || col_var->get_rte_idx()) {
+    return skip_frags;
+  }
+  const auto& col_ti = col_var->get_type_info();
+  if (!col_ti.is_integer() && !col_ti.is_time() && !col_ti.is_decimal()) {
+    return skip_frags;
+  }
+  std::vector<std::pair<int64_t, int64_t>> frag_ranges;
+  std::vector<bool> frag_has_nulls;
+  for (const auto& fragment : fragments) {
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+    const auto chunk_meta_it = chunk_metadata_map.find(col_var->get_column_id());
+    if (chunk_meta_it == chunk_metadata_map.end()) {
+      return skip_frags;
+    }
+    const auto& chunk_stats = chunk_meta_it->second.chunkStats;
+    frag_ranges.emplace_back(extract_min_stat(chunk_stats, col_ti),
+                             extract_max_stat(chunk_stats, col_ti));
+    frag_has_nulls.push_back(chunk_stats.has_nulls);
+  }
+  // Going from the fragment with the first values on, find the value which at least
+  // limit + offset rows, all in fragments without nulls, come before or are equal to.
+  // The fragments with all their values after it have no rows to contribute.
+  std::vector<size_t> frag_order(fragments.size());
+  std::iota(frag_order.begin(), frag_order.end(), 0);
+  std::sort(frag_order.begin(),
+            frag_order.end(),
+            [&frag_ranges, &order_entry](const size_t lhs, const size_t rhs) {
+              const auto& lhs_range = frag_ranges[lhs];
+              const auto& rhs_range = frag_ranges[rhs];
+              return order_entry.is_desc ? lhs_range.second > rhs_range.second
+                                         : lhs_range.first < rhs_range.first;
+            });
+  const size_t row_count = sort_info.limit + sort_info.offset;
+  size_t covered_row_count{0};
+  int64_t bound{0};
+  for (const auto frag_idx : frag_order) {
+    const auto num_tuples = fragments[frag_idx].getNumTuples();
+    if (frag_has_nulls[frag_idx] || !num_tuples) {
+      continue;
+    }
+    const auto frag_bound =
+        order_entry.is_desc ? frag_ranges[frag_idx].first : frag_ranges[frag_idx].second;
+    bound = !covered_row_count
+                ? frag_bound
+                : (order_entry.is_desc ? std::min(bound, frag_bound)
+                                       : std::max(bound, frag_bound));
+    covered_row_count += num_tuples;
+    if (covered_row_count >= row_count) {
+      break;
+    }
+  }
+  if (covered_row_count < row_count) {
+    return skip_frags;
+  }
+  for (size_t frag_idx = 0; frag_idx < fragments.size(); ++frag_idx) {
+    if (!fragments[frag_idx].getNumTuples()) {
+      skip_frags[frag_idx] = true;
+      continue;
+    }
+    // nulls which come first can't be skipped
+    if (order_entry.nulls_first && frag_has_nulls[frag_idx]) {
+      continue;
+    }
+    skip_frags[frag_idx] = order_entry.is_desc ? frag_ranges[frag_idx].second < bound
+                                               : frag_ranges[frag_idx].first > bound;
+  }
+  return skip_frags;
+}
+
+std::vector<bool> Executor::skipFragmentsOutsideSample(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments) {
+  std::vector<bool> skip_frags(fragments.size(), false);
+  if (g_fragment_sample_rate <= 0 || g_fragment_sample_rate >= 1 ||
+      !ra_exe_unit.use_fragment_sampling || fragments.size() < 2 ||
+      ra_exe_unit.input_descs.size() != 1 || !ra_exe_unit.join_quals.empty() ||
+      ra_exe_unit.estimator ||
+      ra_exe_unit.sort_info.algorithm == SortAlgorithm::SpeculativeTopN) {
+    return skip_frags;
+  }
+  const auto& table_desc = ra_exe_unit.input_descs.front();
+  if (table_desc.getSourceType() != InputSourceType::TABLE) {
+    return skip_frags;
+  }
+  if (std::none_of(ra_exe_unit.target_exprs.begin(),
+                   ra_exe_unit.target_exprs.end(),
+                   [](const Analyzer::Expr* target_expr) {
+                     return target_info(target_expr).is_agg;
+                   })) {
+    return skip_frags;
+  }
+  // The fragments are picked by a hash of their ids rather than at random, so that the
+  // same query gives the same answer for as long as the table doesn't change.
+  const auto table_id = static_cast<uint64_t>(table_desc.getTableId());
+  const auto hash_fragment = [table_id](const int fragment_id) {
+    uint64_t h = (table_id << 32) ^ static_cast<uint32_t>(fragment_id);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return static_cast<double>(h ^ (h >> 31)) / std::numeric_limits<uint64_t>::max();
+  };
+  size_t min_hash_frag_idx{0};
+  double min_hash{2};
+  bool sampled_any{false};
+  for (size_t frag_idx = 0; frag_idx < fragments.size(); ++frag_idx) {
+    const auto h = hash_fragment(fragments[frag_idx].fragmentId);
+    skip_frags[frag_idx] = h >= g_fragment_sample_rate;
+    sampled_any = sampled_any || !skip_frags[frag_idx];
+    if (h < min_hash) {
+      min_hash = h;
+      min_hash_frag_idx = frag_idx;
+    }
+  }
+  if (!sampled_any) {
+    skip_frags[min_hash_frag_idx] = false;
+  }
+  return skip_frags;
+}
+
 llvm::Value* Executor::CgenState::emitCall(const std::string& fname,
                                            const std::vector<llvm::Value*>& args) {
   // Get the implementation from the runtime module.
@@ -85,10 +85,18 @@ extern float g_filter_push_down_low_frac;
 extern float g_filter_push_down_high_frac;
 extern size_t g_filter_push_down_passing_row_ubound;
 extern bool g_enable_columnar_output;
+extern bool g_enable_columnar_intermediate_results;
 extern bool g_enable_overlaps_hashjoin;
 extern double g_overlaps_hashjoin_bucket_threshold;
 extern bool g_strip_join_covered_quals;
 extern size_t g_constrained_by_in_threshold;
+extern double g_buffer_pool_scan_hint_fraction;
+extern size_t g_group_by_buffer_pool_bytes;
+extern bool g_enable_cpu_radix_sort;
+extern bool g_limit_fragment_skipping;
+extern bool g_enable_limited_scan_early_exit;
+extern size_t g_limited_scan_max_kernels;
+extern double g_fragment_sample_rate;
 
 class ExecutionResult;
 
@@ -192,7 +200,7 @@ inline const ColumnarResults* rows_to_columnar_results(
   for (size_t i = 0; i < result->colCount(); ++i) {
     col_types.push_back(get_logical_type_info(result->getColType(i)));
   }
-  return new ColumnarResults(row_set_mem_owner, *result, number, col_types);
+  return new ColumnarResults(row_set_mem_owner, result, number, col_types);
 }
 
 // TODO(alex): Adjust interfaces downstream and make this not needed.
@@ -758,6 +766,11 @@ class Executor {
     std::vector<std::pair<ResultSetPtr, std::vector<size_t>>> all_fragment_results_;
     std::atomic_flag dynamic_watchdog_set_ = ATOMIC_FLAG_INIT;
     static std::mutex reduce_mutex_;
+    // whether the chunks fetched are to be evicted first from the buffer pools
+    bool large_scan_{false};
+    // rows found by the finished kernels of a limited scan, by outer fragment id
+    mutable std::map<size_t, size_t> limited_scan_rows_per_fragment_;
+    mutable std::mutex limited_scan_mutex_;
 
     typedef std::vector<int> CacheKey;
     mutable std::mutex columnar_conversion_mutex_;
@@ -854,6 +867,17 @@ class Executor {
 
     std::string getIR(const ExecutorDeviceType device_type) const;
 
+    // A projection with a limit and no order, whose kernels can be left out once the
+    // kernels of the fragments before theirs have found the rows the limit keeps.
+    bool isLimitedScan() const;
+
+    bool isScanLimitReached(const FragmentsList& frag_list) const;
+
+    // Set before the kernels are dispatched.
+    void setLargeScan(const bool large_scan) { large_scan_ = large_scan; }
+
+    bool isLargeScan() const { return large_scan_; }
+
     ExecutorDeviceType getDeviceType() const;
 
     const RelAlgExecutionUnit& getExecutionUnit() const;
@@ -939,7 +963,7 @@ class Executor {
                                const FragmentsList& frag_list,
                                const size_t ctx_idx,
                                const int64_t rowid_lookup_key)> dispatch,
-      const ExecutionDispatch& execution_dispatch,
+      ExecutionDispatch& execution_dispatch,
       const ExecutionOptions& eo,
       const bool is_agg,
       const size_t context_count,
@@ -964,6 +988,9 @@ class Executor {
                         const RelAlgExecutionUnit& ra_exe_unit,
                         const ExecutorDeviceType device_type);
 
+  bool isLargeScan(const QueryFragmentDescriptor& fragment_descriptor,
+                   const ExecutorDeviceType device_type) const;
+
   FetchResult fetchChunks(const ExecutionDispatch&,
                           const RelAlgExecutionUnit& ra_exe_unit,
                           const int device_id,
@@ -1193,6 +1220,18 @@ class Executor {
       const std::vector<uint64_t>& frag_offsets,
       const size_t frag_idx);
 
+  // Flags the fragments which, going by their chunk metadata, can't hold any of the
+  // rows kept by the limit of a table scan ordered by a single column.
+  std::vector<bool> skipFragmentsPastLimit(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments);
+
+  // Flags the fragments left out of the sample an aggregate over a single table runs on
+  // when g_fragment_sample_rate is below 1, if the unit allows sampling.
+  std::vector<bool> skipFragmentsOutsideSample(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments);
+
   typedef std::vector<std::string> CodeCacheKey;
   typedef std::vector<std::tuple<void*,
                                  std::unique_ptr<llvm::ExecutionEngine>,
@@ -20,6 +20,7 @@
 
 #include "DataMgr/BufferMgr/BufferMgr.h"
 
+#include <algorithm>
 #include <numeric>
 
 std::mutex Executor::ExecutionDispatch::reduce_mutex_;
@@ -160,6 +161,9 @@ void Executor::ExecutionDispatch::runImpl(const ExecutorDeviceType chosen_device
   const auto& outer_tab_frag_ids = frag_list[0].fragment_ids;
   CHECK_GE(chosen_device_id, 0);
   CHECK_LT(chosen_device_id, max_gpu_count);
+  if (isScanLimitReached(frag_list)) {
+    return;
+  }
   // need to own them while query executes
   auto chunk_iterators_ptr = std::make_shared<std::list<ChunkIter>>();
   std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks;
@@ -321,6 +325,11 @@ void Executor::ExecutionDispatch::runImpl(const ExecutorDeviceType chosen_device
     device_results->holdChunks(chunks_to_hold);
     device_results->holdChunkIterators(chunk_iterators_ptr);
   }
+  if (!err && outer_tab_frag_ids.size() == 1 && isLimitedScan()) {
+    const size_t row_count = device_results ? device_results->rowCount() : 0;
+    std::lock_guard<std::mutex> lock(limited_scan_mutex_);
+    limited_scan_rows_per_fragment_[outer_tab_frag_ids.front()] = row_count;
+  }
   {
     std::lock_guard<std::mutex> lock(reduce_mutex_);
     if (err) {
@@ -668,6 +677,36 @@ std::string Executor::ExecutionDispatch::getIR(
   return compilation_result_gpu_.llvm_ir;
 }
 
+bool Executor::ExecutionDispatch::isLimitedScan() const {
+  // the scan limit alone may also come from the filtered count of a projection without
+  // any LIMIT, whose kernels all have to run
+  return g_enable_limited_scan_early_exit && ra_exe_unit_.scan_limit &&
+         ra_exe_unit_.sort_info.limit && ra_exe_unit_.sort_info.order_entries.empty() &&
+         ra_exe_unit_.groupby_exprs.size() == 1 && !ra_exe_unit_.groupby_exprs.front() &&
+         !ra_exe_unit_.estimator && !render_info_;
+}
+
+bool Executor::ExecutionDispatch::isScanLimitReached(
+    const FragmentsList& frag_list) const {
+  if (!isLimitedScan() || frag_list.empty() || frag_list.front().fragment_ids.empty()) {
+    return false;
+  }
+  const auto& outer_tab_frag_ids = frag_list.front().fragment_ids;
+  const auto first_frag_id =
+      *std::min_element(outer_tab_frag_ids.begin(), outer_tab_frag_ids.end());
+  // Only the fragments before count, so that the rows kept are the same as those of a
+  // full scan, whose results are merged in fragment order.
+  std::lock_guard<std::mutex> lock(limited_scan_mutex_);
+  size_t row_count{0};
+  for (const auto& frag_row_count : limited_scan_rows_per_fragment_) {
+    if (frag_row_count.first >= first_frag_id) {
+      break;
+    }
+    row_count += frag_row_count.second;
+  }
+  return row_count >= ra_exe_unit_.scan_limit;
+}
+
 ExecutorDeviceType Executor::ExecutionDispatch::getDeviceType() const {
   return co_.device_type_;
 }
@@ -94,7 +94,8 @@ bool expr_is_rowid(const Analyzer::Expr* expr, const Catalog_Namespace::Catalog&
 bool has_count_distinct(const RelAlgExecutionUnit& ra_exe_unit) {
   for (const auto& target_expr : ra_exe_unit.target_exprs) {
     const auto agg_info = target_info(target_expr);
-    if (agg_info.is_agg && is_distinct_target(agg_info)) {
+    if (agg_info.is_agg &&
+        (is_distinct_target(agg_info) || is_approx_percentile_target(agg_info))) {
       return true;
     }
   }
@@ -511,7 +512,7 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
       CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::StdSet};
       int64_t bitmap_sz_bits{0};
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
-        const auto error_rate = agg_expr->get_error_rate();
+        const auto error_rate = agg_expr->get_arg1();
         if (error_rate) {
           CHECK(error_rate->get_type_info().get_type() == kSMALLINT);
           CHECK_GE(error_rate->get_constval().smallintval, 1);
@@ -827,7 +828,8 @@ bool GroupByAndAggregate::gpuCanHandleOrderEntries(
     auto agg_expr = static_cast<Analyzer::AggExpr*>(target_expr);
     if (agg_expr->get_is_distinct() || agg_expr->get_aggtype() == kAVG ||
         agg_expr->get_aggtype() == kMIN || agg_expr->get_aggtype() == kMAX ||
-        agg_expr->get_aggtype() == kAPPROX_COUNT_DISTINCT) {
+        agg_expr->get_aggtype() == kAPPROX_COUNT_DISTINCT ||
+        agg_expr->get_aggtype() == kAPPROX_PERCENTILE) {
       return false;
     }
     if (agg_expr->get_arg()) {
@@ -1389,6 +1391,8 @@ std::vector<std::string> agg_fn_base_names(const TargetInfo& target_info) {
       return {"agg_approximate_count_distinct"};
     case kSAMPLE:
       return {"agg_id"};
+    case kAPPROX_PERCENTILE:
+      return {"agg_approx_percentile"};
     default:
       abort();
   }
@@ -1732,7 +1736,10 @@ bool GroupByAndAggregate::codegenAggCalls(
         agg_fname += "_int8";
       }
 
-      if (is_distinct_target(agg_info)) {
+      if (is_approx_percentile_target(agg_info)) {
+        CHECK_EQ(agg_chosen_bytes, sizeof(int64_t));
+        codegenApproxPercentile(target_expr, agg_args, need_skip_null, co.device_type_);
+      } else if (is_distinct_target(agg_info)) {
         CHECK_EQ(agg_chosen_bytes, sizeof(int64_t));
         CHECK(!chosen_type.is_fp());
         codegenCountDistinct(
@@ -1877,6 +1884,45 @@ extern "C" void agg_count_distinct_skip_val(int64_t* agg,
   }
 }
 
+extern "C" void agg_approx_percentile(int64_t* agg,
+                                      const double val,
+                                      const double quantile) {
+  auto t_digest = reinterpret_cast<TDigest*>(*agg);
+  t_digest->setQuantile(quantile);
+  t_digest->add(val);
+}
+
+extern "C" void agg_approx_percentile_skip_val(int64_t* agg,
+                                               const double val,
+                                               const double quantile,
+                                               const double skip_val) {
+  if (val != skip_val) {
+    agg_approx_percentile(agg, val, quantile);
+  }
+}
+
+void GroupByAndAggregate::codegenApproxPercentile(const Analyzer::Expr* target_expr,
+                                                  std::vector<llvm::Value*>& agg_args,
+                                                  const bool skip_null,
+                                                  const ExecutorDeviceType device_type) {
+  // the sketches live in host memory only, see the check in the compilation
+  CHECK(device_type == ExecutorDeviceType::CPU);
+  const auto agg_expr = static_cast<const Analyzer::AggExpr*>(target_expr);
+  const auto quantile = agg_expr->get_arg1();
+  CHECK(quantile);
+  CHECK_EQ(kDOUBLE, quantile->get_type_info().get_type());
+  CHECK_EQ(size_t(2), agg_args.size());
+  CHECK(agg_args.back()->getType()->isDoubleTy());
+  agg_args.push_back(LL_FP(quantile->get_constval().doubleval));
+  std::string agg_fname{"agg_approx_percentile"};
+  if (skip_null) {
+    agg_fname += "_skip_val";
+    agg_args.push_back(executor_->inlineFpNull(SQLTypeInfo(kDOUBLE, false)));
+  }
+  executor_->cgen_state_->emitExternalCall(
+      agg_fname, llvm::Type::getVoidTy(LL_CONTEXT), agg_args);
+}
+
 void GroupByAndAggregate::codegenCountDistinct(
     const size_t target_idx,
     const Analyzer::Expr* target_expr,
@@ -259,6 +259,11 @@ class GroupByAndAggregate {
                             const QueryMemoryDescriptor&,
                             const ExecutorDeviceType);
 
+  void codegenApproxPercentile(const Analyzer::Expr* target_expr,
+                               std::vector<llvm::Value*>& agg_args,
+                               const bool skip_null,
+                               const ExecutorDeviceType);
+
   llvm::Value* getAdditionalLiteral(const int32_t off);
 
   std::vector<llvm::Value*> codegenAggArg(const Analyzer::Expr* target_expr,
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    GroupByBufferPool.cpp
+ * @brief   Recycles the host memory of group by buffers across kernels and queries.
+ */
+
+#include "GroupByBufferPool.h"
+
+#include <Shared/checked_alloc.h>
+#include <glog/logging.h>
+
+#include <cstring>
+
+extern size_t g_group_by_buffer_pool_bytes;
+
+namespace {
+
+// below this, malloc is as fast as the pool and keeping the buffers isn't worth it
+constexpr size_t min_pooled_bytes{64 * 1024};
+
+}  // namespace
+
+GroupByBufferPool& GroupByBufferPool::instance() {
+  // never destroyed, since result sets held by other statics give buffers back on exit
+  static auto pool = new GroupByBufferPool();
+  return *pool;
+}
+
+int64_t* GroupByBufferPool::allocate(const size_t num_bytes) {
+  const auto size_class = getSizeClass(num_bytes);
+  auto buffer = takePooled(size_class);
+  return buffer ? buffer : static_cast<int64_t*>(checked_malloc(size_class));
+}
+
+int64_t* GroupByBufferPool::allocateZeroed(const size_t num_bytes) {
+  const auto size_class = getSizeClass(num_bytes);
+  auto buffer = takePooled(size_class);
+  if (buffer) {
+    memset(buffer, 0, num_bytes);
+    return buffer;
+  }
+  return static_cast<int64_t*>(checked_calloc(size_class, 1));
+}
+
+void GroupByBufferPool::release(int64_t* buffer, const size_t num_bytes) {
+  if (!buffer) {
+    return;
+  }
+  const auto size_class = getSizeClass(num_bytes);
+  if (size_class >= min_pooled_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pooled_bytes_ + size_class <= g_group_by_buffer_pool_bytes) {
+      free_buffers_[size_class].push_back(buffer);
+      pooled_bytes_ += size_class;
+      return;
+    }
+  }
+  free(buffer);
+}
+
+void GroupByBufferPool::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& size_class_buffers : free_buffers_) {
+    for (auto buffer : size_class_buffers.second) {
+      free(buffer);
+    }
+  }
+  free_buffers_.clear();
+  pooled_bytes_ = 0;
+}
+
+size_t GroupByBufferPool::getPooledBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pooled_bytes_;
+}
+
+size_t GroupByBufferPool::getSizeClass(const size_t num_bytes) {
+  if (num_bytes <= min_pooled_bytes) {
+    return num_bytes;
+  }
+  // rounded up to a multiple of a quarter of the highest power of two below num_bytes
+  const size_t shift = 63 - __builtin_clzll(num_bytes - 1) - 2;
+  return (((num_bytes - 1) >> shift) + 1) << shift;
+}
+
+int64_t* GroupByBufferPool::takePooled(const size_t size_class) {
+  if (size_class < min_pooled_bytes) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = free_buffers_.find(size_class);
+  if (it == free_buffers_.end() || it->second.empty()) {
+    return nullptr;
+  }
+  auto buffer = it->second.back();
+  it->second.pop_back();
+  pooled_bytes_ -= size_class;
+  return buffer;
+}
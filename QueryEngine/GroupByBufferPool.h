@@ -0,0 +1,67 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    GroupByBufferPool.h
+ * @brief   Recycles the host memory of group by buffers across kernels and queries.
+ */
+
+#ifndef QUERYENGINE_GROUPBYBUFFERPOOL_H
+#define QUERYENGINE_GROUPBYBUFFERPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * Buffers are handed out in size classes a quarter of a power of two apart, so a
+ * recycled buffer is at most a quarter larger than asked for. Released buffers are
+ * kept for the next request of their class, up to g_group_by_buffer_pool_bytes in
+ * total; the ones beyond, and buffers too small to be worth keeping, are freed.
+ */
+class GroupByBufferPool {
+ public:
+  static GroupByBufferPool& instance();
+
+  // Returns a buffer of at least num_bytes with undefined contents.
+  int64_t* allocate(const size_t num_bytes);
+
+  // Returns a zero filled buffer of at least num_bytes. Buffers the pool doesn't have
+  // come from calloc, so their pages are only faulted in once touched.
+  int64_t* allocateZeroed(const size_t num_bytes);
+
+  // Takes back a buffer allocated with num_bytes.
+  void release(int64_t* buffer, const size_t num_bytes);
+
+  void clear();
+
+  size_t getPooledBytes() const;
+
+  static size_t getSizeClass(const size_t num_bytes);
+
+ private:
+  GroupByBufferPool() : pooled_bytes_(0) {}
+
+  int64_t* takePooled(const size_t size_class);
+
+  std::map<size_t, std::vector<int64_t*>> free_buffers_;  // by size class
+  size_t pooled_bytes_;
+  mutable std::mutex mutex_;
+};
+
+#endif  // QUERYENGINE_GROUPBYBUFFERPOOL_H
@@ -27,7 +27,10 @@
 
 #include "CountDistinctDescriptor.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 inline double get_alpha(const size_t m) {
   switch (m) {
@@ -54,60 +57,95 @@ inline double get_beta(const uint32_t zeros) {
   return beta;
 }
 
-template <typename T>
-inline double get_harmonic_mean_denominator(T* M, uint32_t m) {
-  double accumulator = 0.0;
+struct HllRegisterStats {
+  double harmonic_mean_denominator;
+  uint32_t zeros;
+};
 
-  for (unsigned i = 0; i < m; i++) {
-    accumulator += (1.0 / (1ULL << M[i]));
-  }
-  return accumulator;
-}
+// Number of registers processed side by side by the loops below.
+constexpr size_t hll_lanes = 16;
 
+// Both statistics the estimators need, in a single pass. 2^-M[i] is built from its
+// exponent bits instead of divided out, and the sums are kept per lane, so that the loop
+// vectorizes without reassociating a single floating point sum.
 template <typename T>
-inline double get_beta_adjusted_estimate(const size_t m, const uint32_t z, T* M) {
-  return (get_alpha(m) * m * (m - z) *
-          (1 / (get_beta(z) + get_harmonic_mean_denominator(M, m))));
+inline HllRegisterStats get_register_stats(const T* M, const size_t m) {
+  double lane_sums[hll_lanes] = {};
+  uint32_t lane_zeros[hll_lanes] = {};
+  size_t i = 0;
+  for (; i + hll_lanes <= m; i += hll_lanes) {
+    for (size_t lane = 0; lane < hll_lanes; ++lane) {
+      const uint64_t rank = static_cast<uint8_t>(M[i + lane]);
+      const uint64_t inv_pow2_bits = (uint64_t(1023) - rank) << 52;
+      double inv_pow2;
+      std::memcpy(&inv_pow2, &inv_pow2_bits, sizeof(inv_pow2));
+      lane_sums[lane] += inv_pow2;
+      lane_zeros[lane] += rank == 0;
+    }
+  }
+  HllRegisterStats stats{0.0, 0};
+  for (; i < m; ++i) {
+    stats.harmonic_mean_denominator += 1.0 / (1ULL << M[i]);
+    stats.zeros += M[i] == 0;
+  }
+  for (size_t lane = 0; lane < hll_lanes; ++lane) {
+    stats.harmonic_mean_denominator += lane_sums[lane];
+    stats.zeros += lane_zeros[lane];
+  }
+  return stats;
 }
 
-template <typename T>
-inline double get_alpha_adjusted_estimate(const size_t m, T* M) {
-  return (get_alpha(m) * m * m) * (1 / get_harmonic_mean_denominator(M, m));
-};
+inline double get_beta_adjusted_estimate(const size_t m,
+                                         const uint32_t z,
+                                         const double harmonic_mean_denominator) {
+  return (get_alpha(m) * m * (m - z) * (1 / (get_beta(z) + harmonic_mean_denominator)));
+}
 
-template <typename T>
-inline uint32_t count_zeros(T* M, size_t m) {
-  uint32_t zeros = 0;
-  for (uint32_t i = 0; i < m; i++) {
-    if (M[i] == 0) {
-      zeros++;
-    }
-  }
-  return zeros;
+inline double get_alpha_adjusted_estimate(const size_t m,
+                                          const double harmonic_mean_denominator) {
+  return (get_alpha(m) * m * m) * (1 / harmonic_mean_denominator);
 }
 
 template <class T>
 inline size_t hll_size(const T* M, const size_t bitmap_sz_bits) {
   size_t m = 1 << bitmap_sz_bits;
 
-  uint32_t zeros = count_zeros(M, m);
-  double estimate = get_alpha_adjusted_estimate(m, M);
+  const auto stats = get_register_stats(M, m);
+  const uint32_t zeros = stats.zeros;
+  double estimate = get_alpha_adjusted_estimate(m, stats.harmonic_mean_denominator);
   if (estimate <= 2.5 * m) {
     if (zeros != 0) {
       estimate = m * log(static_cast<double>(m) / zeros);
     }
   } else {
     if (bitmap_sz_bits == 14) {  // Apply LogLog-Beta adjustment only when p=14
-      estimate = get_beta_adjusted_estimate(m, zeros, M);
+      estimate = get_beta_adjusted_estimate(m, zeros, stats.harmonic_mean_denominator);
     }
   }
   // No correction for large estimates since we're using 64-bit hashes.
   return estimate;
 }
 
+// The registers are merged a block at a time through a local copy, so that the max runs
+// on whole vectors even though lhs and rhs can differ in width and aren't known not to
+// alias.
 template <class T1, class T2>
 inline void hll_unify(T1* lhs, T2* rhs, const size_t m) {
-  for (size_t r = 0; r < m; ++r) {
+  size_t r = 0;
+  for (; r + hll_lanes <= m; r += hll_lanes) {
+    int8_t merged[hll_lanes];
+    for (size_t lane = 0; lane < hll_lanes; ++lane) {
+      merged[lane] = std::max(static_cast<int8_t>(lhs[r + lane]),
+                              static_cast<int8_t>(rhs[r + lane]));
+    }
+    for (size_t lane = 0; lane < hll_lanes; ++lane) {
+      lhs[r + lane] = merged[lane];
+    }
+    for (size_t lane = 0; lane < hll_lanes; ++lane) {
+      rhs[r + lane] = merged[lane];
+    }
+  }
+  for (; r < m; ++r) {
     rhs[r] = lhs[r] = std::max(static_cast<int8_t>(lhs[r]), static_cast<int8_t>(rhs[r]));
   }
 }
@@ -25,22 +25,17 @@
 #include "RuntimeFunctions.h"
 
 #include <glog/logging.h>
-#include <boost/multiprecision/cpp_int.hpp>
+#include <algorithm>
+#include <cstring>
 #include <limits>
 
-using checked_int64_t = boost::multiprecision::number<
-    boost::multiprecision::cpp_int_backend<64,
-                                           64,
-                                           boost::multiprecision::signed_magnitude,
-                                           boost::multiprecision::checked,
-                                           void>>;
-
 InValuesBitmap::InValuesBitmap(const std::vector<int64_t>& values,
                                const int64_t null_val,
                                const Data_Namespace::MemoryLevel memory_level,
                                const int device_count,
                                Data_Namespace::DataMgr* data_mgr)
-    : rhs_has_null_(false)
+    : sorted_set_size_(0)
+    , rhs_has_null_(false)
     , null_val_(null_val)
     , memory_level_(memory_level)
     , device_count_(device_count) {
@@ -73,19 +68,43 @@ InValuesBitmap::InValuesBitmap(const std::vector<int64_t>& values,
     CHECK(rhs_has_null_);
     return;
   }
-  const int64_t MAX_BITMAP_BITS{8 * 1000 * 1000 * 1000L};
-  const auto bitmap_sz_bits =
-      static_cast<int64_t>(checked_int64_t(max_val_) - min_val_ + 1);
-  if (bitmap_sz_bits > MAX_BITMAP_BITS) {
-    throw FailedToCreateBitmap();
-  }
-  const auto bitmap_sz_bytes = bitmap_bits_to_bytes(bitmap_sz_bits);
-  auto cpu_bitset = static_cast<int8_t*>(checked_calloc(bitmap_sz_bytes, 1));
-  for (const auto value : values) {
-    if (value == null_val) {
-      continue;
+  const uint64_t MAX_BITMAP_BITS{8 * 1000 * 1000 * 1000UL};
+  // past the caches, where every probe of a bitmap misses anyway, a bitmap much larger
+  // than the sorted values loses to a binary search over them
+  const size_t MIN_SPARSE_BITMAP_BYTES{16 * 1024 * 1024};
+  const size_t MIN_SPARSE_BITMAP_RATIO{64};
+  const uint64_t span = static_cast<uint64_t>(max_val_) - static_cast<uint64_t>(min_val_);
+  const size_t sorted_set_bytes = values.size() * sizeof(int64_t);
+  int8_t* cpu_bitset{nullptr};
+  size_t bitmap_sz_bytes{0};
+  if (span >= MAX_BITMAP_BITS ||
+      (span / 8 > MIN_SPARSE_BITMAP_BYTES &&
+       span / 8 > MIN_SPARSE_BITMAP_RATIO * sorted_set_bytes)) {
+    std::vector<int64_t> sorted_values;
+    sorted_values.reserve(values.size());
+    for (const auto value : values) {
+      if (value != null_val) {
+        sorted_values.push_back(value);
+      }
+    }
+    std::sort(sorted_values.begin(), sorted_values.end());
+    sorted_values.erase(std::unique(sorted_values.begin(), sorted_values.end()),
+                        sorted_values.end());
+    sorted_set_size_ = sorted_values.size();
+    bitmap_sz_bytes = sorted_set_size_ * sizeof(int64_t);
+    cpu_bitset = static_cast<int8_t*>(checked_malloc(bitmap_sz_bytes));
+    memcpy(cpu_bitset, sorted_values.data(), bitmap_sz_bytes);
+  } else {
+    const auto bitmap_sz_bits = static_cast<int64_t>(span + 1);
+    bitmap_sz_bytes = bitmap_bits_to_bytes(bitmap_sz_bits);
+    cpu_bitset = static_cast<int8_t*>(checked_calloc(bitmap_sz_bytes, 1));
+    for (const auto value : values) {
+      if (value == null_val) {
+        continue;
+      }
+      agg_count_distinct_bitmap(
+          reinterpret_cast<int64_t*>(&cpu_bitset), value, min_val_);
     }
-    agg_count_distinct_bitmap(reinterpret_cast<int64_t*>(&cpu_bitset), value, min_val_);
   }
 #ifdef HAVE_CUDA
   if (memory_level_ == Data_Namespace::GPU_LEVEL) {
@@ -133,6 +152,15 @@ llvm::Value* InValuesBitmap::codegen(llvm::Value* needle, Executor* executor) co
   const auto needle_i64 = executor->castToTypeIn(needle, 64);
   const auto null_bool_val =
       static_cast<int8_t>(inline_int_null_val(SQLTypeInfo(kBOOLEAN, false)));
+  if (isSortedSet()) {
+    return executor->cgen_state_->emitCall(
+        "value_in_sorted_set",
+        {executor->castToTypeIn(bitset_handle_lvs.front(), 64),
+         executor->ll_int(static_cast<int64_t>(sorted_set_size_)),
+         needle_i64,
+         executor->ll_int(null_val_),
+         executor->ll_int(null_bool_val)});
+  }
   return executor->cgen_state_->emitCall(
       "bit_is_set",
       {executor->castToTypeIn(bitset_handle_lvs.front(), 64),
@@ -150,3 +178,7 @@ bool InValuesBitmap::isEmpty() const {
 bool InValuesBitmap::hasNull() const {
   return rhs_has_null_;
 }
+
+bool InValuesBitmap::isSortedSet() const {
+  return sorted_set_size_ != 0;
+}
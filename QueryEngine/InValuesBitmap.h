@@ -34,11 +34,11 @@
 
 class Executor;
 
-class FailedToCreateBitmap : public std::runtime_error {
- public:
-  FailedToCreateBitmap() : std::runtime_error("FailedToCreateBitmap") {}
-};
-
+/**
+ * Tests integers against the values of an IN list. The list becomes a bitmap over the
+ * span of its values, unless that would be too large or too sparse; then it becomes a
+ * sorted array of the values instead, which is binary searched.
+ */
 class InValuesBitmap {
  public:
   InValuesBitmap(const std::vector<int64_t>& values,
@@ -54,8 +54,11 @@ class InValuesBitmap {
 
   bool hasNull() const;
 
+  bool isSortedSet() const;
+
  private:
-  std::vector<int8_t*> bitsets_;
+  std::vector<int8_t*> bitsets_;  // or sorted sets, one per device
+  size_t sorted_set_size_;        // zero for bitmaps
   bool rhs_has_null_;
   int64_t min_val_;
   int64_t max_val_;
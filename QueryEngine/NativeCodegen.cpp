@@ -980,6 +980,9 @@ std::vector<std::string> get_agg_fnames(const std::vector<Analyzer::Expr*>& targ
       case kAPPROX_COUNT_DISTINCT:
         result.emplace_back("agg_approximate_count_distinct");
         break;
+      case kAPPROX_PERCENTILE:
+        result.emplace_back("agg_approx_percentile");
+        break;
       default:
         CHECK(false);
     }
@@ -1344,6 +1347,11 @@ Executor::CompilationResult Executor::compileWorkUnit(
         throw QueryMustRunOnCpu();
       }
     }
+    for (const auto target_expr : ra_exe_unit.target_exprs) {
+      if (is_approx_percentile_target(target_info(target_expr))) {
+        throw QueryMustRunOnCpu();
+      }
+    }
   }
 
   // Read the module template and target either CPU or GPU
@@ -185,6 +185,7 @@ int64_t get_agg_initial_val(const SQLAgg agg,
     }
     case kCOUNT:
     case kAPPROX_COUNT_DISTINCT:
+    case kAPPROX_PERCENTILE:
       return 0;
     case kMIN: {
       switch (byte_width) {
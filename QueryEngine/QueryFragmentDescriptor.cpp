@@ -91,9 +91,17 @@ void QueryFragmentDescriptor::buildFragmentPerKernelMap(
   outer_fragments_size_ = outer_fragments->size();
 
   const auto num_bytes_for_row = executor->getNumBytesForFetchedRow();
+  const auto skip_frags_past_limit =
+      executor->skipFragmentsPastLimit(ra_exe_unit, *outer_fragments);
+  const auto skip_frags_outside_sample =
+      executor->skipFragmentsOutsideSample(ra_exe_unit, *outer_fragments);
+  computeSampleScale(*outer_fragments, skip_frags_outside_sample);
 
   for (size_t i = 0; i < outer_fragments->size(); ++i) {
     const auto& fragment = (*outer_fragments)[i];
+    if (skip_frags_past_limit[i] || skip_frags_outside_sample[i]) {
+      continue;
+    }
     const auto skip_frag = executor->skipFragment(
         outer_table_desc, fragment, ra_exe_unit.simple_quals, frag_offsets, i);
     if (skip_frag.first) {
@@ -115,6 +123,7 @@ void QueryFragmentDescriptor::buildFragmentPerKernelMap(
     if (device_type == ExecutorDeviceType::GPU) {
       checkDeviceMemoryUsage(fragment, device_id, num_bytes_for_row);
     }
+    input_bytes_per_device_[device_id] += fragment.getNumTuples() * num_bytes_for_row;
     // Since we may have skipped fragments, the fragments_per_kernel_ vector may be
     // smaller than the outer_fragments size
     CHECK_LE(fragments_per_kernel_.size(), i);
@@ -160,10 +169,19 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
 
   const auto inner_table_id_to_join_condition = executor->getInnerTabIdToJoinCond();
   const auto num_bytes_for_row = executor->getNumBytesForFetchedRow();
+  const auto skip_frags_past_limit =
+      executor->skipFragmentsPastLimit(ra_exe_unit, *outer_fragments);
+  const auto skip_frags_outside_sample =
+      executor->skipFragmentsOutsideSample(ra_exe_unit, *outer_fragments);
+  computeSampleScale(*outer_fragments, skip_frags_outside_sample);
 
   for (size_t outer_frag_id = 0; outer_frag_id < outer_fragments->size();
        ++outer_frag_id) {
     const auto& fragment = (*outer_fragments)[outer_frag_id];
+    if (skip_frags_past_limit[outer_frag_id] ||
+        skip_frags_outside_sample[outer_frag_id]) {
+      continue;
+    }
     auto skip_frag = executor->skipFragment(outer_table_desc,
                                             fragment,
                                             ra_exe_unit.simple_quals,
@@ -184,6 +202,7 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
     if (device_type == ExecutorDeviceType::GPU) {
       checkDeviceMemoryUsage(fragment, device_id, num_bytes_for_row);
     }
+    input_bytes_per_device_[device_id] += fragment.getNumTuples() * num_bytes_for_row;
     for (size_t j = 0; j < ra_exe_unit.input_descs.size(); ++j) {
       const auto table_id = ra_exe_unit.input_descs[j].getTableId();
       auto table_frags_it = selected_tables_fragments_.find(table_id);
@@ -221,6 +240,26 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
   }
 }
 
+void QueryFragmentDescriptor::computeSampleScale(
+    const TableFragments& fragments,
+    const std::vector<bool>& skip_frags_outside_sample) {
+  size_t total_tuple_count{0};
+  size_t sampled_tuple_count{0};
+  for (size_t i = 0; i < fragments.size(); ++i) {
+    const auto num_tuples = fragments[i].getNumTuples();
+    total_tuple_count += num_tuples;
+    if (!skip_frags_outside_sample[i]) {
+      sampled_tuple_count += num_tuples;
+    }
+  }
+  sample_scale_ = 1.0;
+  if (sampled_tuple_count && sampled_tuple_count < total_tuple_count) {
+    sample_scale_ = static_cast<double>(total_tuple_count) / sampled_tuple_count;
+    VLOG(1) << "Sampled " << sampled_tuple_count << " of " << total_tuple_count
+            << " rows, the counts and sums get scaled by " << sample_scale_;
+  }
+}
+
 namespace {
 
 bool is_sample_query(const RelAlgExecutionUnit& ra_exe_unit) {
@@ -100,6 +100,16 @@ class QueryFragmentDescriptor {
     }
   }
 
+  // The factor the counts and sums computed over the fragments sampled are to be scaled
+  // by to estimate those over the whole table, 1 if the query wasn't sampled.
+  double getSampleScale() const { return sample_scale_; }
+
+  // The bytes the kernels of each device fetch for the rows of the outer table
+  // fragments selected, estimated the same way as for the device memory check.
+  const std::map<int, size_t>& getInputBytesPerDevice() const {
+    return input_bytes_per_device_;
+  }
+
   bool shouldCheckWorkUnitWatchdog() const {
     return rowid_lookup_key_ < 0 && fragments_per_kernel_.size() > 0;
   }
@@ -107,6 +117,7 @@ class QueryFragmentDescriptor {
  protected:
   size_t outer_fragments_size_ = 0;
   int64_t rowid_lookup_key_ = -1;
+  double sample_scale_ = 1.0;
 
   std::map<int, const TableFragments*> selected_tables_fragments_;
 
@@ -117,6 +128,7 @@ class QueryFragmentDescriptor {
   double gpu_input_mem_limit_percent_;
   std::map<size_t, size_t> tuple_count_per_device_;
   std::map<size_t, size_t> available_gpu_mem_bytes_;
+  std::map<int, size_t> input_bytes_per_device_;
 
   void buildFragmentPerKernelMap(const RelAlgExecutionUnit& ra_exe_unit,
                                  const std::vector<uint64_t>& frag_offsets,
@@ -139,6 +151,9 @@ class QueryFragmentDescriptor {
     }
   }
 
+  void computeSampleScale(const TableFragments& fragments,
+                          const std::vector<bool>& skip_frags_outside_sample);
+
   bool terminateDispatchMaybe(const RelAlgExecutionUnit& ra_exe_unit,
                               const size_t kernel_id) const;
 
@@ -19,13 +19,19 @@
 #include "Execute.h"
 #include "GpuInitGroups.h"
 #include "GpuMemUtils.h"
+#include "GroupByBufferPool.h"
 #include "ResultRows.h"
 #include "ResultSet.h"
 #include "StreamingTopN.h"
 
 #include <Shared/checked_alloc.h>
+#include <Shared/scope.h>
+#include <Shared/thread_count.h>
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <future>
+
 namespace {
 
 void check_total_bitmap_memory(const QueryMemoryDescriptor& query_mem_desc) {
@@ -68,7 +74,78 @@ int64_t* alloc_group_by_buffer(const size_t numBytes,
     auto render_allocator_ptr = render_allocator_map->getRenderAllocator(gpu_idx);
     return reinterpret_cast<int64_t*>(render_allocator_ptr->alloc(numBytes));
   } else {
-    return reinterpret_cast<int64_t*>(checked_malloc(numBytes));
+    return GroupByBufferPool::instance().allocate(numBytes);
+  }
+}
+
+// below this, a copy isn't worth splitting between threads
+constexpr size_t min_parallel_copy_bytes{8 * 1024 * 1024};
+
+void parallel_memcpy(int8_t* dst, const int8_t* src, const size_t num_bytes) {
+  const size_t thread_count = std::min(static_cast<size_t>(cpu_threads()),
+                                       num_bytes / min_parallel_copy_bytes);
+  if (thread_count < 2) {
+    memcpy(dst, src, num_bytes);
+    return;
+  }
+  const size_t stride = (num_bytes + thread_count - 1) / thread_count;
+  std::vector<std::future<void>> copies;
+  for (size_t start = 0; start < num_bytes; start += stride) {
+    const size_t size = std::min(stride, num_bytes - start);
+    copies.push_back(std::async(std::launch::async, [dst, src, start, size] {
+      memcpy(dst + start, src + start, size);
+    }));
+  }
+  for (auto& copy : copies) {
+    copy.get();
+  }
+}
+
+// Fills entry_count rows of row_size bytes with copies of row. The copies double up to
+// a block which stays in the cache, which is then copied over the rest of the buffer.
+void fill_rows(int8_t* buffer,
+               const int8_t* row,
+               const size_t row_size,
+               const size_t entry_count) {
+  if (!entry_count) {
+    return;
+  }
+  constexpr size_t max_block_bytes{64 * 1024};
+  const size_t block_entry_count =
+      std::min(entry_count, std::max(max_block_bytes / row_size, size_t(1)));
+  memcpy(buffer, row, row_size);
+  for (size_t filled = 1; filled < block_entry_count; filled *= 2) {
+    memcpy(buffer + filled * row_size,
+           buffer,
+           std::min(filled, block_entry_count - filled) * row_size);
+  }
+  const size_t block_size = block_entry_count * row_size;
+  const size_t buffer_size = entry_count * row_size;
+  const size_t block_count = (entry_count + block_entry_count - 1) / block_entry_count;
+  auto copy_blocks = [buffer, block_size, buffer_size](const size_t first_block,
+                                                       const size_t end_block) {
+    for (size_t block = first_block; block < end_block; ++block) {
+      const size_t offset = block * block_size;
+      memcpy(buffer + offset, buffer, std::min(block_size, buffer_size - offset));
+    }
+  };
+  const size_t thread_count = std::min(static_cast<size_t>(cpu_threads()),
+                                       buffer_size / min_parallel_copy_bytes);
+  if (thread_count < 2) {
+    copy_blocks(1, block_count);
+    return;
+  }
+  const size_t blocks_per_thread = (block_count + thread_count - 1) / thread_count;
+  std::vector<std::future<void>> copies;
+  for (size_t first_block = 1; first_block < block_count;
+       first_block += blocks_per_thread) {
+    copies.push_back(std::async(std::launch::async,
+                                copy_blocks,
+                                first_block,
+                                std::min(first_block + blocks_per_thread, block_count)));
+  }
+  for (auto& copy : copies) {
+    copy.get();
   }
 }
 
@@ -125,15 +202,27 @@ QueryMemoryInitializer::QueryMemoryInitializer(
   const auto group_buffer_size =
       query_mem_desc.getBufferSizeBytes(ra_exe_unit, thread_count, device_type);
   OOM_TRACE_PUSH(+": group_buffer_size " + std::to_string(group_buffer_size));
-  std::unique_ptr<int64_t, CheckedAllocDeleter> group_by_buffer_template(
-      static_cast<int64_t*>(checked_malloc(group_buffer_size)));
 
-  if (!query_mem_desc.lazyInitGroups(device_type)) {
+  const bool init_groups = !query_mem_desc.lazyInitGroups(device_type);
+  // buffers whose rows all start out as zeros are left to calloc, which only faults in
+  // the pages the kernels touch
+  const bool zero_init_groups = init_groups && !output_columnar &&
+                                !render_allocator_map &&
+                                !use_streaming_top_n(ra_exe_unit, query_mem_desc) &&
+                                hasZeroTemplateRow(query_mem_desc, executor);
+  int64_t* group_by_buffer_template{nullptr};
+  ScopeGuard release_group_by_buffer_template = [&group_by_buffer_template,
+                                                 group_buffer_size] {
+    GroupByBufferPool::instance().release(group_by_buffer_template, group_buffer_size);
+  };
+
+  if (init_groups && !zero_init_groups) {
+    group_by_buffer_template = GroupByBufferPool::instance().allocate(group_buffer_size);
     if (output_columnar) {
       initColumnarGroups(
-          query_mem_desc, group_by_buffer_template.get(), init_agg_vals_, executor);
+          query_mem_desc, group_by_buffer_template, init_agg_vals_, executor);
     } else {
-      auto rows_ptr = group_by_buffer_template.get();
+      auto rows_ptr = group_by_buffer_template;
       auto actual_entry_count = query_mem_desc.getEntryCount();
       auto warp_size =
           query_mem_desc.interleavedBins(device_type) ? executor->warpSize() : 1;
@@ -176,15 +265,25 @@ QueryMemoryInitializer::QueryMemoryInitializer(
 
   for (size_t i = 0; i < group_buffers_count; i += step) {
     OOM_TRACE_PUSH(+": group_by_buffer " + std::to_string(actual_group_buffer_size));
-    auto group_by_buffer =
-        alloc_group_by_buffer(actual_group_buffer_size, render_allocator_map);
-    if (!query_mem_desc.lazyInitGroups(device_type)) {
-      memcpy(group_by_buffer + index_buffer_qw,
-             group_by_buffer_template.get(),
-             group_buffer_size);
+    int64_t* group_by_buffer{nullptr};
+    if (zero_init_groups) {
+      group_by_buffer =
+          GroupByBufferPool::instance().allocateZeroed(actual_group_buffer_size);
+    } else if (group_by_buffer_template && !render_allocator_map &&
+               !index_buffer_qw && i + step >= group_buffers_count) {
+      // the last buffer is the template itself rather than a copy of it
+      std::swap(group_by_buffer, group_by_buffer_template);
+    } else {
+      group_by_buffer =
+          alloc_group_by_buffer(actual_group_buffer_size, render_allocator_map);
+      if (init_groups) {
+        parallel_memcpy(reinterpret_cast<int8_t*>(group_by_buffer + index_buffer_qw),
+                        reinterpret_cast<const int8_t*>(group_by_buffer_template),
+                        group_buffer_size);
+      }
     }
     if (!render_allocator_map) {
-      row_set_mem_owner_->addGroupByBuffer(group_by_buffer);
+      row_set_mem_owner_->addGroupByBuffer(group_by_buffer, actual_group_buffer_size);
     }
     group_by_buffers_.push_back(group_by_buffer);
     for (size_t j = 1; j < step; ++j) {
@@ -232,6 +331,21 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
   if (query_mem_desc.hasKeylessHash()) {
     CHECK(warp_size >= 1);
     CHECK(key_count == 1);
+  }
+  const auto template_row =
+      getTemplateRow(query_mem_desc_fixedup, init_vals, agg_bitmap_size);
+  if (!template_row.empty()) {
+    CHECK_EQ(row_size, template_row.size());
+    fill_rows(buffer_ptr,
+              template_row.data(),
+              row_size,
+              static_cast<size_t>(groups_buffer_entry_count) *
+                  (query_mem_desc.hasKeylessHash() ? warp_size : 1));
+    return;
+  }
+
+  // each row gets count distinct buffers of its own
+  if (query_mem_desc.hasKeylessHash()) {
     for (size_t warp_idx = 0; warp_idx < warp_size; ++warp_idx) {
       for (size_t bin = 0; bin < static_cast<size_t>(groups_buffer_entry_count);
            ++bin, buffer_ptr += row_size) {
@@ -256,6 +370,43 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
   }
 }
 
+std::vector<int8_t> QueryMemoryInitializer::getTemplateRow(
+    const QueryMemoryDescriptor& query_mem_desc,
+    const std::vector<int64_t>& init_vals,
+    const std::vector<ssize_t>& bitmap_sizes) {
+  if (query_mem_desc.isGroupBy() &&
+      std::any_of(bitmap_sizes.begin(), bitmap_sizes.end(), [](const ssize_t bm_sz) {
+        return bm_sz != 0;
+      })) {
+    return {};
+  }
+  std::vector<int8_t> row(query_mem_desc.getRowSize(), 0);
+  if (!query_mem_desc.hasKeylessHash()) {
+    fill_empty_key(row.data(),
+                   query_mem_desc.groupColWidthsSize(),
+                   query_mem_desc.getEffectiveKeyWidth());
+  }
+  initColumnPerRow(query_mem_desc,
+                   &row[query_mem_desc.getColOffInBytes(0)],
+                   0,
+                   init_vals,
+                   bitmap_sizes);
+  return row;
+}
+
+bool QueryMemoryInitializer::hasZeroTemplateRow(
+    const QueryMemoryDescriptor& query_mem_desc,
+    const Executor* executor) {
+  const auto template_row =
+      getTemplateRow(ResultSet::fixupQueryMemoryDescriptor(query_mem_desc),
+                     init_agg_vals_,
+                     allocateCountDistinctBuffers(query_mem_desc, true, executor));
+  return !template_row.empty() &&
+         std::all_of(template_row.begin(), template_row.end(), [](const int8_t byte) {
+           return byte == 0;
+         });
+}
+
 namespace {
 
 template <typename T>
@@ -277,7 +428,7 @@ void QueryMemoryInitializer::initColumnarGroups(
   CHECK(groups_buffer);
   for (const auto target_expr : executor->plan_state_->target_exprs_) {
     const auto agg_info = target_info(target_expr);
-    CHECK(!is_distinct_target(agg_info));
+    CHECK(!is_distinct_target(agg_info) && !is_approx_percentile_target(agg_info));
   }
   const int32_t agg_col_count = query_mem_desc.getColCount();
   auto buffer_ptr = reinterpret_cast<int8_t*>(groups_buffer);
@@ -346,8 +497,8 @@ void QueryMemoryInitializer::initColumnPerRow(const QueryMemoryDescriptor& query
     } else {
       CHECK_EQ(static_cast<size_t>(query_mem_desc.getColumnWidth(col_idx).compact),
                sizeof(int64_t));
-      init_val =
-          bm_sz > 0 ? allocateCountDistinctBitmap(bm_sz) : allocateCountDistinctSet();
+      init_val = bm_sz > 0 ? allocateCountDistinctBitmap(bm_sz)
+                           : bm_sz == -1 ? allocateCountDistinctSet() : allocateTDigest();
       ++init_vec_idx;
     }
     switch (query_mem_desc.getColumnWidth(col_idx).compact) {
@@ -410,7 +561,7 @@ void QueryMemoryInitializer::allocateCountDistinctGpuMem(
 }
 
 // deferred is true for group by queries; initGroups will allocate a bitmap
-// for each group slot
+// for each group slot. The size is -1 for a std::set and -2 for a TDigest.
 std::vector<ssize_t> QueryMemoryInitializer::allocateCountDistinctBuffers(
     const QueryMemoryDescriptor& query_mem_desc,
     const bool deferred,
@@ -449,6 +600,15 @@ std::vector<ssize_t> QueryMemoryInitializer::allocateCountDistinctBuffers(
         }
       }
     }
+    if (is_approx_percentile_target(agg_info)) {
+      CHECK_EQ(static_cast<size_t>(query_mem_desc.getColumnWidth(agg_col_idx).actual),
+               sizeof(int64_t));
+      if (deferred) {
+        agg_bitmap_size[agg_col_idx] = -2;
+      } else {
+        init_agg_vals_[agg_col_idx] = allocateTDigest();
+      }
+    }
     if (agg_info.agg_kind == kAVG) {
       ++agg_col_idx;
     }
@@ -477,6 +637,12 @@ int64_t QueryMemoryInitializer::allocateCountDistinctSet() {
   return reinterpret_cast<int64_t>(count_distinct_set);
 }
 
+int64_t QueryMemoryInitializer::allocateTDigest() {
+  auto t_digest = new TDigest();
+  row_set_mem_owner_->addTDigest(t_digest);
+  return reinterpret_cast<int64_t>(t_digest);
+}
+
 std::vector<ColumnLazyFetchInfo> QueryMemoryInitializer::getColLazyFetchInfo(
     const std::vector<Analyzer::Expr*>& target_exprs,
     const Executor* executor) const {
@@ -93,6 +93,15 @@ class QueryMemoryInitializer {
                   const size_t warp_size,
                   const Executor* executor);
 
+  // Returns the bytes every row of a row-wise buffer starts out as, or an empty vector
+  // if the rows differ, as they do with count distinct buffers of their own.
+  std::vector<int8_t> getTemplateRow(const QueryMemoryDescriptor& query_mem_desc,
+                                     const std::vector<int64_t>& init_vals,
+                                     const std::vector<ssize_t>& bitmap_sizes);
+
+  bool hasZeroTemplateRow(const QueryMemoryDescriptor& query_mem_desc,
+                          const Executor* executor);
+
   void initColumnarGroups(const QueryMemoryDescriptor& query_mem_desc,
                           int64_t* groups_buffer,
                           const std::vector<int64_t>& init_vals,
@@ -117,6 +126,8 @@ class QueryMemoryInitializer {
 
   int64_t allocateCountDistinctSet();
 
+  int64_t allocateTDigest();
+
   std::vector<ColumnLazyFetchInfo> getColLazyFetchInfo(
       const std::vector<Analyzer::Expr*>& target_exprs,
       const Executor* executor) const;
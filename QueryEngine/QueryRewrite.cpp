@@ -68,7 +68,8 @@ RelAlgExecutionUnit QueryRewriter::rewriteOverlapsJoin(
           ra_exe_unit_in.estimator,
           ra_exe_unit_in.sort_info,
           ra_exe_unit_in.scan_limit,
-          ra_exe_unit_in.query_features};
+          ra_exe_unit_in.query_features,
+          ra_exe_unit_in.use_fragment_sampling};
 }
 
 RelAlgExecutionUnit QueryRewriter::rewriteConstrainedByIn(
@@ -159,7 +160,9 @@ RelAlgExecutionUnit QueryRewriter::rewriteConstrainedByInImpl(
           new_target_exprs,
           nullptr,
           ra_exe_unit_in.sort_info,
-          ra_exe_unit_in.scan_limit};
+          ra_exe_unit_in.scan_limit,
+          ra_exe_unit_in.query_features,
+          ra_exe_unit_in.use_fragment_sampling};
 }
 
 std::shared_ptr<Analyzer::CaseExpr> QueryRewriter::generateCaseForDomainValues(
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    RadixSort.h
+ * @brief   Parallel, stable LSD radix sort of values by unsigned integer keys.
+ */
+
+#ifndef QUERYENGINE_RADIXSORT_H
+#define QUERYENGINE_RADIXSORT_H
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Splits [0, num_elems) into contiguous ranges, no more than thread_count of them and
+ * none smaller than min_range_elems unless there's only one, and calls
+ * func(range_idx, range_begin, range_end) on each in a thread of its own. Returns the
+ * number of ranges.
+ */
+template <typename FUNC>
+size_t parallel_for_ranges(const size_t num_elems,
+                           const size_t thread_count,
+                           const size_t min_range_elems,
+                           FUNC func) {
+  const size_t num_ranges = std::max(
+      size_t(1), std::min(thread_count, num_elems / std::max(size_t(1), min_range_elems)));
+  if (num_ranges == 1) {
+    func(size_t(0), size_t(0), num_elems);
+    return num_ranges;
+  }
+  std::vector<std::future<void>> futures;
+  for (size_t range_idx = 0; range_idx < num_ranges; ++range_idx) {
+    const size_t range_begin = num_elems * range_idx / num_ranges;
+    const size_t range_end = num_elems * (range_idx + 1) / num_ranges;
+    futures.emplace_back(std::async(
+        std::launch::async, [&func, range_idx, range_begin, range_end] {
+          func(range_idx, range_begin, range_end);
+        }));
+  }
+  for (auto& future : futures) {
+    future.wait();
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+  return num_ranges;
+}
+
+/**
+ * Sorts values by keys, in ascending order of the keys, which are permuted along. The
+ * sort is stable, so a sort by the least significant column of a multi-column key
+ * followed by sorts by the more significant ones sorts by all of them.
+ *
+ * Keys are sorted one byte at a time, starting with the least significant, and the bytes
+ * which are the same for all keys are skipped. Each pass counts the bytes of every
+ * range of the input in parallel, then moves the elements of every range to their
+ * sorted position in parallel.
+ */
+template <typename KEY, typename VALUE>
+void radix_sort_by_key(std::vector<KEY>& keys,
+                       std::vector<VALUE>& values,
+                       const size_t thread_count) {
+  static_assert(std::is_unsigned<KEY>::value, "Radix sort keys must be unsigned");
+  CHECK_EQ(keys.size(), values.size());
+  const size_t num_elems = keys.size();
+  if (num_elems < 2) {
+    return;
+  }
+  constexpr size_t min_range_elems = 1 << 16;
+  std::vector<KEY> differing_bits(thread_count, 0);
+  parallel_for_ranges(
+      num_elems,
+      thread_count,
+      min_range_elems,
+      [&keys, &differing_bits](const size_t range_idx,
+                               const size_t range_begin,
+                               const size_t range_end) {
+        KEY bits{0};
+        for (size_t i = range_begin; i < range_end; ++i) {
+          bits |= keys[i] ^ keys.front();
+        }
+        differing_bits[range_idx] = bits;
+      });
+  KEY all_differing_bits{0};
+  for (const auto bits : differing_bits) {
+    all_differing_bits |= bits;
+  }
+  std::vector<KEY> sorted_keys(num_elems);
+  std::vector<VALUE> sorted_values(num_elems);
+  std::vector<std::array<size_t, 256>> offsets(thread_count);
+  for (size_t shift = 0; shift < sizeof(KEY) * 8; shift += 8) {
+    if (!((all_differing_bits >> shift) & 0xff)) {
+      continue;
+    }
+    const auto num_ranges = parallel_for_ranges(
+        num_elems,
+        thread_count,
+        min_range_elems,
+        [&keys, &offsets, shift](const size_t range_idx,
+                                 const size_t range_begin,
+                                 const size_t range_end) {
+          auto& counts = offsets[range_idx];
+          counts.fill(0);
+          for (size_t i = range_begin; i < range_end; ++i) {
+            ++counts[(keys[i] >> shift) & 0xff];
+          }
+        });
+    size_t offset{0};
+    for (size_t digit = 0; digit < 256; ++digit) {
+      for (size_t range_idx = 0; range_idx < num_ranges; ++range_idx) {
+        const auto count = offsets[range_idx][digit];
+        offsets[range_idx][digit] = offset;
+        offset += count;
+      }
+    }
+    CHECK_EQ(num_elems, offset);
+    parallel_for_ranges(num_elems,
+                        thread_count,
+                        min_range_elems,
+                        [&keys, &values, &sorted_keys, &sorted_values, &offsets, shift](
+                            const size_t range_idx,
+                            const size_t range_begin,
+                            const size_t range_end) {
+                          auto& range_offsets = offsets[range_idx];
+                          for (size_t i = range_begin; i < range_end; ++i) {
+                            const auto pos = range_offsets[(keys[i] >> shift) & 0xff]++;
+                            sorted_keys[pos] = keys[i];
+                            sorted_values[pos] = values[i];
+                          }
+                        });
+    keys.swap(sorted_keys);
+    values.swap(sorted_values);
+  }
+}
+
+#endif  // QUERYENGINE_RADIXSORT_H
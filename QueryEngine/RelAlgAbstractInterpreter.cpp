@@ -17,6 +17,7 @@
 #include "RelAlgAbstractInterpreter.h"
 #include "CalciteDeserializerUtils.h"
 #include "JsonAccessors.h"
+#include "RelAlgBinaryPlan.h"
 #include "RelAlgExecutor.h"
 #include "RelAlgOptimizer.h"
 #include "RelLeftDeepInnerJoin.h"
@@ -419,7 +420,8 @@ bool RelSort::hasEquivCollationOf(const RelSort& that) const {
 
 namespace {
 
-unsigned node_id(const rapidjson::Value& ra_node) noexcept {
+template <typename JsonValue>
+unsigned node_id(const JsonValue& ra_node) noexcept {
   const auto& id = field(ra_node, "id");
   return std::stoi(json_str(id));
 }
@@ -428,13 +430,15 @@ unsigned node_id(const rapidjson::Value& ra_node) noexcept {
 // RelAlgAbstractInterpreter will take care of making the representation easy to
 // navigate for lower layers, for example by replacing RexAbstractInput with RexInput.
 
+template <typename JsonValue>
 std::unique_ptr<RexAbstractInput> parse_abstract_input(
-    const rapidjson::Value& expr) noexcept {
+    const JsonValue& expr) noexcept {
   const auto& input = field(expr, "input");
   return std::unique_ptr<RexAbstractInput>(new RexAbstractInput(json_i64(input)));
 }
 
-std::unique_ptr<RexLiteral> parse_literal(const rapidjson::Value& expr) {
+template <typename JsonValue>
+std::unique_ptr<RexLiteral> parse_literal(const JsonValue& expr) {
   CHECK(expr.IsObject());
   const auto& literal = field(expr, "literal");
   const auto type = to_sql_type(json_str(field(expr, "type")));
@@ -502,15 +506,18 @@ std::unique_ptr<RexLiteral> parse_literal(const rapidjson::Value& expr) {
   return nullptr;
 }
 
-std::unique_ptr<const RexScalar> parse_scalar_expr(const rapidjson::Value& expr,
+template <typename JsonValue>
+std::unique_ptr<const RexScalar> parse_scalar_expr(const JsonValue& expr,
                                                    const Catalog_Namespace::Catalog& cat,
                                                    RelAlgExecutor* ra_executor);
 
-std::unique_ptr<const RexSubQuery> parse_subquery(const rapidjson::Value& expr,
+template <typename JsonValue>
+std::unique_ptr<const RexSubQuery> parse_subquery(const JsonValue& expr,
                                                   const Catalog_Namespace::Catalog& cat,
                                                   RelAlgExecutor* ra_executor);
 
-SQLTypeInfo parse_type(const rapidjson::Value& type_obj) {
+template <typename JsonValue>
+SQLTypeInfo parse_type(const JsonValue& type_obj) {
   CHECK(type_obj.IsObject() &&
         (type_obj.MemberCount() >= 2 && type_obj.MemberCount() <= 4));
   const auto type = to_sql_type(json_str(field(type_obj, "type")));
@@ -526,7 +533,8 @@ SQLTypeInfo parse_type(const rapidjson::Value& type_obj) {
   return ti;
 }
 
-std::unique_ptr<RexOperator> parse_operator(const rapidjson::Value& expr,
+template <typename JsonValue>
+std::unique_ptr<RexOperator> parse_operator(const JsonValue& expr,
                                             const Catalog_Namespace::Catalog& cat,
                                             RelAlgExecutor* ra_executor) {
   const auto op_name = json_str(field(expr, "op"));
@@ -553,7 +561,8 @@ std::unique_ptr<RexOperator> parse_operator(const rapidjson::Value& expr,
                                           : new RexOperator(op, operands, ti));
 }
 
-std::unique_ptr<RexCase> parse_case(const rapidjson::Value& expr,
+template <typename JsonValue>
+std::unique_ptr<RexCase> parse_case(const JsonValue& expr,
                                     const Catalog_Namespace::Catalog& cat,
                                     RelAlgExecutor* ra_executor) {
   const auto& operands = field(expr, "operands");
@@ -575,8 +584,9 @@ std::unique_ptr<RexCase> parse_case(const rapidjson::Value& expr,
   return std::unique_ptr<RexCase>(new RexCase(expr_pair_list, else_expr));
 }
 
+template <typename JsonValue>
 std::vector<std::string> strings_from_json_array(
-    const rapidjson::Value& json_str_arr) noexcept {
+    const JsonValue& json_str_arr) noexcept {
   CHECK(json_str_arr.IsArray());
   std::vector<std::string> fields;
   for (auto json_str_arr_it = json_str_arr.Begin(); json_str_arr_it != json_str_arr.End();
@@ -587,8 +597,9 @@ std::vector<std::string> strings_from_json_array(
   return fields;
 }
 
+template <typename JsonValue>
 std::vector<size_t> indices_from_json_array(
-    const rapidjson::Value& json_idx_arr) noexcept {
+    const JsonValue& json_idx_arr) noexcept {
   CHECK(json_idx_arr.IsArray());
   std::vector<size_t> indices;
   for (auto json_idx_arr_it = json_idx_arr.Begin(); json_idx_arr_it != json_idx_arr.End();
@@ -607,18 +618,26 @@ std::string json_node_to_string(const rapidjson::Value& node) noexcept {
   return buffer.GetString();
 }
 
-std::unique_ptr<const RexAgg> parse_aggregate_expr(const rapidjson::Value& expr) {
+std::string json_node_to_string(const RelAlgBinaryValue& node) noexcept {
+  return node.toJsonString();
+}
+
+template <typename JsonValue>
+std::unique_ptr<const RexAgg> parse_aggregate_expr(const JsonValue& expr) {
   const auto agg = to_agg_kind(json_str(field(expr, "agg")));
   const auto distinct = json_bool(field(expr, "distinct"));
   const auto agg_ti = parse_type(field(expr, "type"));
   const auto operands = indices_from_json_array(field(expr, "operands"));
-  if (operands.size() > 1 && (operands.size() != 2 || agg != kAPPROX_COUNT_DISTINCT)) {
+  if (operands.size() > 1 &&
+      (operands.size() != 2 ||
+       (agg != kAPPROX_COUNT_DISTINCT && agg != kAPPROX_PERCENTILE))) {
     throw QueryNotSupported("Multiple arguments for aggregates aren't supported");
   }
   return std::unique_ptr<const RexAgg>(new RexAgg(agg, distinct, agg_ti, operands));
 }
 
-std::unique_ptr<const RexScalar> parse_scalar_expr(const rapidjson::Value& expr,
+template <typename JsonValue>
+std::unique_ptr<const RexScalar> parse_scalar_expr(const JsonValue& expr,
                                                    const Catalog_Namespace::Catalog& cat,
                                                    RelAlgExecutor* ra_executor) {
   CHECK(expr.IsObject());
@@ -1061,7 +1080,8 @@ void create_implicit_subquery_node(std::vector<std::shared_ptr<RelAlgNode>>& nod
   }
 }
 
-int64_t get_int_literal_field(const rapidjson::Value& obj,
+template <typename JsonValue>
+int64_t get_int_literal_field(const JsonValue& obj,
                               const char field[],
                               const int64_t default_val) noexcept {
   const auto it = obj.FindMember(field);
@@ -1075,21 +1095,23 @@ int64_t get_int_literal_field(const rapidjson::Value& obj,
   return lit->getVal<int64_t>();
 }
 
-void check_empty_inputs_field(const rapidjson::Value& node) noexcept {
+template <typename JsonValue>
+void check_empty_inputs_field(const JsonValue& node) noexcept {
   const auto& inputs_json = field(node, "inputs");
   CHECK(inputs_json.IsArray() && !inputs_json.Size());
 }
 
-// Create an in-memory, easy to navigate relational algebra DAG from its serialized,
-// JSON representation. Also, apply high level optimizations which can be expressed
+// Create an in-memory, easy to navigate relational algebra DAG from its serialized
+// representation, either a rapidjson document or a RelAlgBinaryPlan. Also, apply high level optimizations which can be expressed
 // through relational algebra extended with RelCompound. The RelCompound node is an
 // equivalent representation for sequences of RelFilter, RelProject and RelAggregate
 // nodes. This coalescing minimizes the amount of intermediate buffers required to
 // evaluate a query. Lower level optimizations are taken care by lower levels, mainly
 // RelAlgTranslator and the IR code generation.
+template <typename JsonValue>
 class RelAlgAbstractInterpreter {
  public:
-  RelAlgAbstractInterpreter(const rapidjson::Value& query_ast,
+  RelAlgAbstractInterpreter(const JsonValue& query_ast,
                             const Catalog_Namespace::Catalog& cat,
                             RelAlgExecutor* ra_executor)
       : query_ast_(query_ast), cat_(cat), ra_executor_(ra_executor) {}
@@ -1126,6 +1148,7 @@ class RelAlgAbstractInterpreter {
       hoist_filter_cond_to_cross_join(nodes_);
     }
     eliminate_dead_columns(nodes_);
+    fold_projects(nodes_);
     coalesce_nodes(nodes_, left_deep_joins);
     CHECK(nodes_.back().unique());
     create_left_deep_join(nodes_);
@@ -1135,7 +1158,7 @@ class RelAlgAbstractInterpreter {
   }
 
  private:
-  void dispatchNodes(const rapidjson::Value& rels) {
+  void dispatchNodes(const JsonValue& rels) {
     for (auto rels_it = rels.Begin(); rels_it != rels.End(); ++rels_it) {
       const auto& crt_node = *rels_it;
       const auto id = node_id(crt_node);
@@ -1166,7 +1189,7 @@ class RelAlgAbstractInterpreter {
     }
   }
 
-  std::shared_ptr<RelScan> dispatchTableScan(const rapidjson::Value& scan_ra) {
+  std::shared_ptr<RelScan> dispatchTableScan(const JsonValue& scan_ra) {
     check_empty_inputs_field(scan_ra);
     CHECK(scan_ra.IsObject());
     const auto td = getTableFromScanNode(scan_ra);
@@ -1174,7 +1197,7 @@ class RelAlgAbstractInterpreter {
     return std::make_shared<RelScan>(td, field_names);
   }
 
-  std::shared_ptr<RelProject> dispatchProject(const rapidjson::Value& proj_ra) {
+  std::shared_ptr<RelProject> dispatchProject(const JsonValue& proj_ra) {
     const auto inputs = getRelAlgInputs(proj_ra);
     CHECK_EQ(size_t(1), inputs.size());
     const auto& exprs_json = field(proj_ra, "exprs");
@@ -1189,7 +1212,7 @@ class RelAlgAbstractInterpreter {
         exprs, strings_from_json_array(fields), inputs.front());
   }
 
-  std::shared_ptr<RelFilter> dispatchFilter(const rapidjson::Value& filter_ra) {
+  std::shared_ptr<RelFilter> dispatchFilter(const JsonValue& filter_ra) {
     const auto inputs = getRelAlgInputs(filter_ra);
     CHECK_EQ(size_t(1), inputs.size());
     const auto id = node_id(filter_ra);
@@ -1198,7 +1221,7 @@ class RelAlgAbstractInterpreter {
     return std::make_shared<RelFilter>(condition, inputs.front());
   }
 
-  std::shared_ptr<RelAggregate> dispatchAggregate(const rapidjson::Value& agg_ra) {
+  std::shared_ptr<RelAggregate> dispatchAggregate(const JsonValue& agg_ra) {
     const auto inputs = getRelAlgInputs(agg_ra);
     CHECK_EQ(size_t(1), inputs.size());
     const auto fields = strings_from_json_array(field(agg_ra, "fields"));
@@ -1220,7 +1243,7 @@ class RelAlgAbstractInterpreter {
     return std::make_shared<RelAggregate>(group.size(), aggs, fields, inputs.front());
   }
 
-  std::shared_ptr<RelJoin> dispatchJoin(const rapidjson::Value& join_ra) {
+  std::shared_ptr<RelJoin> dispatchJoin(const JsonValue& join_ra) {
     const auto inputs = getRelAlgInputs(join_ra);
     CHECK_EQ(size_t(2), inputs.size());
     const auto join_type = to_join_type(json_str(field(join_ra, "joinType")));
@@ -1228,7 +1251,7 @@ class RelAlgAbstractInterpreter {
     return std::make_shared<RelJoin>(inputs[0], inputs[1], filter_rex, join_type);
   }
 
-  std::shared_ptr<RelSort> dispatchSort(const rapidjson::Value& sort_ra) {
+  std::shared_ptr<RelSort> dispatchSort(const JsonValue& sort_ra) {
     const auto inputs = getRelAlgInputs(sort_ra);
     CHECK_EQ(size_t(1), inputs.size());
     std::vector<SortField> collation;
@@ -1257,7 +1280,7 @@ class RelAlgAbstractInterpreter {
         collation, limit > 0 ? limit : 0, offset, inputs.front());
   }
 
-  std::shared_ptr<RelModify> dispatchModify(const rapidjson::Value& logical_modify_ra) {
+  std::shared_ptr<RelModify> dispatchModify(const JsonValue& logical_modify_ra) {
     const auto inputs = getRelAlgInputs(logical_modify_ra);
     CHECK_EQ(size_t(1), inputs.size());
 
@@ -1298,7 +1321,7 @@ class RelAlgAbstractInterpreter {
   }
 
   std::shared_ptr<RelLogicalValues> dispatchLogicalValues(
-      const rapidjson::Value& logical_values_ra) {
+      const JsonValue& logical_values_ra) {
     const auto& tuple_type_arr = field(logical_values_ra, "type");
     CHECK(tuple_type_arr.IsArray());
     std::vector<TargetMetaInfo> tuple_type;
@@ -1320,7 +1343,7 @@ class RelAlgAbstractInterpreter {
     return std::make_shared<RelLogicalValues>(tuple_type);
   }
 
-  const TableDescriptor* getTableFromScanNode(const rapidjson::Value& scan_ra) const {
+  const TableDescriptor* getTableFromScanNode(const JsonValue& scan_ra) const {
     const auto& table_json = field(scan_ra, "table");
     CHECK(table_json.IsArray());
     CHECK_EQ(unsigned(2), table_json.Size());
@@ -1330,13 +1353,13 @@ class RelAlgAbstractInterpreter {
   }
 
   std::vector<std::string> getFieldNamesFromScanNode(
-      const rapidjson::Value& scan_ra) const {
+      const JsonValue& scan_ra) const {
     const auto& fields_json = field(scan_ra, "fieldNames");
     return strings_from_json_array(fields_json);
   }
 
   std::vector<std::shared_ptr<const RelAlgNode>> getRelAlgInputs(
-      const rapidjson::Value& node) {
+      const JsonValue& node) {
     if (node.HasMember("inputs")) {
       const auto str_input_ids = strings_from_json_array(field(node, "inputs"));
       std::vector<std::shared_ptr<const RelAlgNode>> ra_inputs;
@@ -1348,27 +1371,29 @@ class RelAlgAbstractInterpreter {
     return {prev(node)};
   }
 
-  std::shared_ptr<const RelAlgNode> prev(const rapidjson::Value& crt_node) {
+  std::shared_ptr<const RelAlgNode> prev(const JsonValue& crt_node) {
     const auto id = node_id(crt_node);
     CHECK(id);
     CHECK_EQ(static_cast<size_t>(id), nodes_.size());
     return nodes_.back();
   }
 
-  const rapidjson::Value& query_ast_;
+  const JsonValue& query_ast_;
   const Catalog_Namespace::Catalog& cat_;
   std::vector<std::shared_ptr<RelAlgNode>> nodes_;
   RelAlgExecutor* ra_executor_;
 };
 
-std::shared_ptr<const RelAlgNode> ra_interpret(const rapidjson::Value& query_ast,
+template <typename JsonValue>
+std::shared_ptr<const RelAlgNode> ra_interpret(const JsonValue& query_ast,
                                                const Catalog_Namespace::Catalog& cat,
                                                RelAlgExecutor* ra_executor) {
-  RelAlgAbstractInterpreter interp(query_ast, cat, ra_executor);
+  RelAlgAbstractInterpreter<JsonValue> interp(query_ast, cat, ra_executor);
   return interp.run();
 }
 
-std::unique_ptr<const RexSubQuery> parse_subquery(const rapidjson::Value& expr,
+template <typename JsonValue>
+std::unique_ptr<const RexSubQuery> parse_subquery(const JsonValue& expr,
                                                   const Catalog_Namespace::Catalog& cat,
                                                   RelAlgExecutor* ra_executor) {
   const auto& operands = field(expr, "operands");
@@ -1389,11 +1414,17 @@ std::shared_ptr<const RelAlgNode> deserialize_ra_dag(
     const std::string& query_ra,
     const Catalog_Namespace::Catalog& cat,
     RelAlgExecutor* ra_executor) {
+  RelAlgNode::resetRelAlgFirstId();
+  if (RelAlgBinaryPlan::isBinaryPlan(query_ra)) {
+    const RelAlgBinaryPlan plan(query_ra);
+    const auto query_ast = plan.root();
+    CHECK(query_ast.IsObject());
+    return ra_interpret(query_ast, cat, ra_executor);
+  }
   rapidjson::Document query_ast;
   query_ast.Parse(query_ra.c_str());
   CHECK(!query_ast.HasParseError());
   CHECK(query_ast.IsObject());
-  RelAlgNode::resetRelAlgFirstId();
   return ra_interpret(query_ast, cat, ra_executor);
 }
 
@@ -0,0 +1,410 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    RelAlgBinaryPlan.h
+ * @brief   Zero-copy reader for the binary relational algebra plan sent by Calcite.
+ *
+ * The binary plan carries the same tree as the JSON plan, without the text parse and
+ * the per-node allocations. Values are read in place from the serialized buffer through
+ * accessors which mirror the subset of the rapidjson::Value interface the RA
+ * interpreter uses, so the interpreter can be instantiated over either representation.
+ *
+ * Layout, all integers little-endian:
+ *
+ *   "RAB1" | u32 key count | keys: (u32 length, bytes, '\0')* | root value
+ *
+ *   value  := u8 tag, payload
+ *     null (0), false (1), true (2) have no payload
+ *     int64 (3): i64;  double (4): f64
+ *     string (5): u32 length, bytes, '\0'
+ *     array (6): u32 count, count x u32 element offset
+ *     object (7): u32 count, count x (u32 key index, u32 value offset)
+ *
+ * Offsets are relative to the start of the root value, object keys are indices into
+ * the key table. The encoding is canonical, so the buffer can also be used as a key
+ * for caching plans.
+ */
+
+#ifndef QUERYENGINE_RELALGBINARYPLAN_H
+#define QUERYENGINE_RELALGBINARYPLAN_H
+
+#include <glog/logging.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class RelAlgBinaryPlan;
+
+class RelAlgBinaryValue {
+ public:
+  enum class Tag : uint8_t {
+    Null = 0,
+    False = 1,
+    True = 2,
+    Int64 = 3,
+    Double = 4,
+    String = 5,
+    Array = 6,
+    Object = 7
+  };
+
+  class ValueIterator;
+  class MemberIterator;
+  struct Member;
+
+  RelAlgBinaryValue(const RelAlgBinaryPlan* plan, const uint32_t offset);
+
+  bool IsNull() const { return tag() == Tag::Null; }
+  bool IsBool() const { return tag() == Tag::False || tag() == Tag::True; }
+  bool IsInt64() const { return tag() == Tag::Int64; }
+  bool IsInt() const {
+    if (!IsInt64()) {
+      return false;
+    }
+    const auto val = GetInt64();
+    return val >= INT32_MIN && val <= INT32_MAX;
+  }
+  bool IsDouble() const { return tag() == Tag::Double; }
+  bool IsString() const { return tag() == Tag::String; }
+  bool IsArray() const { return tag() == Tag::Array; }
+  bool IsObject() const { return tag() == Tag::Object; }
+
+  bool GetBool() const {
+    CHECK(IsBool());
+    return tag() == Tag::True;
+  }
+  int64_t GetInt64() const {
+    CHECK(IsInt64());
+    return read<int64_t>(offset_ + 1);
+  }
+  int GetInt() const {
+    CHECK(IsInt());
+    return static_cast<int>(GetInt64());
+  }
+  double GetDouble() const {
+    CHECK(IsDouble());
+    return read<double>(offset_ + 1);
+  }
+  // Points into the plan buffer, valid for as long as the plan is.
+  const char* GetString() const {
+    CHECK(IsString());
+    return data() + offset_ + 1 + sizeof(uint32_t);
+  }
+  uint32_t GetStringLength() const {
+    CHECK(IsString());
+    return read<uint32_t>(offset_ + 1);
+  }
+
+  uint32_t Size() const {
+    CHECK(IsArray());
+    return count();
+  }
+  RelAlgBinaryValue operator[](const uint32_t idx) const;
+  ValueIterator Begin() const;
+  ValueIterator End() const;
+
+  uint32_t MemberCount() const {
+    CHECK(IsObject());
+    return count();
+  }
+  MemberIterator MemberBegin() const;
+  MemberIterator MemberEnd() const;
+  MemberIterator FindMember(const char* name) const;
+  bool HasMember(const char* name) const;
+  RelAlgBinaryValue operator[](const char* name) const;
+
+  // Renders the value as JSON text.
+  std::string toJsonString() const {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    write(writer);
+    return buffer.GetString();
+  }
+
+ private:
+  void write(rapidjson::Writer<rapidjson::StringBuffer>& writer) const;
+
+  Tag tag() const { return static_cast<Tag>(data()[offset_]); }
+  uint32_t count() const { return read<uint32_t>(offset_ + 1); }
+  const char* data() const;
+
+  template <typename T>
+  T read(const uint32_t offset) const {
+    T val;
+    memcpy(&val, data() + offset, sizeof(T));
+    return val;
+  }
+
+  const RelAlgBinaryPlan* plan_;
+  uint32_t offset_;
+
+  friend class RelAlgBinaryPlan;
+};
+
+struct RelAlgBinaryValue::Member {
+  const char* name;
+  RelAlgBinaryValue value;
+};
+
+class RelAlgBinaryValue::ValueIterator {
+ public:
+  ValueIterator(const RelAlgBinaryValue& arr, const uint32_t idx)
+      : arr_(arr), idx_(idx), crt_(arr) {}
+
+  RelAlgBinaryValue operator*() const { return arr_[idx_]; }
+  const RelAlgBinaryValue* operator->() const {
+    crt_ = arr_[idx_];
+    return &crt_;
+  }
+  ValueIterator& operator++() {
+    ++idx_;
+    return *this;
+  }
+  ValueIterator operator++(int) {
+    auto ret = *this;
+    ++idx_;
+    return ret;
+  }
+  bool operator==(const ValueIterator& that) const { return idx_ == that.idx_; }
+  bool operator!=(const ValueIterator& that) const { return idx_ != that.idx_; }
+
+ private:
+  RelAlgBinaryValue arr_;
+  uint32_t idx_;
+  mutable RelAlgBinaryValue crt_;
+};
+
+class RelAlgBinaryValue::MemberIterator {
+ public:
+  MemberIterator(const RelAlgBinaryValue& obj, const uint32_t idx);
+
+  const Member& operator*() const { return member_; }
+  const Member* operator->() const { return &member_; }
+  MemberIterator& operator++() {
+    ++idx_;
+    load();
+    return *this;
+  }
+  bool operator==(const MemberIterator& that) const { return idx_ == that.idx_; }
+  bool operator!=(const MemberIterator& that) const { return idx_ != that.idx_; }
+
+ private:
+  void load();
+
+  RelAlgBinaryValue obj_;
+  uint32_t idx_;
+  Member member_;
+};
+
+// Owns nothing: the serialized buffer must outlive the plan and all values read from
+// it. Construction only walks the key table.
+class RelAlgBinaryPlan {
+ public:
+  static bool isBinaryPlan(const std::string& serialized) {
+    return serialized.size() >= 4 && !memcmp(serialized.data(), "RAB1", 4);
+  }
+
+  explicit RelAlgBinaryPlan(const std::string& serialized)
+      : data_(serialized.data()), size_(serialized.size()) {
+    CHECK(isBinaryPlan(serialized));
+    uint32_t pos = 4;
+    const auto key_count = read<uint32_t>(pos);
+    pos += sizeof(uint32_t);
+    keys_.reserve(key_count);
+    for (uint32_t i = 0; i < key_count; ++i) {
+      const auto key_len = read<uint32_t>(pos);
+      pos += sizeof(uint32_t);
+      CHECK_LE(pos + key_len + 1, size_);
+      keys_.push_back(data_ + pos);
+      pos += key_len + 1;
+    }
+    root_offset_ = pos;
+    CHECK_LT(root_offset_, size_);
+  }
+
+  RelAlgBinaryValue root() const { return RelAlgBinaryValue(this, 0); }
+
+  const char* key(const uint32_t idx) const {
+    CHECK_LT(idx, keys_.size());
+    return keys_[idx];
+  }
+
+  // Returns the JSON text the plan was converted from, for consumers which still
+  // operate on JSON text.
+  std::string toJsonString() const { return root().toJsonString(); }
+
+ private:
+  template <typename T>
+  T read(const uint32_t offset) const {
+    CHECK_LE(offset + sizeof(T), size_);
+    T val;
+    memcpy(&val, data_ + offset, sizeof(T));
+    return val;
+  }
+
+  const char* data_;
+  size_t size_;
+  uint32_t root_offset_;
+  std::vector<const char*> keys_;
+
+  friend class RelAlgBinaryValue;
+};
+
+inline RelAlgBinaryValue::RelAlgBinaryValue(const RelAlgBinaryPlan* plan,
+                                            const uint32_t offset)
+    : plan_(plan), offset_(offset) {
+  CHECK_LT(plan_->root_offset_ + offset_, plan_->size_);
+}
+
+inline const char* RelAlgBinaryValue::data() const {
+  return plan_->data_ + plan_->root_offset_;
+}
+
+inline RelAlgBinaryValue RelAlgBinaryValue::operator[](const uint32_t idx) const {
+  CHECK_LT(idx, Size());
+  return RelAlgBinaryValue(
+      plan_, read<uint32_t>(offset_ + 1 + sizeof(uint32_t) * (1 + idx)));
+}
+
+inline RelAlgBinaryValue::ValueIterator RelAlgBinaryValue::Begin() const {
+  CHECK(IsArray());
+  return ValueIterator(*this, 0);
+}
+
+inline RelAlgBinaryValue::ValueIterator RelAlgBinaryValue::End() const {
+  return ValueIterator(*this, Size());
+}
+
+inline RelAlgBinaryValue::MemberIterator RelAlgBinaryValue::MemberBegin() const {
+  CHECK(IsObject());
+  return MemberIterator(*this, 0);
+}
+
+inline RelAlgBinaryValue::MemberIterator RelAlgBinaryValue::MemberEnd() const {
+  return MemberIterator(*this, MemberCount());
+}
+
+inline RelAlgBinaryValue::MemberIterator RelAlgBinaryValue::FindMember(
+    const char* name) const {
+  const auto member_count = MemberCount();
+  for (uint32_t i = 0; i < member_count; ++i) {
+    const auto key_idx = read<uint32_t>(offset_ + 1 + sizeof(uint32_t) * (1 + 2 * i));
+    if (!strcmp(plan_->key(key_idx), name)) {
+      return MemberIterator(*this, i);
+    }
+  }
+  return MemberEnd();
+}
+
+inline bool RelAlgBinaryValue::HasMember(const char* name) const {
+  return FindMember(name) != MemberEnd();
+}
+
+inline RelAlgBinaryValue RelAlgBinaryValue::operator[](const char* name) const {
+  const auto it = FindMember(name);
+  CHECK(it != MemberEnd());
+  return it->value;
+}
+
+inline RelAlgBinaryValue::MemberIterator::MemberIterator(const RelAlgBinaryValue& obj,
+                                                         const uint32_t idx)
+    : obj_(obj), idx_(idx), member_{nullptr, obj} {
+  load();
+}
+
+inline void RelAlgBinaryValue::MemberIterator::load() {
+  if (idx_ >= obj_.count()) {
+    return;
+  }
+  const auto entry_offset = obj_.offset_ + 1 + sizeof(uint32_t) * (1 + 2 * idx_);
+  member_.name = obj_.plan_->key(obj_.read<uint32_t>(entry_offset));
+  member_.value =
+      RelAlgBinaryValue(obj_.plan_, obj_.read<uint32_t>(entry_offset + sizeof(uint32_t)));
+}
+
+inline void RelAlgBinaryValue::write(
+    rapidjson::Writer<rapidjson::StringBuffer>& writer) const {
+  switch (tag()) {
+    case Tag::Null:
+      writer.Null();
+      break;
+    case Tag::False:
+    case Tag::True:
+      writer.Bool(GetBool());
+      break;
+    case Tag::Int64:
+      writer.Int64(GetInt64());
+      break;
+    case Tag::Double:
+      writer.Double(GetDouble());
+      break;
+    case Tag::String:
+      writer.String(GetString(), GetStringLength());
+      break;
+    case Tag::Array:
+      writer.StartArray();
+      for (auto it = Begin(); it != End(); ++it) {
+        (*it).write(writer);
+      }
+      writer.EndArray();
+      break;
+    case Tag::Object:
+      writer.StartObject();
+      for (auto it = MemberBegin(); it != MemberEnd(); ++it) {
+        writer.Key(it->name);
+        it->value.write(writer);
+      }
+      writer.EndObject();
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+// Values are lightweight handles into the plan buffer, returned by value.
+inline RelAlgBinaryValue field(const RelAlgBinaryValue& obj, const char field[]) noexcept {
+  CHECK(obj.IsObject());
+  const auto field_it = obj.FindMember(field);
+  CHECK(field_it != obj.MemberEnd());
+  return field_it->value;
+}
+
+inline const int64_t json_i64(const RelAlgBinaryValue& obj) noexcept {
+  CHECK(obj.IsInt64());
+  return obj.GetInt64();
+}
+
+inline const std::string json_str(const RelAlgBinaryValue& obj) noexcept {
+  CHECK(obj.IsString());
+  return std::string(obj.GetString(), obj.GetStringLength());
+}
+
+inline const bool json_bool(const RelAlgBinaryValue& obj) noexcept {
+  CHECK(obj.IsBool());
+  return obj.GetBool();
+}
+
+inline const double json_double(const RelAlgBinaryValue& obj) noexcept {
+  CHECK(obj.IsDouble());
+  return obj.GetDouble();
+}
+
+#endif  // QUERYENGINE_RELALGBINARYPLAN_H
@@ -70,6 +70,9 @@ struct RelAlgExecutionUnit {
   const SortInfo sort_info;
   size_t scan_limit;
   QueryFeatureDescriptor query_features;
+  // Set on the units whose result the user sees, so that the counts and estimates the
+  // executor runs on its own behalf are never sampled.
+  bool use_fragment_sampling;
 };
 
 class ResultSet;
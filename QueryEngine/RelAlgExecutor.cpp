@@ -42,6 +42,12 @@ bool node_is_aggregate(const RelAlgNode* ra) {
   return ((compound && compound->isAggregate()) || aggregate);
 }
 
+bool node_is_projection(const RelAlgNode* ra) {
+  const auto compound = dynamic_cast<const RelCompound*>(ra);
+  return (compound && !compound->isAggregate()) ||
+         dynamic_cast<const RelProject*>(ra) || dynamic_cast<const RelFilter*>(ra);
+}
+
 void scanForTablesAndAggsInRelAlgSeqForRender(std::vector<RaExecutionDesc>& exec_descs,
                                               RenderInfo* render_info) {
   CHECK(render_info);
@@ -403,8 +409,14 @@ void RelAlgExecutor::executeRelAlgStep(const size_t i,
     handleNop(exec_desc);
     return;
   }
+  // projections read by later steps come out columnar, so that ColumnarResults can use
+  // their columns in place rather than copy them
+  const bool output_columnar_hint =
+      eo.output_columnar_hint ||
+      (g_enable_columnar_intermediate_results && i + 1 < exec_descs.size() &&
+       !render_info && node_is_projection(body));
   const ExecutionOptions eo_work_unit{
-      eo.output_columnar_hint,
+      output_columnar_hint,
       eo.allow_multifrag,
       eo.just_explain,
       eo.allow_loop_joins,
@@ -1032,6 +1044,10 @@ void RelAlgExecutor::executeUpdateViaCompound(const RelCompound* compound,
                                               const ExecutionOptions& eo,
                                               RenderInfo* render_info,
                                               const int64_t queue_time_ms) {
+  if (compound->getModifiedTableDescriptor()->mmapChunks) {
+    throw std::runtime_error(
+        "UPDATE not supported on tables with the mmap attribute set to 'true'");
+  }
   if (!compound->validateTargetColumns(
           yieldColumnValidator(compound->getModifiedTableDescriptor()))) {
     throw std::runtime_error(
@@ -1072,6 +1088,10 @@ void RelAlgExecutor::executeUpdateViaProject(const RelProject* project,
                                              const ExecutionOptions& eo,
                                              RenderInfo* render_info,
                                              const int64_t queue_time_ms) {
+  if (project->getModifiedTableDescriptor()->mmapChunks) {
+    throw std::runtime_error(
+        "UPDATE not supported on tables with the mmap attribute set to 'true'");
+  }
   if (!project->validateTargetColumns(
           yieldColumnValidator(project->getModifiedTableDescriptor()))) {
     throw std::runtime_error(
@@ -1128,6 +1148,10 @@ void RelAlgExecutor::executeDeleteViaCompound(const RelCompound* compound,
     throw std::runtime_error(
         "DELETE only supported on tables with the vacuum attribute set to 'delayed'");
   }
+  if (table_descriptor->mmapChunks) {
+    throw std::runtime_error(
+        "DELETE not supported on tables with the mmap attribute set to 'true'");
+  }
 
   const auto work_unit = createModifyCompoundWorkUnit(
       compound, {{}, SortAlgorithm::Default, 0, 0}, eo.just_explain);
@@ -1165,6 +1189,10 @@ void RelAlgExecutor::executeDeleteViaProject(const RelProject* project,
     throw std::runtime_error(
         "DELETE only supported on tables with the vacuum attribute set to 'delayed'");
   }
+  if (table_descriptor->mmapChunks) {
+    throw std::runtime_error(
+        "DELETE not supported on tables with the mmap attribute set to 'true'");
+  }
 
   auto work_unit = createModifyProjectWorkUnit(
       project, {{}, SortAlgorithm::Default, 0, 0}, eo.just_explain);
@@ -1584,7 +1612,7 @@ RelAlgExecutionUnit decide_approx_count_distinct_implementation(
         get_count_distinct_sub_bitmap_count(bitmap_sz_bits, ra_exe_unit, device_type);
     int64_t approx_bitmap_sz_bits{0};
     const auto error_rate =
-        static_cast<Analyzer::AggExpr*>(target_expr)->get_error_rate();
+        static_cast<Analyzer::AggExpr*>(target_expr)->get_arg1();
     if (error_rate) {
       CHECK(error_rate->get_type_info().get_type() == kSMALLINT);
       CHECK_GE(error_rate->get_constval().smallintval, 1);
@@ -1651,6 +1679,7 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
 
   auto ra_exe_unit = decide_approx_count_distinct_implementation(
       work_unit.exe_unit, table_infos, executor_, co.device_type_, target_exprs_owned_);
+  ra_exe_unit.use_fragment_sampling = true;
   auto max_groups_buffer_entry_guess = work_unit.max_groups_buffer_entry_guess;
 
   if (!eo.just_explain && can_use_scan_limit(ra_exe_unit) && !isRowidLookup(work_unit)) {
@@ -1680,3 +1680,122 @@ void simplify_sort(std::vector<std::shared_ptr<RelAlgNode>>& nodes) noexcept {
   }
   nodes.swap(new_nodes);
 }
+
+namespace {
+
+class RexSubQueryFinder : public RexVisitor<bool> {
+ public:
+  bool visitSubQuery(const RexSubQuery*) const override { return true; }
+
+ protected:
+  bool aggregateResult(const bool& aggregate, const bool& next_result) const override {
+    return aggregate || next_result;
+  }
+
+  bool defaultResult() const override { return false; }
+};
+
+class RexInputUseCounter : public RexVisitor<void*> {
+ public:
+  RexInputUseCounter(const RelAlgNode* source, std::vector<size_t>& use_counts)
+      : source_(source), use_counts_(use_counts) {}
+
+  void* visitInput(const RexInput* input) const override {
+    if (input->getSourceNode() == source_) {
+      CHECK_LT(input->getIndex(), use_counts_.size());
+      ++use_counts_[input->getIndex()];
+    }
+    return nullptr;
+  }
+
+ private:
+  const RelAlgNode* source_;
+  std::vector<size_t>& use_counts_;
+};
+
+// Replaces the inputs from a project with copies of the expressions they refer to.
+class RexProjectInliner : public RexDeepCopyVisitor {
+ public:
+  RexProjectInliner(const RelProject* source) : source_(source) {}
+
+  RetType visitInput(const RexInput* input) const override {
+    if (input->getSourceNode() != source_) {
+      return input->deepCopy();
+    }
+    return RexDeepCopyVisitor::visit(source_->getProjectAt(input->getIndex()));
+  }
+
+ private:
+  const RelProject* source_;
+};
+
+bool has_subqueries(const RelProject* project) {
+  RexSubQueryFinder finder;
+  for (size_t i = 0; i < project->size(); ++i) {
+    if (finder.visit(project->getProjectAt(i))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool is_modify_target(const RelProject* project) {
+  return project->isUpdateViaSelect() || project->isDeleteViaSelect();
+}
+
+}  // namespace
+
+// Folds a project into the project it reads from, when that is its only user, so that
+// the two are evaluated by one step instead of materializing the intermediate result.
+// Expressions are only duplicated if they're inputs or literals, to never compute one
+// more than once per row.
+void fold_projects(std::vector<std::shared_ptr<RelAlgNode>>& nodes) noexcept {
+  std::unordered_map<const RelAlgNode*, size_t> user_counts;
+  for (const auto& node : nodes) {
+    for (size_t i = 0; node && i < node->inputCount(); ++i) {
+      ++user_counts[node->getInput(i)];
+    }
+  }
+  for (auto& node : nodes) {
+    auto project = std::dynamic_pointer_cast<RelProject>(node);
+    if (!project || project->inputCount() != 1) {
+      continue;
+    }
+    auto source = std::dynamic_pointer_cast<const RelProject>(project->getAndOwnInput(0));
+    if (!source || source->inputCount() != 1 || user_counts[source.get()] != 1 ||
+        is_modify_target(project.get()) || is_modify_target(source.get()) ||
+        has_subqueries(project.get()) || has_subqueries(source.get())) {
+      continue;
+    }
+    std::vector<size_t> use_counts(source->size(), 0);
+    RexInputUseCounter counter(source.get(), use_counts);
+    for (size_t i = 0; i < project->size(); ++i) {
+      counter.visit(project->getProjectAt(i));
+    }
+    bool duplicates_work{false};
+    for (size_t i = 0; i < source->size(); ++i) {
+      const auto expr = source->getProjectAt(i);
+      if (use_counts[i] > 1 && !dynamic_cast<const RexInput*>(expr) &&
+          !dynamic_cast<const RexLiteral*>(expr)) {
+        duplicates_work = true;
+        break;
+      }
+    }
+    if (duplicates_work) {
+      continue;
+    }
+    LOG(INFO) << "ID=" << source->getId() << " " << source->toString()
+              << " folded into ID=" << project->getId() << " " << project->toString();
+    RexProjectInliner inliner(source.get());
+    std::vector<std::unique_ptr<const RexScalar>> exprs;
+    for (size_t i = 0; i < project->size(); ++i) {
+      exprs.push_back(inliner.visit(project->getProjectAt(i)));
+    }
+    project->setExpressions(exprs);
+    const auto new_input = source->getAndOwnInput(0);
+    ++user_counts[new_input.get()];
+    --user_counts[source.get()];
+    project->replaceInput(source, new_input);
+  }
+  cleanup_dead_nodes(nodes);
+}
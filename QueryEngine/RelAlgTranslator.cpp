@@ -195,26 +195,50 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
   const bool is_distinct = rex->isDistinct();
   const bool takes_arg{rex->size() > 0};
   std::shared_ptr<Analyzer::Expr> arg_expr;
-  std::shared_ptr<Analyzer::Constant> err_rate;
+  std::shared_ptr<Analyzer::Constant> arg1;
   if (takes_arg) {
     const auto operand = rex->getOperand(0);
     CHECK_LT(operand, static_cast<ssize_t>(scalar_sources.size()));
     CHECK_LE(rex->size(), 2);
     arg_expr = scalar_sources[operand];
     if (agg_kind == kAPPROX_COUNT_DISTINCT && rex->size() == 2) {
-      err_rate = std::dynamic_pointer_cast<Analyzer::Constant>(
+      arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(
           scalar_sources[rex->getOperand(1)]);
-      if (!err_rate || err_rate->get_type_info().get_type() != kSMALLINT ||
-          err_rate->get_constval().smallintval < 1 ||
-          err_rate->get_constval().smallintval > 100) {
+      if (!arg1 || arg1->get_type_info().get_type() != kSMALLINT ||
+          arg1->get_constval().smallintval < 1 ||
+          arg1->get_constval().smallintval > 100) {
         throw std::runtime_error(
             "APPROX_COUNT_DISTINCT's second parameter should be SMALLINT literal between "
             "1 and 100");
       }
     }
+    if (agg_kind == kAPPROX_PERCENTILE) {
+      if (rex->size() != 2 || is_distinct) {
+        throw std::runtime_error(
+            "APPROX_PERCENTILE takes a column and a percentile, without DISTINCT");
+      }
+      const auto quantile = std::dynamic_pointer_cast<Analyzer::Constant>(
+          scalar_sources[rex->getOperand(1)]);
+      if (quantile && !quantile->get_is_null() &&
+          quantile->get_type_info().is_number()) {
+        arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(
+            quantile->deep_copy()->add_cast(SQLTypeInfo(kDOUBLE, true)));
+      }
+      if (!arg1 || arg1->get_constval().doubleval < 0 ||
+          arg1->get_constval().doubleval > 1) {
+        throw std::runtime_error(
+            "APPROX_PERCENTILE's second parameter should be a literal between 0 and 1");
+      }
+      // the sketch only holds doubles
+      const auto& arg_ti = arg_expr->get_type_info();
+      if (arg_ti.get_type() != kDOUBLE) {
+        arg_expr = arg_expr->deep_copy()->add_cast(
+            SQLTypeInfo(kDOUBLE, arg_ti.get_notnull()));
+      }
+    }
   }
   const auto agg_ti = get_agg_type(agg_kind, arg_expr.get());
-  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, err_rate);
+  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateLiteral(
@@ -24,9 +24,11 @@
 #ifndef QUERYENGINE_RESULTROWS_H
 #define QUERYENGINE_RESULTROWS_H
 
+#include "GroupByBufferPool.h"
 #include "HyperLogLog.h"
 #include "OutputBufferInitialization.h"
 #include "QueryMemoryDescriptor.h"
+#include "TDigest.h"
 #include "TargetValue.h"
 
 #include "../Analyzer/Analyzer.h"
@@ -204,9 +206,15 @@ class RowSetMemoryOwner : boost::noncopyable {
     count_distinct_sets_.push_back(count_distinct_set);
   }
 
-  void addGroupByBuffer(int64_t* group_by_buffer) {
+  void addTDigest(TDigest* t_digest) {
     std::lock_guard<std::mutex> lock(state_mutex_);
-    group_by_buffers_.push_back(group_by_buffer);
+    t_digests_.push_back(t_digest);
+  }
+
+  // takes a buffer of GroupByBufferPool, given back to it on destruction
+  void addGroupByBuffer(int64_t* group_by_buffer, const size_t bytes) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    group_by_buffers_.emplace_back(group_by_buffer, bytes);
   }
 
   void addVarlenBuffer(void* varlen_buffer) {
@@ -274,8 +282,12 @@ class RowSetMemoryOwner : boost::noncopyable {
     for (auto count_distinct_set : count_distinct_sets_) {
       delete count_distinct_set;
     }
-    for (auto group_by_buffer : group_by_buffers_) {
-      free(group_by_buffer);
+    for (auto t_digest : t_digests_) {
+      delete t_digest;
+    }
+    for (const auto& group_by_buffer : group_by_buffers_) {
+      GroupByBufferPool::instance().release(group_by_buffer.first,
+                                            group_by_buffer.second);
     }
     for (auto varlen_buffer : varlen_buffers_) {
       free(varlen_buffer);
@@ -298,7 +310,8 @@ class RowSetMemoryOwner : boost::noncopyable {
 
   std::vector<CountDistinctBitmapBuffer> count_distinct_bitmaps_;
   std::vector<std::set<int64_t>*> count_distinct_sets_;
-  std::vector<int64_t*> group_by_buffers_;
+  std::vector<TDigest*> t_digests_;
+  std::vector<std::pair<int64_t*, size_t>> group_by_buffers_;
   std::vector<void*> varlen_buffers_;
   std::list<std::string> strings_;
   std::list<std::vector<int64_t>> arrays_;
@@ -30,6 +30,7 @@
 #include "GpuMemUtils.h"
 #include "InPlaceSort.h"
 #include "OutputBufferInitialization.h"
+#include "RadixSort.h"
 #include "RuntimeFunctions.h"
 #include "Shared/checked_alloc.h"
 #include "Shared/likely.h"
@@ -38,6 +39,7 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cstring>
 #include <future>
 #include <numeric>
 
@@ -51,7 +53,8 @@ ResultSetStorage::ResultSetStorage(const std::vector<TargetInfo>& targets,
     , buff_is_provided_(buff_is_provided) {
   for (const auto& target_info : targets_) {
     if (target_info.agg_kind == kCOUNT ||
-        target_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+        target_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        target_info.agg_kind == kAPPROX_PERCENTILE) {
       target_init_vals_.push_back(0);
       continue;
     }
@@ -296,6 +299,15 @@ void ResultSet::append(ResultSet& that) {
   }
 }
 
+void ResultSet::scaleAggregates(const double scale) {
+  if (storage_) {
+    storage_->scaleAggregates(scale);
+  }
+  for (const auto& storage : appended_storage_) {
+    storage->scaleAggregates(scale);
+  }
+}
+
 const ResultSetStorage* ResultSet::getStorage() const {
   return storage_.get();
 }
@@ -474,10 +486,91 @@ QueryMemoryDescriptor ResultSet::fixupQueryMemoryDescriptor(
   return query_mem_desc_copy;
 }
 
+namespace {
+
+// Radix sort keys compare like the values they're made of: the sign bit of integers is
+// flipped, and so are all the bits of negative floating point values.
+
+uint64_t int_radix_key(const int64_t val) {
+  return static_cast<uint64_t>(val) ^ (uint64_t(1) << 63);
+}
+
+uint64_t fp_radix_key(const double val) {
+  const double zero_or_val = val == 0 ? 0. : val;  // -0.0 compares equal to 0.0
+  uint64_t bits;
+  std::memcpy(&bits, &zero_or_val, sizeof(bits));
+  return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+// Replaces the dictionary ids in the (radix) keys with the rank of their string among
+// the strings of all the ids, so that the keys sort like the strings. Returns false if
+// the ids are too spread out for the dense rank table this takes.
+bool string_id_radix_keys_to_ranks(std::vector<uint64_t>& keys,
+                                   const StringDictionaryProxy* string_dict_proxy,
+                                   const size_t thread_count) {
+  if (keys.empty()) {
+    return true;
+  }
+  const auto min_max_keys = std::minmax_element(keys.begin(), keys.end());
+  const auto min_key = *min_max_keys.first;
+  const auto max_id_offset = *min_max_keys.second - min_key;
+  if (max_id_offset >= std::max(keys.size(), size_t(1) << 24)) {
+    return false;
+  }
+  std::vector<uint32_t> ranks(max_id_offset + 1, 0);
+  for (const auto key : keys) {
+    ranks[key - min_key] = 1;
+  }
+  std::vector<int32_t> ids;
+  for (size_t id_offset = 0; id_offset < ranks.size(); ++id_offset) {
+    if (ranks[id_offset]) {
+      const auto id = static_cast<int64_t>((min_key + id_offset) ^ (uint64_t(1) << 63));
+      ids.push_back(static_cast<int32_t>(id));
+    }
+  }
+  std::vector<std::string> strings;
+  strings.reserve(ids.size());
+  for (const auto id : ids) {
+    strings.push_back(string_dict_proxy->getString(id));
+  }
+  std::vector<uint32_t> string_order(ids.size());
+  std::iota(string_order.begin(), string_order.end(), 0);
+  std::sort(string_order.begin(),
+            string_order.end(),
+            [&strings](const uint32_t lhs, const uint32_t rhs) {
+              return strings[lhs] < strings[rhs];
+            });
+  uint32_t rank{0};
+  for (size_t i = 0; i < string_order.size(); ++i) {
+    if (i && strings[string_order[i]] != strings[string_order[i - 1]]) {
+      ++rank;
+    }
+    ranks[int_radix_key(ids[string_order[i]]) - min_key] = rank;
+  }
+  parallel_for_ranges(
+      keys.size(),
+      thread_count,
+      1 << 16,
+      [&keys, &ranks, min_key](
+          const size_t, const size_t range_begin, const size_t range_end) {
+        for (size_t i = range_begin; i < range_end; ++i) {
+          keys[i] = ranks[keys[i] - min_key];
+        }
+      });
+  return true;
+}
+
+}  // namespace
+
 void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
                      const size_t top_n) {
   CHECK_EQ(-1, cached_row_count_);
   CHECK(!targets_.empty());
+  if (query_mem_desc_.didOutputColumnar()) {
+    compressTDigests<ColumnWiseTargetAccessor>(order_entries);
+  } else {
+    compressTDigests<RowWiseTargetAccessor>(order_entries);
+  }
 #ifdef HAVE_CUDA
   if (canUseFastBaselineSort(order_entries, top_n)) {
     baselineSort(order_entries, top_n);
@@ -513,12 +606,23 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
     return;
   }
 
+  permutation_ = initPermutationBuffer(0, 1);
+
+  if (!use_heap && g_enable_cpu_radix_sort && use_parallel_algorithms(*this)) {
+    const bool sorted =
+        query_mem_desc_.didOutputColumnar()
+            ? radixSortPermutation<ColumnWiseTargetAccessor>(order_entries)
+            : radixSortPermutation<RowWiseTargetAccessor>(order_entries);
+    if (sorted) {
+      return;
+    }
+  }
+
+  // only the comparison sorts are too slow for results this large
   if (g_enable_watchdog && (entryCount() > Executor::baseline_threshold)) {
     throw WatchdogException("Sorting the result would be too slow");
   }
 
-  permutation_ = initPermutationBuffer(0, 1);
-
   auto compare = createComparator(order_entries, use_heap);
 
   if (use_heap) {
@@ -636,6 +740,25 @@ ResultSet::StorageLookupResult ResultSet::findStorage(const size_t entry_idx) co
           static_cast<size_t>(stg_idx)};
 }
 
+bool ResultSet::isFloatArgumentInput(const size_t target_idx) const {
+  const auto& agg_info = targets_[target_idx];
+  // Need to determine if the float value has been stored as float
+  // or if it has been compacted to a different (often larger 8 bytes)
+  // in distributed case the floats are actually 4 bytes
+  // TODO the above takes_float_argument() is widely used  wonder if this problem
+  // exists elsewhere
+  if (get_compact_type(agg_info).get_type() == kFLOAT) {
+    const auto is_col_lazy =
+        !lazy_fetch_info_.empty() && lazy_fetch_info_[target_idx].is_lazily_fetched;
+    if (query_mem_desc_.getColumnWidth(target_idx).compact == sizeof(float) ||
+        (query_mem_desc_.didOutputColumnar() && !is_col_lazy &&
+         query_mem_desc_.getPaddedColumnWidthBytes(target_idx) == sizeof(float))) {
+      return true;
+    }
+  }
+  return takes_float_argument(agg_info);
+}
+
 template <typename BUFFER_ITERATOR_TYPE>
 bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
     const uint32_t lhs,
@@ -652,24 +775,8 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
     CHECK_GE(order_entry.tle_no, 1);
     const auto& agg_info = result_set_->targets_[order_entry.tle_no - 1];
     const auto& entry_ti = get_compact_type(agg_info);
-    bool float_argument_input = takes_float_argument(agg_info);
-    // Need to determine if the float value has been stored as float
-    // or if it has been compacted to a different (often larger 8 bytes)
-    // in distributed case the floats are actually 4 bytes
-    // TODO the above takes_float_argument() is widely used  wonder if this problem
-    // exists elsewhere
-    if (entry_ti.get_type() == kFLOAT) {
-      const auto is_col_lazy =
-          !result_set_->lazy_fetch_info_.empty() &&
-          result_set_->lazy_fetch_info_[order_entry.tle_no - 1].is_lazily_fetched;
-      if (result_set_->query_mem_desc_.getColumnWidth(order_entry.tle_no - 1).compact ==
-              sizeof(float) ||
-          (result_set_->query_mem_desc_.didOutputColumnar() && !is_col_lazy &&
-           result_set_->query_mem_desc_.getPaddedColumnWidthBytes(order_entry.tle_no -
-                                                                  1) == sizeof(float))) {
-        float_argument_input = true;
-      }
-    }
+    const bool float_argument_input =
+        result_set_->isFloatArgumentInput(order_entry.tle_no - 1);
     const auto lhs_v = buffer_itr_.getColumnInternal(lhs_storage->buff_,
                                                      fixedup_lhs,
                                                      order_entry.tle_no - 1,
@@ -678,6 +785,26 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
                                                      fixedup_rhs,
                                                      order_entry.tle_no - 1,
                                                      rhs_storage_lookup_result);
+    if (UNLIKELY(is_approx_percentile_target(agg_info))) {
+      const auto lhs_t_digest = reinterpret_cast<const TDigest*>(lhs_v.i1);
+      const auto rhs_t_digest = reinterpret_cast<const TDigest*>(rhs_v.i1);
+      const bool lhs_null = !lhs_t_digest || lhs_t_digest->empty();
+      const bool rhs_null = !rhs_t_digest || rhs_t_digest->empty();
+      if (lhs_null && rhs_null) {
+        return false;
+      }
+      if (lhs_null != rhs_null) {
+        return use_heap_ ? lhs_null != order_entry.nulls_first
+                         : lhs_null == order_entry.nulls_first;
+      }
+      const auto lhs_dval = lhs_t_digest->quantile();
+      const auto rhs_dval = rhs_t_digest->quantile();
+      if (lhs_dval == rhs_dval) {
+        continue;
+      }
+      const bool use_desc_cmp = use_heap_ ? !order_entry.is_desc : order_entry.is_desc;
+      return use_desc_cmp ? lhs_dval > rhs_dval : lhs_dval < rhs_dval;
+    }
     if (UNLIKELY(isNull(entry_ti, lhs_v, float_argument_input) &&
                  isNull(entry_ti, rhs_v, float_argument_input))) {
       return false;
@@ -781,6 +908,167 @@ void ResultSet::sortPermutation(
   std::sort(permutation_.begin(), permutation_.end(), compare);
 }
 
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::compressTDigests(const std::list<Analyzer::OrderEntry>& order_entries) {
+  std::vector<size_t> target_idxs;
+  for (const auto& order_entry : order_entries) {
+    CHECK_GE(order_entry.tle_no, 1);
+    if (is_approx_percentile_target(targets_[order_entry.tle_no - 1])) {
+      target_idxs.push_back(order_entry.tle_no - 1);
+    }
+  }
+  if (target_idxs.empty()) {
+    return;
+  }
+  const BUFFER_ITERATOR_TYPE buffer_itr(this);
+  // every entry of a group by has a digest of its own
+  parallel_for_ranges(
+      query_mem_desc_.getEntryCount(),
+      cpu_threads(),
+      1 << 12,
+      [&](const size_t range_idx, const size_t range_begin, const size_t range_end) {
+        for (size_t i = range_begin; i < range_end; ++i) {
+          const auto storage_lookup_result = findStorage(i);
+          const auto storage = storage_lookup_result.storage_ptr;
+          const auto off = storage_lookup_result.fixedup_entry_idx;
+          if (storage->isEmptyEntry(off)) {
+            continue;
+          }
+          for (const auto target_idx : target_idxs) {
+            const auto val = buffer_itr.getColumnInternal(
+                storage->buff_, off, target_idx, storage_lookup_result);
+            if (const auto t_digest = reinterpret_cast<TDigest*>(val.i1)) {
+              t_digest->compress();
+            }
+          }
+        }
+      });
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+bool ResultSet::radixSortPermutation(
+    const std::list<Analyzer::OrderEntry>& order_entries) {
+  for (const auto& order_entry : order_entries) {
+    CHECK_GE(order_entry.tle_no, 1);
+    const auto& entry_ti = get_compact_type(targets_[order_entry.tle_no - 1]);
+    if (entry_ti.is_varlen() ||
+        (entry_ti.is_string() && entry_ti.get_compression() != kENCODING_DICT)) {
+      return false;
+    }
+  }
+  const BUFFER_ITERATOR_TYPE buffer_itr(this);
+  const size_t thread_count = cpu_threads();
+  const size_t min_range_elems = 1 << 16;
+  // The radix sort is stable, so sorting by the order entries from the last to the first
+  // sorts by all of them. Nulls are left out of the sort by value and put in front of or
+  // behind the rest after it, in the order they had before.
+  for (auto order_entry_it = order_entries.rbegin();
+       order_entry_it != order_entries.rend();
+       ++order_entry_it) {
+    const auto& order_entry = *order_entry_it;
+    const size_t target_idx = order_entry.tle_no - 1;
+    const auto& agg_info = targets_[target_idx];
+    const auto& entry_ti = get_compact_type(agg_info);
+    const bool float_argument_input = isFloatArgumentInput(target_idx);
+    const bool is_count_distinct = is_distinct_target(agg_info);
+    const bool is_approx_percentile = is_approx_percentile_target(agg_info);
+    std::vector<uint64_t> keys(permutation_.size());
+    std::vector<int8_t> is_null(permutation_.size(), 0);
+    std::vector<size_t> null_counts(thread_count, 0);
+    parallel_for_ranges(
+        permutation_.size(),
+        thread_count,
+        min_range_elems,
+        [&](const size_t range_idx, const size_t range_begin, const size_t range_end) {
+          size_t null_count{0};
+          for (size_t i = range_begin; i < range_end; ++i) {
+            const auto storage_lookup_result = findStorage(permutation_[i]);
+            const auto val =
+                buffer_itr.getColumnInternal(storage_lookup_result.storage_ptr->buff_,
+                                             storage_lookup_result.fixedup_entry_idx,
+                                             target_idx,
+                                             storage_lookup_result);
+            if (is_approx_percentile) {
+              const auto t_digest = reinterpret_cast<const TDigest*>(val.i1);
+              if (!t_digest || t_digest->empty()) {
+                is_null[i] = 1;
+                ++null_count;
+              } else {
+                keys[i] = fp_radix_key(t_digest->quantile());
+              }
+              continue;
+            }
+            if (isNull(entry_ti, val, float_argument_input)) {
+              is_null[i] = 1;
+              ++null_count;
+              continue;
+            }
+            if (val.isPair()) {
+              keys[i] = fp_radix_key(
+                  pair_to_double({val.i1, val.i2}, entry_ti, float_argument_input));
+            } else if (is_count_distinct) {
+              keys[i] = int_radix_key(count_distinct_set_size(
+                  val.i1, query_mem_desc_.getCountDistinctDescriptor(target_idx)));
+            } else if (entry_ti.is_fp()) {
+              keys[i] = fp_radix_key(
+                  float_argument_input
+                      ? *reinterpret_cast<const float*>(may_alias_ptr(&val.i1))
+                      : *reinterpret_cast<const double*>(may_alias_ptr(&val.i1)));
+            } else {
+              CHECK(val.isInt());
+              keys[i] = int_radix_key(val.i1);
+            }
+          }
+          null_counts[range_idx] = null_count;
+        });
+    const auto null_count =
+        std::accumulate(null_counts.begin(), null_counts.end(), size_t(0));
+    std::vector<uint32_t> null_permutation;
+    std::vector<uint32_t> non_null_permutation;
+    if (null_count) {
+      null_permutation.reserve(null_count);
+      non_null_permutation.reserve(permutation_.size() - null_count);
+      for (size_t i = 0; i < permutation_.size(); ++i) {
+        if (is_null[i]) {
+          null_permutation.push_back(permutation_[i]);
+        } else {
+          keys[non_null_permutation.size()] = keys[i];
+          non_null_permutation.push_back(permutation_[i]);
+        }
+      }
+      keys.resize(non_null_permutation.size());
+    } else {
+      non_null_permutation = permutation_;
+    }
+    if (entry_ti.is_string()) {
+      CHECK_EQ(kENCODING_DICT, entry_ti.get_compression());
+      const auto string_dict_proxy = executor_->getStringDictionaryProxy(
+          entry_ti.get_comp_param(), row_set_mem_owner_, false);
+      if (!string_id_radix_keys_to_ranks(keys, string_dict_proxy, thread_count)) {
+        return false;
+      }
+    }
+    if (order_entry.is_desc) {
+      for (auto& key : keys) {
+        key = ~key;
+      }
+    }
+    radix_sort_by_key(keys, non_null_permutation, thread_count);
+    permutation_.clear();
+    if (order_entry.nulls_first) {
+      permutation_.insert(
+          permutation_.end(), null_permutation.begin(), null_permutation.end());
+    }
+    permutation_.insert(
+        permutation_.end(), non_null_permutation.begin(), non_null_permutation.end());
+    if (!order_entry.nulls_first) {
+      permutation_.insert(
+          permutation_.end(), null_permutation.begin(), null_permutation.end());
+    }
+  }
+  return true;
+}
+
 void ResultSet::radixSortOnGpu(
     const std::list<Analyzer::OrderEntry>& order_entries) const {
   auto data_mgr = &executor_->catalog_->getDataMgr();
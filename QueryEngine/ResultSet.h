@@ -91,6 +91,10 @@ class ResultSetStorage {
   void rewriteAggregateBufferOffsets(
       const std::vector<std::string>& serialized_varlen_buffer) const;
 
+  // Scales the COUNT and SUM targets of every entry, e.g. to estimate the aggregates
+  // of a whole table from those of a sample of its fragments.
+  void scaleAggregates(const double scale) const;
+
   int8_t* getUnderlyingBuffer() const;
 
   template <class KeyType>
@@ -161,11 +165,19 @@ class ResultSetStorage {
                      const ResultSetStorage& that,
                      const std::vector<std::string>& serialized_varlen_buffer) const;
 
+  void scaleOneSlot(int8_t* slot_ptr,
+                    const int8_t compact_sz,
+                    const TargetInfo& target_info,
+                    const size_t target_slot_idx,
+                    const double scale) const;
+
   void reduceOneCountDistinctSlot(int8_t* this_ptr1,
                                   const int8_t* that_ptr1,
                                   const size_t target_logical_idx,
                                   const ResultSetStorage& that) const;
 
+  void reduceOneApproxPercentileSlot(int8_t* this_ptr1, const int8_t* that_ptr1) const;
+
   void fillOneEntryRowWise(const std::vector<int64_t>& entry);
 
   void fillOneEntryColWise(const std::vector<int64_t>& entry);
@@ -388,6 +400,8 @@ class ResultSet {
 
   void append(ResultSet& that);
 
+  void scaleAggregates(const double scale);
+
   const ResultSetStorage* getStorage() const;
 
   size_t colCount() const;
@@ -488,6 +502,11 @@ class ResultSet {
                             int8_t* output_buffer,
                             const size_t output_buffer_size) const;
 
+  // Returns the values of the column in place, or nullptr if they aren't a single
+  // buffer of elements of the given width.
+  const int8_t* getColumnBufferInPlace(const size_t column_idx,
+                                       const size_t element_width) const;
+
   /*
    * Determines if it is possible to directly form a ColumnarResults class from this
    * result set, bypassing the default row-wise columnarization. It is currently only
@@ -536,6 +555,9 @@ class ResultSet {
                      const InternalTargetValue& val,
                      const bool float_argument_input);
 
+  // Whether the values of a float target are stored as floats rather than doubles.
+  bool isFloatArgumentInput(const size_t target_idx) const;
+
   TargetValue getTargetValueFromBufferRowwise(
       int8_t* rowwise_target_ptr,
       int8_t* keys_ptr,
@@ -722,6 +744,17 @@ class ResultSet {
 
   void sortPermutation(const std::function<bool(const uint32_t, const uint32_t)> compare);
 
+  // Sorts permutation_ with a parallel radix sort on keys normalized to unsigned
+  // integers. Returns false, for order entries which can't be normalized that way, if
+  // permutation_ has yet to be sorted by comparisons.
+  template <typename BUFFER_ITERATOR_TYPE>
+  bool radixSortPermutation(const std::list<Analyzer::OrderEntry>& order_entries);
+
+  // Compresses the digests of the APPROX_PERCENTILE targets sorted on, once, so that
+  // the comparisons and the radix keys read their quantiles without compressing copies.
+  template <typename BUFFER_ITERATOR_TYPE>
+  void compressTDigests(const std::list<Analyzer::OrderEntry>& order_entries);
+
   std::vector<uint32_t> initPermutationBuffer(const size_t start, const size_t step);
 
   void parallelTop(const std::list<Analyzer::OrderEntry>& order_entries,
@@ -656,19 +656,16 @@ int64_t ResultSet::lazyReadInt(const int64_t ival,
       CHECK(!target_info.is_agg);
       if (target_info.sql_type.is_string() &&
           target_info.sql_type.get_compression() == kENCODING_NONE) {
-        VarlenDatum vd;
-        bool is_end{false};
-        ChunkIter_get_nth(
-            reinterpret_cast<ChunkIter*>(const_cast<int8_t*>(frag_col_buffer)),
-            storage_lookup_result.fixedup_entry_idx,
-            false,
-            &vd,
-            &is_end);
-        CHECK(!is_end);
-        if (vd.is_null) {
+        const auto chunk_iter = reinterpret_cast<const ChunkIter*>(frag_col_buffer);
+        CHECK_LT(static_cast<size_t>(storage_lookup_result.fixedup_entry_idx),
+                 chunk_iter->num_elems);
+        size_t length;
+        const auto pointer = ChunkIter_get_nth_varlen(
+            chunk_iter, storage_lookup_result.fixedup_entry_idx, &length);
+        if (!length) {
           return 0;
         }
-        std::string fetched_str(reinterpret_cast<char*>(vd.pointer), vd.length);
+        std::string fetched_str(reinterpret_cast<const char*>(pointer), length);
         return reinterpret_cast<int64_t>(row_set_mem_owner_->addString(fetched_str));
       }
       return lazy_decode(col_lazy_fetch, frag_col_buffer, ival_copy);
@@ -1107,6 +1104,26 @@ void ResultSet::copyColumnIntoBuffer(const size_t column_idx,
   }
 }
 
+/**
+ * Columnar projections held in a single storage keep each column non lazily fetched as
+ * one contiguous buffer, which can be read in place as long as the result set is alive.
+ */
+const int8_t* ResultSet::getColumnBufferInPlace(const size_t column_idx,
+                                                const size_t element_width) const {
+  CHECK_LT(column_idx, query_mem_desc_.getColCount());
+  if (!isFastColumnarConversionPossible() || !storage_ || !appended_storage_.empty()) {
+    return nullptr;
+  }
+  if (!lazy_fetch_info_.empty() && lazy_fetch_info_[column_idx].is_lazily_fetched) {
+    return nullptr;
+  }
+  if (query_mem_desc_.getPaddedColumnWidthBytes(column_idx) != element_width) {
+    return nullptr;
+  }
+  return storage_->getUnderlyingBuffer() +
+         storage_->query_mem_desc_.getColOffInBytes(column_idx);
+}
+
 // Interprets ptr1, ptr2 as the ptr and len pair used for variable length data.
 TargetValue ResultSet::makeVarlenTargetValue(const int8_t* ptr1,
                                              const int8_t compact_sz1,
@@ -1155,21 +1172,16 @@ TargetValue ResultSet::makeVarlenTargetValue(const int8_t* ptr1,
           getColumnFrag(storage_idx.first, target_logical_idx, varlen_ptr);
       bool is_end{false};
       if (target_info.sql_type.is_string()) {
-        VarlenDatum vd;
-        ChunkIter_get_nth(reinterpret_cast<ChunkIter*>(const_cast<int8_t*>(
-                              frag_col_buffers[col_lazy_fetch.local_col_id])),
-                          varlen_ptr,
-                          false,
-                          &vd,
-                          &is_end);
-        CHECK(!is_end);
-        if (vd.is_null) {
+        const auto chunk_iter = reinterpret_cast<const ChunkIter*>(
+            frag_col_buffers[col_lazy_fetch.local_col_id]);
+        CHECK_LT(static_cast<size_t>(varlen_ptr), chunk_iter->num_elems);
+        size_t length;
+        const auto pointer = ChunkIter_get_nth_varlen(chunk_iter, varlen_ptr, &length);
+        if (!length) {
           return TargetValue(nullptr);
         }
-        CHECK(vd.pointer);
-        CHECK_GT(vd.length, 0);
-        std::string fetched_str(reinterpret_cast<char*>(vd.pointer), vd.length);
-        return fetched_str;
+        CHECK(pointer);
+        return std::string(reinterpret_cast<const char*>(pointer), length);
       } else {
         CHECK(target_info.sql_type.is_array());
         ArrayDatum ad;
@@ -1562,6 +1574,10 @@ TargetValue ResultSet::makeTargetValue(const int8_t* ptr,
       }
     }
   }
+  if (is_approx_percentile_target(target_info)) {
+    const auto t_digest = reinterpret_cast<const TDigest*>(ival);
+    return t_digest && !t_digest->empty() ? t_digest->quantile() : NULL_DOUBLE;
+  }
   if (chosen_type.is_fp()) {
     switch (actual_compact_sz) {
       case 8: {
@@ -22,6 +22,7 @@
  * Copyright (c) 2014 MapD Technologies, Inc.  All rights reserved.
  */
 
+#include "AggregateUtils.h"
 #include "DynamicWatchdog.h"
 #include "ResultRows.h"
 #include "ResultSet.h"
@@ -32,6 +33,7 @@
 #include "Shared/thread_count.h"
 
 #include <algorithm>
+#include <cmath>
 #include <future>
 #include <numeric>
 
@@ -39,8 +41,17 @@ extern bool g_enable_dynamic_watchdog;
 
 namespace {
 
-bool use_multithreaded_reduction(const size_t entry_count) {
-  return entry_count > 100000;
+// Count distinct bitmaps and HyperLogLog registers make an entry as costly to reduce as
+// many plain slots, so they are weighed in by their size.
+bool use_multithreaded_reduction(const QueryMemoryDescriptor& query_mem_desc) {
+  size_t entry_cost = 1;
+  for (size_t i = 0; i < query_mem_desc.getCountDistinctDescriptorsSize(); ++i) {
+    const auto count_distinct_desc = query_mem_desc.getCountDistinctDescriptor(i);
+    if (count_distinct_desc.impl_type_ == CountDistinctImplType::Bitmap) {
+      entry_cost += count_distinct_desc.bitmapPaddedSizeBytes() / sizeof(int64_t);
+    }
+  }
+  return query_mem_desc.getEntryCount() * entry_cost > 100000;
 }
 
 size_t get_row_qw_count(const QueryMemoryDescriptor& query_mem_desc) {
@@ -146,7 +157,7 @@ void ResultSetStorage::reduce(
           "Projection of variable length targets with baseline hash group by is not yet "
           "supported in Distributed mode");
     }
-    if (use_multithreaded_reduction(that.query_mem_desc_.getEntryCount())) {
+    if (use_multithreaded_reduction(that.query_mem_desc_)) {
       const size_t thread_count = cpu_threads();
       std::vector<std::future<void>> reduction_threads;
       for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
@@ -181,7 +192,7 @@ void ResultSetStorage::reduce(
     }
     return;
   }
-  if (use_multithreaded_reduction(entry_count)) {
+  if (use_multithreaded_reduction(query_mem_desc_)) {
     const size_t thread_count = cpu_threads();
     std::vector<std::future<void>> reduction_threads;
     for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
@@ -446,6 +457,100 @@ void ResultSetStorage::rewriteAggregateBufferOffsets(
   return;
 }
 
+void ResultSetStorage::scaleAggregates(const double scale) const {
+  CHECK(buff_);
+  const auto entry_count = query_mem_desc_.getEntryCount();
+  if (query_mem_desc_.didOutputColumnar()) {
+    auto crt_col_ptr = get_cols_ptr(buff_, query_mem_desc_);
+    size_t target_slot_idx = 0;
+    for (const auto& target_info : targets_) {
+      const auto compact_sz = query_mem_desc_.getPaddedColumnWidthBytes(target_slot_idx);
+      for (size_t i = 0; i < entry_count; ++i) {
+        if (!isEmptyEntry(i)) {
+          scaleOneSlot(crt_col_ptr + i * compact_sz,
+                       compact_sz,
+                       target_info,
+                       target_slot_idx,
+                       scale);
+        }
+      }
+      crt_col_ptr = advance_target_ptr_col_wise(
+          crt_col_ptr, target_info, target_slot_idx, query_mem_desc_, false);
+      target_slot_idx = advance_slot(target_slot_idx, target_info, false);
+    }
+    return;
+  }
+  const auto key_bytes_with_padding =
+      align_to_int64(get_key_bytes_rowwise(query_mem_desc_));
+  for (size_t i = 0; i < entry_count; ++i) {
+    if (isEmptyEntry(i)) {
+      continue;
+    }
+    auto rowwise_targets_ptr =
+        row_ptr_rowwise(buff_, query_mem_desc_, i) + key_bytes_with_padding;
+    size_t target_slot_idx = 0;
+    for (const auto& target_info : targets_) {
+      scaleOneSlot(rowwise_targets_ptr,
+                   query_mem_desc_.getColumnWidth(target_slot_idx).compact,
+                   target_info,
+                   target_slot_idx,
+                   scale);
+      rowwise_targets_ptr = advance_target_ptr_row_wise(
+          rowwise_targets_ptr, target_info, target_slot_idx, query_mem_desc_, false);
+      target_slot_idx = advance_slot(target_slot_idx, target_info, false);
+    }
+  }
+}
+
+// Only plain counts and sums grow with the number of rows aggregated; averages, extrema
+// and distinct counts are left as they are.
+void ResultSetStorage::scaleOneSlot(int8_t* slot_ptr,
+                                    const int8_t compact_sz,
+                                    const TargetInfo& target_info,
+                                    const size_t target_slot_idx,
+                                    const double scale) const {
+  if (!target_info.is_agg || is_distinct_target(target_info) ||
+      (target_info.agg_kind != kCOUNT && target_info.agg_kind != kSUM)) {
+    return;
+  }
+  const auto& sql_type = target_info.sql_type;
+  CHECK_LT(target_slot_idx, target_init_vals_.size());
+  const auto init_val = target_init_vals_[target_slot_idx];
+  if (sql_type.is_fp()) {
+    // read with the width the reduction uses: aggregates of float arguments keep a
+    // float, other 8-byte slots a double
+    const auto chosen_bytes =
+        takes_float_argument(target_info) ? int8_t(sizeof(float)) : compact_sz;
+    switch (chosen_bytes) {
+      case 8: {
+        auto dval = reinterpret_cast<double*>(slot_ptr);
+        if (!target_info.skip_null_val ||
+            *dval != *reinterpret_cast<const double*>(may_alias_ptr(&init_val))) {
+          *dval *= scale;
+        }
+        break;
+      }
+      case 4: {
+        CHECK_EQ(kFLOAT, sql_type.get_type());
+        auto fval = reinterpret_cast<float*>(slot_ptr);
+        if (!target_info.skip_null_val ||
+            *fval != *reinterpret_cast<const float*>(may_alias_ptr(&init_val))) {
+          *fval = static_cast<float>(*fval * scale);
+        }
+        break;
+      }
+      default:
+        CHECK(false);
+    }
+    return;
+  }
+  const auto ival = read_int_from_buff(slot_ptr, compact_sz);
+  if (target_info.skip_null_val && ival == init_val) {
+    return;
+  }
+  set_component(slot_ptr, compact_sz, std::llround(ival * scale));
+}
+
 // Reduces entry at position entry_idx in that_buff into the same position in this_buff,
 // row-wise format.
 void ResultSetStorage::reduceOneEntryNoCollisionsRowWise(
@@ -1240,6 +1345,11 @@ void ResultSetStorage::reduceOneSlot(
         AGGREGATE_ONE_COUNT(this_ptr1, that_ptr1, chosen_bytes);
         break;
       }
+      case kAPPROX_PERCENTILE: {
+        CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+        reduceOneApproxPercentileSlot(this_ptr1, that_ptr1);
+        break;
+      }
       case kAVG: {
         // Ignore float argument compaction for count component for fear of its overflow
         AGGREGATE_ONE_COUNT(this_ptr2,
@@ -1357,6 +1467,23 @@ void ResultSetStorage::reduceOneCountDistinctSlot(int8_t* this_ptr1,
       *new_set_ptr, *old_set_ptr, new_count_distinct_desc, old_count_distinct_desc);
 }
 
+// A slot without a TDigest, as filled in for an empty input, merges as an empty one.
+void ResultSetStorage::reduceOneApproxPercentileSlot(int8_t* this_ptr1,
+                                                     const int8_t* that_ptr1) const {
+  CHECK(this_ptr1 && that_ptr1);
+  auto this_handle = reinterpret_cast<int64_t*>(this_ptr1);
+  const auto that_handle = *reinterpret_cast<const int64_t*>(that_ptr1);
+  if (!that_handle || that_handle == *this_handle) {
+    return;
+  }
+  if (!*this_handle) {
+    *this_handle = that_handle;
+    return;
+  }
+  reinterpret_cast<TDigest*>(*this_handle)
+      ->merge(*reinterpret_cast<const TDigest*>(that_handle));
+}
+
 bool ResultRows::reduceSingleRow(const int8_t* row_ptr,
                                  const int8_t warp_count,
                                  const bool is_columnar,
@@ -333,6 +333,34 @@ extern "C" ALWAYS_INLINE int8_t bit_is_set(const int64_t bitset,
              : 0;
 }
 
+// The search narrows the range down to a few values without branches, then compares
+// those all at once.
+extern "C" ALWAYS_INLINE int8_t value_in_sorted_set(const int64_t set,
+                                                    const int64_t set_size,
+                                                    const int64_t val,
+                                                    const int64_t null_val,
+                                                    const int8_t null_bool_val) {
+  if (val == null_val) {
+    return null_bool_val;
+  }
+  const auto values = reinterpret_cast<const int64_t*>(set);
+  if (val < values[0] || val > values[set_size - 1]) {
+    return false;
+  }
+  int64_t first = 0;
+  int64_t count = set_size;
+  while (count > 8) {
+    const int64_t half = count / 2;
+    first = values[first + half] <= val ? first + half : first;
+    count -= half;
+  }
+  int8_t found = 0;
+  for (int64_t i = 0; i < count; ++i) {
+    found |= values[first + i] == val;
+  }
+  return found;
+}
+
 extern "C" ALWAYS_INLINE int64_t agg_sum(int64_t* agg, const int64_t val) {
   const auto old = *agg;
   *agg += val;
@@ -20,14 +20,14 @@
 #include "Parser/ParserNode.h"
 
 extern "C" uint64_t string_decode(int8_t* chunk_iter_, int64_t pos) {
-  auto chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);
-  VarlenDatum vd;
-  bool is_end;
-  ChunkIter_get_nth(chunk_iter, pos, false, &vd, &is_end);
-  CHECK(!is_end);
-  return vd.is_null ? 0
-                    : (reinterpret_cast<uint64_t>(vd.pointer) & 0xffffffffffff) |
-                          (static_cast<uint64_t>(vd.length) << 48);
+  const auto chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_);
+  CHECK(pos >= 0 && static_cast<size_t>(pos) < chunk_iter->num_elems);
+  size_t length;
+  const int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, pos, &length);
+  // @TODO(wei) treat zero length as null for now
+  return length == 0 ? 0
+                     : (reinterpret_cast<uint64_t>(pointer) & 0xffffffffffff) |
+                           (static_cast<uint64_t>(length) << 48);
 }
 
 extern "C" uint64_t string_decompress(const int32_t string_id,
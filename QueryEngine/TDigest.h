@@ -0,0 +1,186 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TDigest.h
+ * @brief   Mergeable sketch of the distribution of a column, for approximate quantiles.
+ */
+
+#ifndef QUERYENGINE_TDIGEST_H
+#define QUERYENGINE_TDIGEST_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/**
+ * A merging t-digest: the values are summarized by centroids, i.e. means with weights,
+ * which are kept small at the tails of the distribution and allowed to grow in the
+ * middle, so that quantiles like 0.01 or 0.99 stay accurate. The size of a digest is
+ * bounded by its compression, whatever the number of values added to or merged into it.
+ *
+ * A digest also remembers the quantile which is asked of it, so that the pointer to it
+ * is all an aggregate slot has to hold. Reading a digest doesn't change it, so that it
+ * can be read from several threads, e.g. while sorting on it.
+ */
+class TDigest {
+ public:
+  explicit TDigest(const double compression = 100)
+      : compression_(compression)
+      , quantile_(0.5)
+      , total_weight_(0)
+      , min_(std::numeric_limits<double>::max())
+      , max_(std::numeric_limits<double>::lowest()) {}
+
+  void setQuantile(const double quantile) { quantile_ = quantile; }
+
+  double getQuantile() const { return quantile_; }
+
+  void add(const double value) {
+    buffer_.push_back(value);
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    if (buffer_.size() >= static_cast<size_t>(5 * compression_)) {
+      compress({});
+    }
+  }
+
+  // Adds all the values summarized by that to this digest; that is left as is.
+  void merge(const TDigest& that) {
+    if (that.empty()) {
+      return;
+    }
+    quantile_ = that.quantile_;
+    min_ = std::min(min_, that.min_);
+    max_ = std::max(max_, that.max_);
+    auto incoming = that.centroids_;
+    for (const auto value : that.buffer_) {
+      incoming.push_back({value, 1});
+    }
+    compress(incoming);
+  }
+
+  bool empty() const { return centroids_.empty() && buffer_.empty(); }
+
+  // Merges the values added since the last compression into the centroids, which a read
+  // would otherwise do on a copy of the digest every time.
+  void compress() { compress({}); }
+
+  // The value at the quantile set, NaN for an empty digest.
+  double quantile() const { return quantile(quantile_); }
+
+  double quantile(const double q) const {
+    if (!buffer_.empty()) {
+      TDigest compressed(*this);
+      compressed.compress({});
+      return compressed.quantile(q);
+    }
+    if (centroids_.empty()) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (centroids_.size() == 1) {
+      return centroids_.front().mean;
+    }
+    // Each centroid is taken to be centered on its mean, with the values between two
+    // centroids spread evenly between their means, and those before the first and after
+    // the last between them and the extremes.
+    const double index = std::max(0.0, std::min(1.0, q)) * total_weight_;
+    const auto& first = centroids_.front();
+    if (index < first.weight / 2) {
+      return min_ + (first.mean - min_) * index / (first.weight / 2);
+    }
+    double center_weight = first.weight / 2;
+    for (size_t i = 0; i + 1 < centroids_.size(); ++i) {
+      const auto& lhs = centroids_[i];
+      const auto& rhs = centroids_[i + 1];
+      const double gap = (lhs.weight + rhs.weight) / 2;
+      if (index < center_weight + gap) {
+        return lhs.mean + (rhs.mean - lhs.mean) * (index - center_weight) / gap;
+      }
+      center_weight += gap;
+    }
+    const auto& last = centroids_.back();
+    return std::min(max_,
+                    last.mean + (max_ - last.mean) * (index - center_weight) /
+                                    (last.weight / 2));
+  }
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  // The scale function k1 of the paper on t-digests and its inverse: centroids can span
+  // at most one unit of k, which is steep near quantiles 0 and 1.
+  double scale(const double q) const {
+    return compression_ / (2 * M_PI) * std::asin(2 * q - 1);
+  }
+
+  double inverseScale(const double k) const {
+    return (std::sin(std::min(k * 2 * M_PI / compression_, M_PI / 2)) + 1) / 2;
+  }
+
+  // Merges the buffered values and the incoming centroids into the centroids.
+  void compress(std::vector<Centroid> incoming) {
+    if (buffer_.empty() && incoming.empty()) {
+      return;
+    }
+    incoming.insert(incoming.end(), centroids_.begin(), centroids_.end());
+    for (const auto value : buffer_) {
+      incoming.push_back({value, 1});
+    }
+    buffer_.clear();
+    std::sort(
+        incoming.begin(), incoming.end(), [](const Centroid& lhs, const Centroid& rhs) {
+          return lhs.mean < rhs.mean;
+        });
+    double total_weight = 0;
+    for (const auto& centroid : incoming) {
+      total_weight += centroid.weight;
+    }
+    centroids_.clear();
+    centroids_.push_back(incoming.front());
+    double weight_before = 0;
+    double weight_limit = total_weight * inverseScale(scale(0) + 1);
+    for (size_t i = 1; i < incoming.size(); ++i) {
+      auto& current = centroids_.back();
+      const auto& next = incoming[i];
+      if (weight_before + current.weight + next.weight <= weight_limit) {
+        current.weight += next.weight;
+        current.mean += (next.mean - current.mean) * next.weight / current.weight;
+      } else {
+        weight_before += current.weight;
+        weight_limit =
+            total_weight * inverseScale(scale(weight_before / total_weight) + 1);
+        centroids_.push_back(next);
+      }
+    }
+    total_weight_ = total_weight;
+  }
+
+  double compression_;
+  double quantile_;
+  double total_weight_;
+  double min_;
+  double max_;
+  std::vector<Centroid> centroids_;  // by mean
+  std::vector<double> buffer_;       // values added since the last compression
+};
+
+#endif  // QUERYENGINE_TDIGEST_H
@@ -17,6 +17,7 @@
 #include "TableOptimizer.h"
 
 #include <Analyzer/Analyzer.h>
+#include <DataMgr/FileMgr/FileMgr.h>
 #include <Shared/scope.h>
 
 namespace {
@@ -209,3 +210,19 @@ void TableOptimizer::vacuumDeletedRows() const {
   auto& data_mgr = cat_.getDataMgr();
   data_mgr.checkpoint(cat_.getCurrentDB().dbId, table_id);
 }
+
+void TableOptimizer::compactChunks() const {
+  auto& data_mgr = cat_.getDataMgr();
+  const auto db_id = cat_.getCurrentDB().dbId;
+  for (const auto physical_td : cat_.getPhysicalTablesDescriptors(td_)) {
+    const auto table_id = physical_td->tableId;
+    const auto num_relocated = data_mgr.compactTableChunks(db_id, table_id);
+    if (num_relocated > 0) {
+      data_mgr.checkpoint(db_id, table_id);
+    }
+    const auto stats = data_mgr.getTableChunkLayoutStats(db_id, table_id);
+    LOG(INFO) << "Compacted " << num_relocated << " chunks of table "
+              << physical_td->tableName << ", " << stats.numScatteredChunks << " of "
+              << stats.numChunks << " chunks are left in more than one page run";
+  }
+}
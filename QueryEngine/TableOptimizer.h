@@ -55,6 +55,13 @@ class TableOptimizer {
    */
   void vacuumDeletedRows() const;
 
+  /**
+   * @brief Moves the chunks whose pages are scattered over the table's files into one
+   * contiguous run of pages each, so that they are read sequentially. The move is
+   * checkpointed, after which the pages moved from are reused.
+   */
+  void compactChunks() const;
+
  private:
   const TableDescriptor* td_;
   Executor* executor_;
@@ -863,13 +863,12 @@ extern "C" __device__ void agg_max_double_skip_val_shared(int64_t* agg,
 
 extern "C" __device__ uint64_t string_decode(int8_t* chunk_iter_, int64_t pos) {
   // TODO(alex): de-dup, the x64 version is basically identical
-  ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);
-  VarlenDatum vd;
-  bool is_end;
-  ChunkIter_get_nth(chunk_iter, pos, false, &vd, &is_end);
-  return vd.is_null ? 0
-                    : (reinterpret_cast<uint64_t>(vd.pointer) & 0xffffffffffff) |
-                          (static_cast<uint64_t>(vd.length) << 48);
+  const ChunkIter* chunk_iter = reinterpret_cast<const ChunkIter*>(chunk_iter_);
+  size_t length;
+  const int8_t* pointer = ChunkIter_get_nth_varlen(chunk_iter, pos, &length);
+  return length == 0 ? 0
+                     : (reinterpret_cast<uint64_t>(pointer) & 0xffffffffffff) |
+                           (static_cast<uint64_t>(length) << 48);
 }
 
 extern "C" __device__ void linear_probabilistic_count(uint8_t* bitmap,
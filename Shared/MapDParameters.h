@@ -27,23 +27,33 @@
 #include <string>
 
 struct MapDParameters {
-  size_t cuda_block_size = 0;       // block size for the kernel execution
-  size_t cuda_grid_size = 0;        // grid size for the kernel execution
-  size_t calcite_max_mem = 1024;    // max memory for calcite jvm in MB
-  int omnisci_server_port = 6274;   // default port omnisci_server runs on
-  int calcite_port = 6279;          // default port for calcite server to run on
-  std::string ha_group_id;          // name of the HA group this server is in
-  std::string ha_unique_server_id;  // name of the HA unique id for this server
-  std::string ha_brokers;           // name of the HA broker
-  std::string ha_shared_data;       // name of shared data directory base
-  bool is_decr_start_epoch;         // are we doing a start epoch decrement?
+  size_t cuda_block_size = 0;        // block size for the kernel execution
+  size_t cuda_grid_size = 0;         // grid size for the kernel execution
+  size_t calcite_max_mem = 1024;     // max memory for calcite jvm in MB
+  int omnisci_server_port = 6274;    // default port omnisci_server runs on
+  int calcite_port = 6279;           // default port for calcite server to run on
+  bool calcite_in_process = false;   // host calcite in an embedded JVM instead
+  bool calcite_binary_plan = false;  // get executable plans from calcite in binary form
+  std::string ha_group_id;           // name of the HA group this server is in
+  std::string ha_unique_server_id;   // name of the HA unique id for this server
+  std::string ha_brokers;            // name of the HA broker
+  std::string ha_shared_data;        // name of shared data directory base
+  bool is_decr_start_epoch;          // are we doing a start epoch decrement?
   size_t cpu_buffer_mem_bytes = 0;  // max size of memory reserved for CPU buffers [bytes]
   size_t gpu_buffer_mem_bytes = 0;  // max size of memory reserved for GPU buffers [bytes]
+  std::string cpu_buffer_mem_path = "";  // tmpfs/hugetlbfs directory for CPU buffers
+  bool cpu_buffer_prewarm = false;       // reload the most used chunks on start
+  size_t cpu_buffer_prewarm_rate = 256;  // max rate of the reloads [MB/s]
+  std::string disk_cache_path = "";  // local directory caching chunks read from disk
+  size_t disk_cache_bytes = 0;       // max size of the local disk cache [bytes]
+  bool narrow_chunks = false;  // store integer chunks as narrow offsets from a base
+  size_t chunk_growth_pages = 0;  // extra pages growing chunks take along in one run
   double gpu_input_mem_limit = 0.9;  // Punt query to CPU if input mem exceeds % GPU mem
   std::string ssl_cert_file = "";    // file path to server's certified PKI certificate
   std::string ssl_key_file = "";     // file path to server's' private PKI key
   std::string ssl_trust_store = "";  // file path to java jks version of ssl_key_fle
   std::string ssl_trust_password = "";  // pass phrae for java jks trust store.
+  size_t calcite_planner_pool_size = 8;
   bool aggregator = false;
   MapDParameters() : cuda_block_size(0), cuda_grid_size(0), calcite_max_mem(1024) {}
 };
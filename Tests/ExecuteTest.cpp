@@ -1398,6 +1398,50 @@ TEST(Select, ApproxCountDistinct) {
   }
 }
 
+TEST(Select, ApproxPercentile) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // fifteen rows with x = 7, five with x = 8
+    ASSERT_NEAR(
+        static_cast<double>(7),
+        v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(x, 0) FROM test;", dt)),
+        static_cast<double>(0.001));
+    ASSERT_NEAR(
+        static_cast<double>(7),
+        v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(x, 0.5) FROM test;", dt)),
+        static_cast<double>(0.001));
+    ASSERT_NEAR(
+        static_cast<double>(8),
+        v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(x, 1) FROM test;", dt)),
+        static_cast<double>(0.001));
+    ASSERT_NEAR(
+        static_cast<double>(8),
+        v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(x, 0.99) FROM test;", dt)),
+        static_cast<double>(0.001));
+    ASSERT_EQ(std::numeric_limits<double>::min(),
+              v<double>(run_simple_agg(
+                  "SELECT APPROX_PERCENTILE(x, 0.5) FROM test WHERE x > 8;", dt)));
+    {
+      const auto rows = run_multiple_agg(
+          "SELECT x, APPROX_PERCENTILE(x, 0.9) AS p, APPROX_PERCENTILE(y, 0) FROM test "
+          "GROUP BY x ORDER BY p DESC;",
+          dt);
+      ASSERT_EQ(size_t(2), rows->rowCount());
+      for (const auto expected_x : {8, 7}) {
+        const auto crt_row = rows->getNextRow(true, true);
+        ASSERT_EQ(expected_x, v<int64_t>(crt_row[0]));
+        ASSERT_NEAR(static_cast<double>(expected_x),
+                    v<double>(crt_row[1]),
+                    static_cast<double>(0.001));
+      }
+    }
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, 2) FROM test;", dt),
+                 std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, y) FROM test;", dt),
+                 std::runtime_error);
+  }
+}
+
 TEST(Select, ScanNoAggregation) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -3631,6 +3675,13 @@ TEST(Select, In) {
     c("SELECT COUNT(*) FROM test WHERE x IN (1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, "
       "14, 15, 16, 17, 18, 19, 20);",
       dt);
+    // too sparse for a bitmap
+    c("SELECT COUNT(*) FROM test WHERE t IN (1001, 1002, -5000000000000, 9000000000000, "
+      "123456789012, NULL);",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE t NOT IN (1001, -5000000000000, 9000000000000, "
+      "123456789012);",
+      dt);
   }
 }
 
@@ -4429,6 +4480,44 @@ void import_gpu_sort_test() {
   }
 }
 
+const size_t g_sample_test_row_count{100000};
+
+// A thousand strings, added to the dictionary in an order unlike theirs.
+std::string sample_test_str(const size_t row_idx) {
+  return "str" + std::to_string(row_idx * 7919 % 1000);
+}
+
+// Big enough for projections to run a filtered count first; x cycles through 0 to 9, so
+// every fragment holds as many rows of each x.
+void import_sample_test() {
+  run_ddl_statement("DROP TABLE IF EXISTS sample_test;");
+  run_ddl_statement(
+      "CREATE TABLE sample_test(x int, y int, f float, str text encoding dict) WITH "
+      "(fragment_size=10000);");
+  auto& cat = g_session->getCatalog();
+  const auto td = cat.getMetadataForTable("sample_test");
+  CHECK(td);
+  auto loader = get_loader(td);
+  std::vector<std::unique_ptr<Importer_NS::TypedImportBuffer>> import_buffers;
+  const auto col_descs =
+      cat.getAllColumnMetadataForTable(td->tableId, false, false, false);
+  for (const auto cd : col_descs) {
+    import_buffers.emplace_back(new Importer_NS::TypedImportBuffer(
+        cd,
+        cd->columnType.get_compression() == kENCODING_DICT
+            ? cat.getMetadataForDict(cd->columnType.get_comp_param())->stringDict.get()
+            : nullptr));
+  }
+  CHECK_EQ(size_t(4), import_buffers.size());
+  for (size_t row_idx = 0; row_idx < g_sample_test_row_count; ++row_idx) {
+    import_buffers[0]->addInt(row_idx % 10);
+    import_buffers[1]->addInt(row_idx);
+    import_buffers[2]->addFloat(row_idx % 10);
+    import_buffers[3]->addString(sample_test_str(row_idx));
+  }
+  loader->load(import_buffers, g_sample_test_row_count);
+}
+
 void import_query_rewrite_test() {
   const std::string drop_old_query_rewrite_test{
       "DROP TABLE IF EXISTS query_rewrite_test;"};
@@ -5202,6 +5291,124 @@ TEST(Select, GpuSort) {
   }
 }
 
+TEST(Select, OrderByLimitFragmentSkipping) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x FROM gpu_sort_test ORDER BY x DESC LIMIT 3;", dt);
+    c("SELECT x FROM gpu_sort_test ORDER BY x LIMIT 5;", dt);
+    c("SELECT x FROM gpu_sort_test ORDER BY x LIMIT 2 OFFSET 3;", dt);
+    c("SELECT x FROM gpu_sort_test ORDER BY x DESC LIMIT 2 OFFSET 5;", dt);
+  }
+}
+
+TEST(Select, OrderByDictEncodedStrings) {
+  const auto cpu_radix_sort_state = g_enable_cpu_radix_sort;
+  ScopeGuard reset_cpu_radix_sort = [&cpu_radix_sort_state] {
+    g_enable_cpu_radix_sort = cpu_radix_sort_state;
+  };
+  std::vector<std::string> expected_strs;
+  for (size_t row_idx = 0; row_idx < g_sample_test_row_count; ++row_idx) {
+    expected_strs.push_back(sample_test_str(row_idx));
+  }
+  std::sort(expected_strs.begin(), expected_strs.end());
+  // enough rows for the radix sort, which sorts the dictionary ids by their strings
+  for (const bool cpu_radix_sort : {false, true}) {
+    g_enable_cpu_radix_sort = cpu_radix_sort;
+    for (const bool desc : {false, true}) {
+      const std::string query{"SELECT str FROM sample_test ORDER BY str" +
+                              std::string(desc ? " DESC;" : ";")};
+      const auto rows = run_multiple_agg(query, ExecutorDeviceType::CPU);
+      ASSERT_EQ(expected_strs.size(), rows->rowCount());
+      for (size_t i = 0; i < expected_strs.size(); ++i) {
+        const auto crt_row = rows->getNextRow(true, true);
+        ASSERT_EQ(size_t(1), crt_row.size());
+        ASSERT_EQ(desc ? expected_strs[expected_strs.size() - 1 - i] : expected_strs[i],
+                  boost::get<std::string>(v<NullableString>(crt_row[0])));
+      }
+    }
+  }
+}
+
+TEST(Select, LimitedScanEarlyExit) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x FROM gpu_sort_test WHERE x > 1 LIMIT 5;", dt);
+    c("SELECT x FROM gpu_sort_test WHERE x > 1 LIMIT 3 OFFSET 3;", dt);
+    c("SELECT x FROM gpu_sort_test WHERE x > 2 LIMIT 2;", dt);
+    c("SELECT COUNT(*) FROM (SELECT x FROM gpu_sort_test WHERE x > 1 LIMIT 7);", dt);
+  }
+  // one kernel at a time, so that the later kernels are left out once the earlier ones
+  // have found enough rows
+  const auto limited_scan_max_kernels_state = g_limited_scan_max_kernels;
+  g_limited_scan_max_kernels = 1;
+  ScopeGuard reset_limited_scan_max_kernels = [&limited_scan_max_kernels_state] {
+    g_limited_scan_max_kernels = limited_scan_max_kernels_state;
+  };
+  const auto dt = ExecutorDeviceType::CPU;
+  // the first two of the five fragments hold enough rows
+  ASSERT_EQ(size_t(3),
+            run_multiple_agg("SELECT x FROM gpu_sort_test LIMIT 3;", dt)->rowCount());
+  c("SELECT COUNT(*) FROM (SELECT x FROM gpu_sort_test LIMIT 3);", dt);
+  // without a LIMIT, the scan limit is the filtered count and every kernel has to run
+  c("SELECT x FROM gpu_sort_test WHERE x > 1;", dt);
+}
+
+TEST(Select, FragmentSampling) {
+  const auto fragment_sample_rate_state = g_fragment_sample_rate;
+  g_fragment_sample_rate = 0.5;
+  ScopeGuard reset_fragment_sample_rate = [&fragment_sample_rate_state] {
+    g_fragment_sample_rate = fragment_sample_rate_state;
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // all the fragments of gpu_sort_test hold two rows, the scaled count is exact
+    ASSERT_EQ(int64_t(10),
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM gpu_sort_test;", dt)));
+    const auto approx_distinct_count = v<int64_t>(
+        run_simple_agg("SELECT APPROX_COUNT_DISTINCT(x) FROM gpu_sort_test;", dt));
+    ASSERT_GE(approx_distinct_count, int64_t(1));
+    ASSERT_LE(approx_distinct_count, int64_t(2));
+    // projections aren't sampled
+    c("SELECT x FROM gpu_sort_test ORDER BY x;", dt);
+    // and neither is the filtered count they run first to size their output, which
+    // would be off here since only the first three fragments have matching rows
+    ASSERT_EQ(size_t(25000),
+              run_multiple_agg("SELECT x FROM sample_test WHERE y < 25000;", dt)
+                  ->rowCount());
+    // all the fragments of sample_test are alike, the scaled counts and sums are exact
+    ASSERT_EQ(static_cast<int64_t>(g_sample_test_row_count),
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM sample_test;", dt)));
+    ASSERT_EQ(static_cast<int64_t>(g_sample_test_row_count / 10 * 45),
+              v<int64_t>(run_simple_agg("SELECT SUM(x) FROM sample_test;", dt)));
+    ASSERT_FLOAT_EQ(static_cast<float>(g_sample_test_row_count / 10 * 45),
+                    v<float>(run_simple_agg("SELECT SUM(f) FROM sample_test;", dt)));
+    ASSERT_DOUBLE_EQ(
+        static_cast<double>(g_sample_test_row_count / 10 * 45),
+        v<double>(run_simple_agg("SELECT SUM(CAST(f AS DOUBLE)) FROM sample_test;", dt)));
+    ASSERT_DOUBLE_EQ(4.5,
+                     v<double>(run_simple_agg("SELECT AVG(x) FROM sample_test;", dt)));
+    ASSERT_EQ(int64_t(0),
+              v<int64_t>(run_simple_agg("SELECT MIN(x) FROM sample_test;", dt)));
+    ASSERT_EQ(int64_t(9),
+              v<int64_t>(run_simple_agg("SELECT MAX(x) FROM sample_test;", dt)));
+    // no ORDER BY, sorted results aren't sampled
+    const auto rows = run_multiple_agg(
+        "SELECT x, COUNT(*), SUM(x), AVG(x), MAX(x) FROM sample_test GROUP BY x;", dt);
+    ASSERT_EQ(size_t(10), rows->rowCount());
+    for (size_t i = 0; i < 10; ++i) {
+      const auto crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(size_t(5), crt_row.size());
+      const auto x = v<int64_t>(crt_row[0]);
+      ASSERT_EQ(static_cast<int64_t>(g_sample_test_row_count / 10),
+                v<int64_t>(crt_row[1]));
+      ASSERT_EQ(static_cast<int64_t>(g_sample_test_row_count / 10) * x,
+                v<int64_t>(crt_row[2]));
+      ASSERT_DOUBLE_EQ(static_cast<double>(x), v<double>(crt_row[3]));
+      ASSERT_EQ(x, v<int64_t>(crt_row[4]));
+    }
+  }
+}
+
 TEST(Select, GroupByConstrainedByInQueryRewrite) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -5438,6 +5645,72 @@ TEST(Select, Empty) {
   }
 }
 
+TEST(Select, ColumnarIntermediateResults) {
+  const auto columnar_intermediate_results_state = g_enable_columnar_intermediate_results;
+  ScopeGuard reset_columnar_intermediate_results =
+      [&columnar_intermediate_results_state] {
+        g_enable_columnar_intermediate_results = columnar_intermediate_results_state;
+      };
+  // the filtered input of the join is a step of its own, read back by the join
+  const std::vector<std::string> queries{
+      "SELECT COUNT(*) FROM test a JOIN (SELECT x, y + 1 AS w FROM test WHERE y < 43) b "
+      "ON a.x = b.x;",
+      "SELECT SUM(b.w) FROM test a JOIN (SELECT x, y + 1 AS w FROM test WHERE y < 43) b "
+      "ON a.x = b.x;",
+      "SELECT a.x, COUNT(*) FROM test a JOIN (SELECT x, y * 2 AS w FROM test WHERE y > "
+      "41) b ON a.x = b.x GROUP BY a.x ORDER BY a.x;"};
+  for (const bool columnar_intermediate_results : {false, true}) {
+    g_enable_columnar_intermediate_results = columnar_intermediate_results;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      for (const auto& query : queries) {
+        c(query, dt);
+      }
+    }
+  }
+
+  // the columns of a columnar projection held in a single storage are used in place
+  const auto columnar_output_state = g_enable_columnar_output;
+  ScopeGuard reset_columnar_output = [&columnar_output_state] {
+    g_enable_columnar_output = columnar_output_state;
+    run_ddl_statement("DROP TABLE IF EXISTS columnar_in_place_test;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS columnar_in_place_test;");
+  run_ddl_statement("CREATE TABLE columnar_in_place_test(x bigint, y bigint);");
+  for (int64_t i = 0; i < 10; ++i) {
+    const std::string insert_query{"INSERT INTO columnar_in_place_test VALUES(" +
+                                   std::to_string(i) + ", " + std::to_string(2 * i) +
+                                   ");"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+  }
+  g_enable_columnar_output = true;
+  const auto rows = run_multiple_agg(
+      "SELECT x + 1, y * 2 FROM columnar_in_place_test WHERE x < 5;",
+      ExecutorDeviceType::CPU);
+  ASSERT_TRUE(rows->isFastColumnarConversionPossible());
+  std::vector<SQLTypeInfo> target_types;
+  for (size_t i = 0; i < rows->colCount(); ++i) {
+    target_types.push_back(rows->getColType(i));
+  }
+  const ColumnarResults columnar_results(
+      rows->getRowSetMemOwner(), rows, target_types.size(), target_types);
+  const auto storage = rows->getStorage();
+  ASSERT_TRUE(storage);
+  const auto storage_begin = storage->getUnderlyingBuffer();
+  const auto storage_end =
+      storage_begin + rows->getQueryMemDesc().getBufferSizeBytes(ExecutorDeviceType::CPU);
+  const auto& column_buffers = columnar_results.getColumnBuffers();
+  ASSERT_EQ(size_t(2), column_buffers.size());
+  for (const auto column_buffer : column_buffers) {
+    ASSERT_GE(column_buffer, storage_begin);
+    ASSERT_LT(column_buffer, storage_end);
+  }
+  for (int64_t i = 0; i < 5; ++i) {
+    ASSERT_EQ(i + 1, reinterpret_cast<const int64_t*>(column_buffers[0])[i]);
+    ASSERT_EQ(4 * i, reinterpret_cast<const int64_t*>(column_buffers[1])[i]);
+  }
+}
+
 TEST(Select, Subqueries) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -5447,6 +5720,9 @@ TEST(Select, Subqueries) {
     c("SELECT COUNT(*) FROM test, (SELECT x FROM test_inner) AS inner_x WHERE test.x "
       "= inner_x.x;",
       dt);
+    c("SELECT SUM(x_plus_y * 2), x FROM (SELECT x + y AS x_plus_y, x FROM test) GROUP BY "
+      "x ORDER BY x;",
+      dt);
     c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM test WHERE y > 42);", dt);
     c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM test GROUP BY x ORDER BY "
       "COUNT(*) DESC LIMIT 1);",
@@ -13248,6 +13524,12 @@ int create_and_populate_tables(bool with_delete_support = true) {
     LOG(ERROR) << "Failed to (re-)create table 'query_rewrite_test'";
     return -EEXIST;
   }
+  try {
+    import_sample_test();
+  } catch (...) {
+    LOG(ERROR) << "Failed to (re-)create table 'sample_test'";
+    return -EEXIST;
+  }
   try {
     import_big_decimal_range_test();
   } catch (...) {
@@ -13483,6 +13765,7 @@ void drop_tables() {
   g_sqlite_comparator.query(drop_gpu_sort_test);
   const std::string drop_query_rewrite_test{"DROP TABLE query_rewrite_test;"};
   run_ddl_statement(drop_query_rewrite_test);
+  run_ddl_statement("DROP TABLE sample_test;");
   const std::string drop_big_decimal_range_test{"DROP TABLE big_decimal_range_test;"};
   run_ddl_statement(drop_big_decimal_range_test);
   const std::string drop_decimal_compression_test{"DROP TABLE decimal_compression_test;"};
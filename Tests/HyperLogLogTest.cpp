@@ -0,0 +1,162 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/HyperLogLog.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// The registers of a HyperLogLog record after adding n random hashes to it.
+template <typename T>
+std::vector<T> make_registers(const size_t bitmap_sz_bits,
+                              const size_t n,
+                              std::mt19937_64& generator) {
+  std::vector<T> M(size_t(1) << bitmap_sz_bits, 0);
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t hash = generator();
+    const auto idx = hash >> (64 - bitmap_sz_bits);
+    const auto rest = hash << bitmap_sz_bits;
+    const T rank = rest ? __builtin_clzll(rest) + 1 : 64 - bitmap_sz_bits + 1;
+    M[idx] = std::max(M[idx], rank);
+  }
+  return M;
+}
+
+// The estimate one register at a time, the way hll_size used to compute it.
+template <typename T>
+double reference_hll_size(const T* M, const size_t bitmap_sz_bits) {
+  const size_t m = 1 << bitmap_sz_bits;
+  double sum{0};
+  uint32_t zeros{0};
+  for (size_t i = 0; i < m; ++i) {
+    sum += 1.0 / (1ULL << M[i]);
+    zeros += M[i] == 0;
+  }
+  double estimate = get_alpha(m) * m * m / sum;
+  if (estimate <= 2.5 * m) {
+    if (zeros != 0) {
+      estimate = m * log(static_cast<double>(m) / zeros);
+    }
+  } else if (bitmap_sz_bits == 14) {
+    estimate = get_alpha(m) * m * (m - zeros) / (get_beta(zeros) + sum);
+  }
+  return estimate;
+}
+
+template <typename T>
+void check_register_stats(const std::vector<T>& M, const size_t m) {
+  CHECK_LE(m, M.size());
+  double sum{0};
+  uint32_t zeros{0};
+  for (size_t i = 0; i < m; ++i) {
+    sum += 1.0 / (1ULL << M[i]);
+    zeros += M[i] == 0;
+  }
+  const auto stats = get_register_stats(M.data(), m);
+  ASSERT_EQ(zeros, stats.zeros);
+  ASSERT_NEAR(sum, stats.harmonic_mean_denominator, sum * 1e-12);
+}
+
+template <typename T>
+void check_hll_size(const size_t bitmap_sz_bits, const size_t n) {
+  std::mt19937_64 generator(bitmap_sz_bits * 1000003 + n);
+  const auto M = make_registers<T>(bitmap_sz_bits, n, generator);
+  check_register_stats(M, M.size());
+  const auto expected = reference_hll_size(M.data(), bitmap_sz_bits);
+  ASSERT_NEAR(expected, static_cast<double>(hll_size(M.data(), bitmap_sz_bits)), 1.0);
+}
+
+template <typename T1, typename T2>
+void check_hll_unify(const size_t m) {
+  std::mt19937_64 generator(m);
+  auto lhs = make_registers<T1>(10, 5000, generator);
+  auto rhs = make_registers<T2>(10, 5000, generator);
+  CHECK_LE(m, lhs.size());
+  std::vector<int8_t> expected(m);
+  for (size_t i = 0; i < m; ++i) {
+    expected[i] = std::max(static_cast<int8_t>(lhs[i]), static_cast<int8_t>(rhs[i]));
+  }
+  const auto lhs_past_m = lhs[m];
+  const auto rhs_past_m = rhs[m];
+  hll_unify(lhs.data(), rhs.data(), m);
+  for (size_t i = 0; i < m; ++i) {
+    ASSERT_EQ(expected[i], lhs[i]);
+    ASSERT_EQ(expected[i], rhs[i]);
+  }
+  ASSERT_EQ(lhs_past_m, lhs[m]);
+  ASSERT_EQ(rhs_past_m, rhs[m]);
+}
+
+}  // namespace
+
+TEST(HyperLogLog, RegisterStatsTail) {
+  std::mt19937_64 generator(42);
+  const auto M8 = make_registers<int8_t>(10, 2000, generator);
+  const auto M32 = make_registers<int32_t>(10, 2000, generator);
+  for (const size_t m : {size_t(7), 3 * hll_lanes, 3 * hll_lanes + 7, size_t(1000)}) {
+    check_register_stats(M8, m);
+    check_register_stats(M32, m);
+  }
+}
+
+TEST(HyperLogLog, Size) {
+  // p=14 is the only precision with the LogLog-Beta adjustment; the small cardinalities
+  // are linearly counted instead
+  for (const size_t n : {size_t(100), size_t(10000), size_t(1000000)}) {
+    check_hll_size<int8_t>(14, n);
+    check_hll_size<int32_t>(14, n);
+  }
+  // fewer registers than lanes, all of them in the tail
+  check_hll_size<int8_t>(3, 100);
+  check_hll_size<int32_t>(3, 100);
+  check_hll_size<int8_t>(11, 100000);
+  check_hll_size<int32_t>(11, 100000);
+}
+
+TEST(HyperLogLog, SizeEstimate) {
+  const size_t n{1000000};
+  std::mt19937_64 generator(7);
+  const auto M = make_registers<int8_t>(14, n, generator);
+  ASSERT_NEAR(
+      static_cast<double>(n), static_cast<double>(hll_size(M.data(), 14)), 0.05 * n);
+}
+
+TEST(HyperLogLog, Unify) {
+  for (const size_t m : {size_t(7), 4 * hll_lanes, 4 * hll_lanes + 9, size_t(1000)}) {
+    check_hll_unify<int8_t, int8_t>(m);
+    check_hll_unify<int32_t, int32_t>(m);
+    check_hll_unify<int8_t, int32_t>(m);
+    check_hll_unify<int32_t, int8_t>(m);
+  }
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -24,6 +24,7 @@
 #include "../QueryEngine/ResultRows.h"
 #include "../QueryEngine/ResultSet.h"
 #include "../QueryEngine/RuntimeFunctions.h"
+#include "../Shared/measure.h"
 #include "ResultSetTestUtils.h"
 
 #ifdef HAVE_CUDA
@@ -37,6 +38,8 @@ extern std::unique_ptr<CudaMgr_Namespace::CudaMgr> g_cuda_mgr;
 
 #include <numeric>
 
+extern bool g_enable_cpu_radix_sort;
+
 namespace {
 
 std::vector<TargetInfo> get_sort_int_target_infos() {
@@ -219,8 +222,111 @@ void SortBaselineIntegersTestImpl(const bool desc) {
   check_sorted<int64_t>(*rs, desc ? upper_bound : lower_bound, top_n, desc);
 }
 
+std::vector<TargetInfo> get_sort_multi_target_infos() {
+  std::vector<TargetInfo> target_infos;
+  SQLTypeInfo null_ti(kNULLT, false);
+  SQLTypeInfo int_ti(kBIGINT, false);
+  SQLTypeInfo fp_ti(kDOUBLE, false);
+  SQLTypeInfo count_ti(kBIGINT, true);
+  target_infos.push_back(TargetInfo{true, kMIN, int_ti, int_ti, true, false});
+  target_infos.push_back(TargetInfo{true, kMAX, fp_ti, fp_ti, true, false});
+  target_infos.push_back(TargetInfo{true, kCOUNT, count_ti, null_ti, false, false});
+  return target_infos;
+}
+
+// Few distinct values in the first two targets, so that the later order entries matter,
+// and nulls in the first one.
+void fill_storage_buffer_baseline_sort_multi(int8_t* buff,
+                                             const std::vector<TargetInfo>& target_infos,
+                                             const QueryMemoryDescriptor& query_mem_desc,
+                                             const int64_t group_count) {
+  const auto key_component_count = query_mem_desc.getKeyCount();
+  const auto i64_buff = reinterpret_cast<int64_t*>(buff);
+  const auto target_slot_count = get_slot_count(target_infos);
+  for (size_t i = 0; i < query_mem_desc.getEntryCount(); ++i) {
+    const auto first_key_comp_offset =
+        key_offset_rowwise(i, key_component_count, target_slot_count);
+    for (size_t key_comp_idx = 0; key_comp_idx < key_component_count; ++key_comp_idx) {
+      i64_buff[first_key_comp_offset + key_comp_idx] = EMPTY_KEY_64;
+    }
+  }
+  std::vector<int64_t> keys(group_count);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::random_shuffle(keys.begin(), keys.end());
+  for (const auto key_val : keys) {
+    std::vector<int64_t> key(key_component_count, key_val);
+    auto value_slots = get_group_value(i64_buff,
+                                       query_mem_desc.getEntryCount(),
+                                       &key[0],
+                                       key.size(),
+                                       sizeof(int64_t),
+                                       key_component_count + target_slot_count,
+                                       nullptr);
+    CHECK(value_slots);
+    value_slots[0] = key_val % 17 ? key_val % 100 : NULL_BIGINT;
+    const double fp_val = (key_val % 1000) / 7. - 50;
+    value_slots[1] = *reinterpret_cast<const int64_t*>(may_alias_ptr(&fp_val));
+    value_slots[2] = key_val;
+  }
+}
+
+void check_sorted_multi(const ResultSet& radix_sorted, const ResultSet& compare_sorted) {
+  ASSERT_EQ(compare_sorted.rowCount(), radix_sorted.rowCount());
+  while (true) {
+    const auto row = radix_sorted.getNextRow(true, false);
+    const auto ref_row = compare_sorted.getNextRow(true, false);
+    ASSERT_EQ(ref_row.empty(), row.empty());
+    if (row.empty()) {
+      break;
+    }
+    ASSERT_EQ(size_t(3), row.size());
+    ASSERT_EQ(v<int64_t>(ref_row[0]), v<int64_t>(row[0]));
+    ASSERT_EQ(v<double>(ref_row[1]), v<double>(row[1]));
+  }
+}
+
 }  // namespace
 
+TEST(SortRadix, MultiColumn) {
+  const auto target_infos = get_sort_multi_target_infos();
+  const auto query_mem_desc = baseline_sort_desc(target_infos, 1 << 20, 8);
+  const int64_t group_count = 600000;
+  for (const bool desc : {true, false}) {
+    for (const bool nulls_first : {true, false}) {
+      std::unique_ptr<ResultSet> rs_by_type[2];
+      for (auto& rs : rs_by_type) {
+        rs.reset(new ResultSet(target_infos,
+                               ExecutorDeviceType::CPU,
+                               query_mem_desc,
+                               std::make_shared<RowSetMemoryOwner>(),
+                               nullptr));
+      }
+      auto storage = rs_by_type[0]->allocateStorage();
+      fill_storage_buffer_baseline_sort_multi(
+          storage->getUnderlyingBuffer(), target_infos, query_mem_desc, group_count);
+      memcpy(rs_by_type[1]->allocateStorage()->getUnderlyingBuffer(),
+             storage->getUnderlyingBuffer(),
+             query_mem_desc.getBufferSizeBytes(ExecutorDeviceType::CPU));
+      std::list<Analyzer::OrderEntry> order_entries;
+      order_entries.emplace_back(1, desc, nulls_first);
+      order_entries.emplace_back(2, !desc, nulls_first);
+      int64_t elapsed_ms[2];
+      for (const bool radix_sort : {true, false}) {
+        g_enable_cpu_radix_sort = radix_sort;
+        auto& rs = rs_by_type[radix_sort ? 0 : 1];
+        elapsed_ms[radix_sort ? 0 : 1] =
+            measure<>::execution([&rs, &order_entries]() { rs->sort(order_entries, 0); });
+      }
+      g_enable_cpu_radix_sort = true;
+      LOG(INFO) << "Sorted " << group_count << " groups in " << elapsed_ms[0]
+                << " ms with the radix sort, " << elapsed_ms[1]
+                << " ms with comparisons";
+      check_sorted_multi(*rs_by_type[0], *rs_by_type[1]);
+      ASSERT_EQ(nulls_first, v<int64_t>(rs_by_type[0]->getRowAt(0)[0]) == NULL_BIGINT);
+    }
+  }
+}
+
 TEST(SortBaseline, IntegersKey64) {
   for (const bool desc : {true, false}) {
     SortBaselineIntegersTestImpl<int64_t>(desc);
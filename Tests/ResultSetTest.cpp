@@ -3300,6 +3300,30 @@ TEST(ReduceRandomGroups, BaselineHashColumnar_Large_NullVal_0075) {
       target_infos, query_mem_desc, gen1, gen2, prct1, prct2, silent, 2);
 }
 
+TEST(GroupByBufferPool, Recycle) {
+  auto& pool = GroupByBufferPool::instance();
+  pool.clear();
+  for (const size_t num_bytes : {size_t(100), size_t(65537), size_t(3000000)}) {
+    const auto size_class = GroupByBufferPool::getSizeClass(num_bytes);
+    ASSERT_GE(size_class, num_bytes);
+    ASSERT_LE(size_class, num_bytes + num_bytes / 4 + sizeof(int64_t));
+  }
+  const size_t num_bytes{1 << 20};
+  auto buffer = pool.allocate(num_bytes);
+  memset(buffer, 0xff, num_bytes);
+  pool.release(buffer, num_bytes);
+  ASSERT_EQ(num_bytes, pool.getPooledBytes());
+  auto zeroed = pool.allocateZeroed(num_bytes - 8);
+  ASSERT_EQ(buffer, zeroed);
+  ASSERT_EQ(size_t(0), pool.getPooledBytes());
+  const auto bytes = reinterpret_cast<const int8_t*>(zeroed);
+  ASSERT_TRUE(std::all_of(
+      bytes, bytes + num_bytes - 8, [](const int8_t byte) { return byte == 0; }));
+  pool.release(zeroed, num_bytes - 8);
+  pool.clear();
+  ASSERT_EQ(size_t(0), pool.getPooledBytes());
+}
+
 int main(int argc, char** argv) {
   google::InitGoogleLogging(argv[0]);
   testing::InitGoogleTest(&argc, argv);
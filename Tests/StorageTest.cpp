@@ -22,13 +22,19 @@
 #include <cstdlib>
 #include <exception>
 #include <memory>
+#include <numeric>
 
 #include <thread>
 
 #include <boost/functional/hash.hpp>
 #include "../Analyzer/Analyzer.h"
 #include "../Catalog/Catalog.h"
+#include "../DataMgr/BufferMgr/BufferPoolPrewarmer.h"
+#include "../DataMgr/BufferMgr/CpuBufferMgr/CpuBufferMgr.h"
 #include "../DataMgr/DataMgr.h"
+#include "../DataMgr/FileMgr/DiskCacheMgr.h"
+#include "../DataMgr/FileMgr/FileBuffer.h"
+#include "../DataMgr/FileMgr/GlobalFileMgr.h"
 #include "../Fragmenter/Fragmenter.h"
 #include "../Parser/ParserNode.h"
 #include "../Parser/parser.h"
@@ -36,6 +42,7 @@
 #include "PopulateTableRandom.h"
 #include "ScanTable.h"
 #include "Shared/MapDParameters.h"
+#include "Shared/measure.h"
 #include "boost/filesystem.hpp"
 #include "boost/program_options.hpp"
 #include "glog/logging.h"
@@ -167,6 +174,187 @@ bool storage_test_parallel(const string& table_name,
       scan_table_return_hash_non_iter(table_name, gsession->getCatalog());
   return scan_col_hashs == scan_col_hashs2;
 }
+
+// Stands for every chunk of a SyntheticChunkSource when asked for one directly.
+class SyntheticChunk : public AbstractBuffer {
+ public:
+  SyntheticChunk(const size_t chunk_size) : AbstractBuffer(0) { size_ = chunk_size; }
+
+  void read(int8_t* const dst,
+            const size_t num_bytes,
+            const size_t offset,
+            const MemoryLevel dst_buffer_type,
+            const int dst_device_id) override {
+    CHECK(false);
+  }
+  void write(int8_t* src,
+             const size_t num_bytes,
+             const size_t offset,
+             const MemoryLevel src_buffer_type,
+             const int src_device_id) override {
+    CHECK(false);
+  }
+  void reserve(size_t num_bytes) override {}
+  void append(int8_t* src,
+              const size_t num_bytes,
+              const MemoryLevel src_buffer_type,
+              const int device_id) override {
+    CHECK(false);
+  }
+  int8_t* getMemoryPtr() override { return nullptr; }
+  size_t pageCount() const override { return 1; }
+  size_t pageSize() const override { return size_; }
+  size_t size() const override { return size_; }
+  size_t reservedSize() const override { return size_; }
+  MemoryLevel getType() const override { return DISK_LEVEL; }
+};
+
+// Serves chunks of a fixed size without any storage behind them and counts the
+// fetches, so that a buffer pool can be exercised on its own. Every byte of a chunk
+// holds its fragment id.
+class SyntheticChunkSource : public AbstractBufferMgr {
+ public:
+  SyntheticChunkSource(const size_t chunk_size)
+      : AbstractBufferMgr(0), chunk_size_(chunk_size), chunk_(chunk_size) {}
+
+  void fetchBuffer(const ChunkKey& key,
+                   AbstractBuffer* dest_buffer,
+                   const size_t num_bytes) override {
+    ++num_fetches;
+    dest_buffer->reserve(chunk_size_);
+    memset(dest_buffer->getMemoryPtr(), key[3], chunk_size_);
+    dest_buffer->setSize(chunk_size_);
+  }
+
+  AbstractBuffer* createBuffer(const ChunkKey& key,
+                               const size_t page_size,
+                               const size_t initial_size) override {
+    CHECK(false);
+    return nullptr;
+  }
+  void deleteBuffer(const ChunkKey& key, const bool purge) override {}
+  void deleteBuffersWithPrefix(const ChunkKey& key_prefix, const bool purge) override {}
+  AbstractBuffer* getBuffer(const ChunkKey& key, const size_t num_bytes) override {
+    return &chunk_;
+  }
+  AbstractBuffer* putBuffer(const ChunkKey& key,
+                            AbstractBuffer* src_buffer,
+                            const size_t num_bytes) override {
+    CHECK(false);
+    return nullptr;
+  }
+  void getChunkMetadataVec(
+      std::vector<std::pair<ChunkKey, ChunkMetadata>>& chunk_metadata) override {}
+  void getChunkMetadataVecForKeyPrefix(
+      std::vector<std::pair<ChunkKey, ChunkMetadata>>& chunk_metadata,
+      const ChunkKey& key_prefix) override {}
+  bool isBufferOnDevice(const ChunkKey& key) override { return true; }
+  std::string printSlabs() override { return ""; }
+  void clearSlabs() override {}
+  size_t getMaxSize() override { return 0; }
+  size_t getInUseSize() override { return 0; }
+  size_t getAllocated() override { return 0; }
+  bool isAllocationCapped() override { return false; }
+  void checkpoint() override {}
+  void checkpoint(const int db_id, const int tb_id) override {}
+  AbstractBuffer* alloc(const size_t num_bytes) override {
+    CHECK(false);
+    return nullptr;
+  }
+  void free(AbstractBuffer* buffer) override {}
+  MgrType getMgrType() override { return FILE_MGR; }
+  std::string getStringMgrType() override { return ToString(FILE_MGR); }
+  size_t getNumChunks() override { return 0; }
+
+  size_t num_fetches{0};
+
+ private:
+  const size_t chunk_size_;
+  SyntheticChunk chunk_;
+};
+
+void touch_chunk(Buffer_Namespace::BufferMgr& pool,
+                 const int table_id,
+                 const int fragment_id,
+                 const size_t chunk_size) {
+  pool.getBuffer({1, table_id, 1, fragment_id}, chunk_size)->unPin();
+}
+
+struct MixedWorkloadResult {
+  size_t working_set_misses;
+  int64_t elapsed_ms;
+};
+
+// Exercises the storage managers on their own, on files of the test's own under
+// BASE_PATH which are removed before and after it.
+class StorageMgr : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+    data_path_ =
+        boost::filesystem::path(BASE_PATH) / (std::string(test_info->name()) + "_test");
+    boost::filesystem::remove_all(data_path_);
+  }
+
+  void TearDown() override { boost::filesystem::remove_all(data_path_); }
+
+  // Opens the test's files, as a server starting up would.
+  std::unique_ptr<File_Namespace::GlobalFileMgr> openFileMgr() const {
+    return std::make_unique<File_Namespace::GlobalFileMgr>(0, data_path_.string());
+  }
+
+  MixedWorkloadResult runMixedWorkload(const bool scan_hint);
+
+  const size_t page_size_{512};
+  const size_t chunk_size_{64 * page_size_};
+  boost::filesystem::path data_path_;
+  SyntheticChunkSource source_{chunk_size_};
+};
+
+// A working set of half the pool, touched again after every step of large scans which
+// don't fit in the pool along with it. Every step is read twice, as by a self join, so
+// that the scanned chunks would be protected like the working set without the hint.
+MixedWorkloadResult StorageMgr::runMixedWorkload(const bool scan_hint) {
+  const size_t pool_chunks = 256;
+  const size_t working_set_chunks = pool_chunks / 2;
+  const size_t scan_step_chunks = pool_chunks * 3 / 4;
+  const size_t num_scans = 8;
+  const size_t scan_chunks = 16 * pool_chunks;
+
+  Buffer_Namespace::CpuBufferMgr pool(0,
+                                      pool_chunks * chunk_size_,
+                                      nullptr,
+                                      pool_chunks * chunk_size_ / 4,
+                                      page_size_,
+                                      &source_);
+  const auto touch_working_set = [&]() {
+    for (size_t i = 0; i < working_set_chunks; ++i) {
+      touch_chunk(pool, 1, i, chunk_size_);
+    }
+  };
+  touch_working_set();
+  touch_working_set();
+  MixedWorkloadResult result{0, 0};
+  result.elapsed_ms = measure<>::execution([&]() {
+    for (size_t scan = 0; scan < num_scans; ++scan) {
+      for (size_t start = 0; start < scan_chunks; start += scan_step_chunks) {
+        {
+          Buffer_Namespace::ScanHint hint(scan_hint);
+          for (int pass = 0; pass < 2; ++pass) {
+            for (size_t i = start; i < std::min(start + scan_step_chunks, scan_chunks);
+                 ++i) {
+              touch_chunk(pool, 2, i, chunk_size_);
+            }
+          }
+        }
+        const auto num_fetches = source_.num_fetches;
+        touch_working_set();
+        result.working_set_misses += source_.num_fetches - num_fetches;
+      }
+    }
+  });
+  return result;
+}
 }  // namespace
 
 #define SMALL 100000
@@ -292,6 +480,398 @@ TEST(StorageSmallParallel, AllTypes) {
   ASSERT_NO_THROW(run_ddl_statement("drop table alltypes;"););
 }
 
+TEST_F(StorageMgr, MixedWorkload) {
+  std::vector<size_t> working_set_misses;
+  for (const bool scan_hint : {false, true}) {
+    const auto result = runMixedWorkload(scan_hint);
+    LOG(INFO) << "Buffer pool mixed workload " << (scan_hint ? "with" : "without")
+              << " scan hint: " << result.working_set_misses
+              << " working set misses in " << result.elapsed_ms << " ms";
+    working_set_misses.push_back(result.working_set_misses);
+  }
+  // the chunks touched again by the scans push the working set out of the protected
+  // ones, unless they were loaded under the hint
+  EXPECT_GT(working_set_misses[0], size_t(0));
+  EXPECT_EQ(size_t(0), working_set_misses[1]);
+}
+
+TEST_F(StorageMgr, ServesBufferPoolMisses) {
+  const size_t pool_chunks = 16;
+  const int cache_chunks = 64;
+
+  File_Namespace::DiskCacheMgr cache(
+      0, data_path_.string(), cache_chunks * chunk_size_, &source_);
+  Buffer_Namespace::CpuBufferMgr pool(0,
+                                      pool_chunks * chunk_size_,
+                                      nullptr,
+                                      pool_chunks * chunk_size_,
+                                      page_size_,
+                                      &cache);
+  const auto read_chunks = [&](const int table_id, const int first, const int count) {
+    pool.clearSlabs();
+    for (int i = first; i < first + count; ++i) {
+      auto buffer = pool.getBuffer({1, table_id, 1, i}, chunk_size_);
+      EXPECT_EQ(static_cast<int8_t>(i), buffer->getMemoryPtr()[chunk_size_ - 1]);
+      buffer->unPin();
+    }
+  };
+
+  read_chunks(1, 0, cache_chunks);
+  EXPECT_EQ(size_t(cache_chunks), source_.num_fetches);
+  EXPECT_EQ(size_t(cache_chunks), cache.getNumChunks());
+  // no longer in the pool, read back from the cache
+  read_chunks(1, 0, cache_chunks);
+  EXPECT_EQ(size_t(cache_chunks), source_.num_fetches);
+  EXPECT_EQ(size_t(cache_chunks), cache.getNumHits());
+
+  // the least recently used chunks make room for new ones
+  read_chunks(2, 0, cache_chunks / 2);
+  EXPECT_EQ(size_t(cache_chunks + cache_chunks / 2), source_.num_fetches);
+  EXPECT_EQ(cache.getMaxSize(), cache.getInUseSize());
+  read_chunks(1, cache_chunks / 2, cache_chunks / 2);
+  EXPECT_EQ(size_t(cache_chunks + cache_chunks / 2), source_.num_fetches);
+
+  cache.invalidateChunksWithPrefix({1, 1});
+  read_chunks(1, cache_chunks / 2, cache_chunks / 2);
+  EXPECT_EQ(size_t(2 * cache_chunks), source_.num_fetches);
+}
+
+TEST_F(StorageMgr, WidensOnAppend) {
+  const ChunkKey key{1, 1, 1, 0};
+  std::vector<int64_t> values;
+  const auto append_values = [&values](AbstractBuffer* buffer,
+                                       std::vector<int64_t> new_values) {
+    buffer->append(reinterpret_cast<int8_t*>(new_values.data()),
+                   new_values.size() * sizeof(int64_t));
+    values.insert(values.end(), new_values.begin(), new_values.end());
+  };
+  const auto read_values = [](AbstractBuffer* buffer) {
+    std::vector<int64_t> buffer_values(buffer->size() / sizeof(int64_t));
+    buffer->read(reinterpret_cast<int8_t*>(buffer_values.data()), buffer->size());
+    return buffer_values;
+  };
+  const auto stored_elem_size = [](AbstractBuffer* buffer) {
+    const auto file_buffer = dynamic_cast<File_Namespace::FileBuffer*>(buffer);
+    CHECK(file_buffer);
+    return file_buffer->storedElemSize();
+  };
+
+  {
+    auto gfm = openFileMgr();
+    gfm->setNarrowChunks(true);
+    auto buffer = gfm->createBuffer(key, 4096);
+    buffer->initEncoder(SQLTypeInfo(kBIGINT, false));
+    std::vector<int64_t> first_values;
+    for (int64_t i = 0; i < 100000; ++i) {
+      first_values.push_back(i % 200 - 100);
+    }
+    first_values.push_back(NULL_BIGINT);
+    append_values(buffer, first_values);
+    EXPECT_EQ(size_t(1), stored_elem_size(buffer));
+    EXPECT_EQ(values.size() * sizeof(int64_t), buffer->size());
+    EXPECT_EQ(values, read_values(buffer));
+    // too wide for a byte
+    append_values(buffer, {1000, -1000, NULL_BIGINT});
+    EXPECT_EQ(size_t(2), stored_elem_size(buffer));
+    EXPECT_EQ(values, read_values(buffer));
+    gfm->checkpoint();
+  }
+  {
+    auto gfm = openFileMgr();
+    auto buffer = gfm->getBuffer(key);
+    EXPECT_EQ(size_t(2), stored_elem_size(buffer));
+    EXPECT_EQ(values, read_values(buffer));
+    int64_t value{0};
+    buffer->read(
+        reinterpret_cast<int8_t*>(&value), sizeof(int64_t), 1000 * sizeof(int64_t));
+    EXPECT_EQ(values[1000], value);
+    append_values(buffer, {int64_t(1) << 40});
+    EXPECT_EQ(size_t(0), stored_elem_size(buffer));
+    EXPECT_EQ(values, read_values(buffer));
+    gfm->checkpoint();
+  }
+  EXPECT_EQ(values, read_values(openFileMgr()->getBuffer(key)));
+}
+
+TEST_F(StorageMgr, FrameOfReference) {
+  const ChunkKey key{1, 1, 1, 0};
+  auto gfm = openFileMgr();
+  gfm->setNarrowChunks(true);
+  auto buffer = gfm->createBuffer(key, 4096);
+  buffer->initEncoder(SQLTypeInfo(kTIMESTAMP, false));
+  // a day of epoch milliseconds doesn't fit 32 bits, but its offsets do
+  const int64_t day_start = 1546300800000;
+  std::vector<int64_t> values;
+  for (int64_t i = 0; i < 86400; ++i) {
+    values.push_back(i % 1000 ? day_start + i * 1000 : NULL_BIGINT);
+  }
+  buffer->append(reinterpret_cast<int8_t*>(values.data()),
+                 values.size() * sizeof(int64_t));
+  const auto file_buffer = dynamic_cast<File_Namespace::FileBuffer*>(buffer);
+  CHECK(file_buffer);
+  EXPECT_EQ(size_t(4), file_buffer->storedElemSize());
+  std::vector<int64_t> buffer_values(values.size());
+  buffer->read(reinterpret_cast<int8_t*>(buffer_values.data()), buffer->size());
+  EXPECT_EQ(values, buffer_values);
+}
+
+TEST_F(StorageMgr, NarrowsCheckpointedChunks) {
+  const size_t pool_size = 512 * page_size_;
+  const ChunkKey key{1, 1, 1, 0};
+  std::vector<int64_t> values;
+  for (int64_t i = 0; i < 20000; ++i) {
+    values.push_back(i % 100);
+  }
+  auto gfm = openFileMgr();
+  gfm->setNarrowChunks(true);
+  Buffer_Namespace::CpuBufferMgr pool(
+      0, pool_size, nullptr, pool_size, page_size_, gfm.get());
+  // the chunk reaches the file manager through putBuffer, which has to know its type
+  // before the data to narrow it
+  auto buffer = pool.createBuffer(key, page_size_);
+  buffer->initEncoder(SQLTypeInfo(kBIGINT, false));
+  buffer->append(reinterpret_cast<int8_t*>(values.data()),
+                 values.size() * sizeof(int64_t));
+  buffer->unPin();
+  pool.checkpoint();
+  auto file_buffer = dynamic_cast<File_Namespace::FileBuffer*>(gfm->getBuffer(key));
+  CHECK(file_buffer);
+  EXPECT_EQ(size_t(1), file_buffer->storedElemSize());
+  // reserving the logical size takes no pages beyond the narrowed ones
+  const auto page_count = file_buffer->pageCount();
+  file_buffer->reserve(file_buffer->size());
+  EXPECT_EQ(page_count, file_buffer->pageCount());
+  std::vector<int64_t> buffer_values(values.size());
+  file_buffer->read(reinterpret_cast<int8_t*>(buffer_values.data()),
+                    file_buffer->size());
+  EXPECT_EQ(values, buffer_values);
+}
+
+TEST_F(StorageMgr, AdoptsUnchangedChunks) {
+  const size_t pool_size = 512 * page_size_;
+  const auto slab_path = data_path_ / "cpu_buffers";
+  const ChunkKey kept_key{1, 1, 1, 0};
+  const ChunkKey changed_key{1, 1, 2, 0};
+  std::vector<int32_t> values(20000);
+  std::iota(values.begin(), values.end(), 0);
+
+  const auto make_pool = [&](File_Namespace::GlobalFileMgr* gfm) {
+    auto pool = std::make_unique<Buffer_Namespace::CpuBufferMgr>(
+        0, pool_size, nullptr, pool_size, page_size_, gfm, slab_path.string());
+    pool->adoptSlabs(gfm);
+    return pool;
+  };
+  {
+    auto gfm = openFileMgr();
+    for (const auto& key : {kept_key, changed_key}) {
+      auto chunk = gfm->createBuffer(key, 4096);
+      chunk->initEncoder(SQLTypeInfo(kINT, false));
+      chunk->append(reinterpret_cast<int8_t*>(values.data()),
+                    values.size() * sizeof(int32_t));
+    }
+    gfm->checkpoint();
+    auto pool = make_pool(gfm.get());
+    EXPECT_EQ(size_t(0), pool->getNumAdoptedChunks());
+    for (const auto& key : {kept_key, changed_key}) {
+      pool->getBuffer(key)->unPin();
+    }
+    pool->saveSlabIndex(gfm.get());
+  }
+  {
+    auto gfm = openFileMgr();
+    // changed while the server was down
+    int32_t value{-1};
+    gfm->getBuffer(changed_key)->append(reinterpret_cast<int8_t*>(&value), sizeof(value));
+    gfm->checkpoint();
+    auto pool = make_pool(gfm.get());
+    EXPECT_EQ(size_t(1), pool->getNumAdoptedChunks());
+    EXPECT_TRUE(pool->isBufferOnDevice(kept_key));
+    EXPECT_FALSE(pool->isBufferOnDevice(changed_key));
+    auto buffer = pool->getBuffer(kept_key);
+    ASSERT_EQ(values.size() * sizeof(int32_t), buffer->size());
+    EXPECT_EQ(0, std::memcmp(buffer->getMemoryPtr(), values.data(), buffer->size()));
+    EXPECT_TRUE(buffer->hasEncoder);
+    buffer->unPin();
+    // not saved this time
+  }
+  {
+    auto gfm = openFileMgr();
+    EXPECT_EQ(size_t(0), make_pool(gfm.get())->getNumAdoptedChunks());
+  }
+}
+
+TEST_F(StorageMgr, ReloadsMostUsedChunks) {
+  const auto history_path = (data_path_ / "access_history").string();
+  const std::vector<ChunkKey> keys{{1, 1, 1, 0}, {1, 1, 2, 0}, {1, 1, 3, 0}};
+  std::vector<int8_t> values(chunk_size_);
+
+  const auto make_pool = [&](File_Namespace::GlobalFileMgr* gfm,
+                             const size_t num_chunks) {
+    return std::make_unique<Buffer_Namespace::CpuBufferMgr>(
+        0, num_chunks * chunk_size_, nullptr, num_chunks * chunk_size_, page_size_, gfm);
+  };
+  {
+    auto gfm = openFileMgr();
+    for (const auto& key : keys) {
+      std::fill(values.begin(), values.end(), static_cast<int8_t>(key[2]));
+      gfm->createBuffer(key, 4096)->append(values.data(), values.size());
+    }
+    gfm->checkpoint();
+    auto pool = make_pool(gfm.get(), keys.size());
+    Buffer_Namespace::BufferPoolPrewarmer prewarmer(
+        pool.get(), gfm.get(), history_path, 0);
+    // the third chunk is used most, then the first, the second not at all
+    for (const auto i : {2, 0, 2}) {
+      pool->getBuffer(keys[i])->unPin();
+    }
+  }
+  {
+    auto gfm = openFileMgr();
+    // room for two chunks, the prewarm doesn't evict
+    auto pool = make_pool(gfm.get(), 2);
+    Buffer_Namespace::BufferPoolPrewarmer prewarmer(
+        pool.get(), gfm.get(), history_path, 0);
+    prewarmer.prewarmFromHistory();
+    prewarmer.waitForPrewarm();
+    EXPECT_EQ(size_t(2), prewarmer.getNumPrewarmedChunks());
+    EXPECT_TRUE(pool->isBufferOnDevice(keys[2]));
+    EXPECT_TRUE(pool->isBufferOnDevice(keys[0]));
+    EXPECT_FALSE(pool->isBufferOnDevice(keys[1]));
+    auto buffer = pool->getBuffer(keys[2]);
+    EXPECT_EQ(chunk_size_, buffer->size());
+    EXPECT_EQ(int8_t(3), buffer->getMemoryPtr()[chunk_size_ - 1]);
+    buffer->unPin();
+    // loading a chunk on request evicts if need be
+    EXPECT_EQ(size_t(1), prewarmer.prewarmChunks({keys[1]}));
+    EXPECT_TRUE(pool->isBufferOnDevice(keys[1]));
+    // the prewarm doesn't count as use
+    const auto counts = pool->getChunkAccessCounts();
+    ASSERT_EQ(size_t(2), counts.size());
+    EXPECT_EQ(keys[2], counts[0].first);
+    EXPECT_EQ(size_t(3), counts[0].second);
+    EXPECT_EQ(keys[0], counts[1].first);
+    EXPECT_EQ(size_t(1), counts[1].second);
+  }
+}
+
+TEST_F(StorageMgr, ServesExtentsWithoutCopying) {
+  const ChunkKey key{1, 1, 1, 0};
+  const ChunkKey other_key{1, 2, 1, 0};  // of a table without extents
+  std::vector<int8_t> values(chunk_size_, 7);
+  std::string extent_path;
+  {
+    auto gfm = openFileMgr();
+    gfm->setMmapChunks(1, 1, true);
+    auto chunk = gfm->createBuffer(key, 4096);
+    chunk->initEncoder(SQLTypeInfo(kTINYINT, false));
+    chunk->append(values.data(), values.size());
+    gfm->createBuffer(other_key, 4096)->append(values.data(), values.size());
+    // extents are written at the checkpoints
+    EXPECT_TRUE(gfm->getChunkExtentPath(key).empty());
+    gfm->checkpoint();
+    extent_path = gfm->getChunkExtentPath(key);
+    ASSERT_FALSE(extent_path.empty());
+    EXPECT_EQ(chunk_size_, boost::filesystem::file_size(extent_path));
+    EXPECT_TRUE(gfm->getChunkExtentPath(other_key).empty());
+
+    Buffer_Namespace::CpuBufferMgr pool(
+        0, 4 * chunk_size_, nullptr, 4 * chunk_size_, page_size_, gfm.get());
+    pool.setExtentStore(gfm.get());
+    auto buffer = pool.getBuffer(key);
+    EXPECT_EQ(chunk_size_, buffer->size());
+    EXPECT_EQ(int8_t(7), buffer->getMemoryPtr()[chunk_size_ - 1]);
+    EXPECT_TRUE(buffer->hasEncoder);
+    buffer->unPin();
+    EXPECT_EQ(size_t(0), pool.getInUseSize());
+    EXPECT_EQ(chunk_size_, pool.getMappedSize());
+    pool.getBuffer(other_key)->unPin();
+    EXPECT_EQ(chunk_size_, pool.getInUseSize());
+
+    // once changed, the chunk goes through the pool until the next checkpoint
+    chunk->append(values.data(), page_size_);
+    EXPECT_TRUE(gfm->getChunkExtentPath(key).empty());
+    buffer = pool.getBuffer(key);
+    EXPECT_EQ(chunk_size_ + page_size_, buffer->size());
+    EXPECT_EQ(size_t(0), pool.getNumMappedChunks());
+    buffer->unPin();
+    pool.deleteBuffer(key);
+    gfm->checkpoint();
+    EXPECT_FALSE(boost::filesystem::exists(extent_path));
+    extent_path = gfm->getChunkExtentPath(key);
+    ASSERT_FALSE(extent_path.empty());
+    buffer = pool.getBuffer(key);
+    EXPECT_EQ(chunk_size_ + page_size_, buffer->size());
+    EXPECT_EQ(chunk_size_ + page_size_, pool.getMappedSize());
+    buffer->unPin();
+  }
+  {
+    // the extents outlive the server
+    auto gfm = openFileMgr();
+    gfm->setMmapChunks(1, 1, true);
+    EXPECT_EQ(extent_path, gfm->getChunkExtentPath(key));
+  }
+}
+
+TEST_F(StorageMgr, KeepsChunksContiguous) {
+  const size_t page_size = 4096;
+  const size_t num_appends = 8;
+  const ChunkKey key{1, 1, 1, 0};
+  const ChunkKey other_key{1, 1, 2, 0};
+  const ChunkKey growing_key{1, 2, 1, 0};
+  const ChunkKey other_growing_key{1, 2, 2, 0};
+  size_t page_data_size{0};
+  {
+    auto gfm = openFileMgr();
+    // appends to two chunks in turn, a page each
+    auto append_in_turns = [&](const ChunkKey& first_key, const ChunkKey& second_key) {
+      auto chunk = gfm->createBuffer(first_key, page_size);
+      auto other_chunk = gfm->createBuffer(second_key, page_size);
+      page_data_size = dynamic_cast<File_Namespace::FileBuffer*>(chunk)->pageDataSize();
+      for (size_t i = 0; i < num_appends; ++i) {
+        std::vector<int8_t> values(page_data_size, i);
+        chunk->append(values.data(), values.size());
+        other_chunk->append(values.data(), values.size());
+      }
+      gfm->checkpoint();
+    };
+
+    append_in_turns(key, other_key);
+    auto stats = gfm->getChunkLayoutStats(1, 1);
+    EXPECT_EQ(size_t(2), stats.numChunks);
+    EXPECT_EQ(2 * num_appends, stats.numPages);
+    EXPECT_EQ(2 * num_appends, stats.numPageRuns);
+    EXPECT_EQ(size_t(2), stats.numScatteredChunks);
+
+    EXPECT_EQ(size_t(2), gfm->compactChunks(1, 1));
+    EXPECT_EQ(size_t(0), gfm->compactChunks(1, 1));
+    gfm->checkpoint();
+    stats = gfm->getChunkLayoutStats(1, 1);
+    EXPECT_EQ(2 * num_appends, stats.numPages);
+    EXPECT_EQ(size_t(2), stats.numPageRuns);
+    EXPECT_EQ(size_t(0), stats.numScatteredChunks);
+
+    // with pages set aside to grow into, the chunks stay contiguous all along
+    gfm->setChunkGrowthPages(num_appends);
+    append_in_turns(growing_key, other_growing_key);
+    stats = gfm->getChunkLayoutStats(1, 2);
+    EXPECT_EQ(2 * num_appends, stats.numPages);
+    EXPECT_EQ(size_t(2), stats.numPageRuns);
+  }
+  {
+    // the moved pages are the ones found on restart
+    auto gfm = openFileMgr();
+    const auto stats = gfm->getChunkLayoutStats(1, 1);
+    EXPECT_EQ(2 * num_appends, stats.numPages);
+    EXPECT_EQ(size_t(2), stats.numPageRuns);
+    std::vector<int8_t> values(num_appends * page_data_size);
+    gfm->getBuffer(other_key)->read(values.data(), values.size());
+    for (size_t i = 0; i < num_appends; ++i) {
+      EXPECT_EQ(int8_t(i), values[i * page_data_size]);
+      EXPECT_EQ(int8_t(i), values[(i + 1) * page_data_size - 1]);
+    }
+  }
+}
+
 int main(int argc, char* argv[]) {
   google::InitGoogleLogging(argv[0]);
   ::testing::InitGoogleTest(&argc, argv);
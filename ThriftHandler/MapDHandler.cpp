@@ -45,6 +45,7 @@
 #include "QueryEngine/RelAlgExecutor.h"
 
 #include "Catalog/Catalog.h"
+#include "DataMgr/FileMgr/FileMgr.h"
 #include "Fragmenter/InsertOrderFragmenter.h"
 #include "Import/Importer.h"
 #include "MapDDistributedHandler.h"
@@ -57,6 +58,7 @@
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "QueryEngine/GpuMemUtils.h"
+#include "QueryEngine/GroupByBufferPool.h"
 #include "QueryEngine/JoinFilterPushDown.h"
 #include "QueryEngine/JsonAccessors.h"
 #include "QueryEngine/TableOptimizer.h"
@@ -230,6 +232,7 @@ MapDHandler::MapDHandler(const std::vector<LeafHostInfo>& db_leaves,
                               access_priv_check,
                               !db_leaves.empty(),
                               string_leaves_);
+  SysCatalog::instance().loadAllCatalogs();
   import_path_ = boost::filesystem::path(base_data_path_) / "mapd_import";
   start_time_ = std::time(nullptr);
 
@@ -1596,6 +1599,35 @@ void MapDHandler::get_table_details(TTableDetails& _return,
   get_table_details_impl(_return, session, table_name, false, false);
 }
 
+void MapDHandler::get_tables_details(std::map<std::string, TTableDetails>& _return,
+                                     const TSessionId& session,
+                                     const std::vector<std::string>& table_names) {
+  const auto session_info = get_session(session);
+  auto& cat = session_info.getCatalog();
+  std::list<const TableDescriptor*> tables;
+  if (table_names.empty()) {
+    tables = cat.getAllTableMetadata();
+  } else {
+    for (const auto& table_name : table_names) {
+      const auto td = cat.getMetadataForTable(table_name, false);
+      if (td) {
+        tables.push_back(td);
+      }
+    }
+  }
+  for (const auto td : tables) {
+    if (td->shard >= 0) {
+      // skip shards, they're not standalone tables
+      continue;
+    }
+    if (SysCatalog::instance().arePrivilegesOn() &&
+        !hasTableAccessPrivileges(td, session_info)) {
+      continue;
+    }
+    get_cached_table_details(_return[td->tableName], session_info, td);
+  }
+}
+
 void MapDHandler::get_table_details_impl(TTableDetails& _return,
                                          const TSessionId& session,
                                          const std::string& table_name,
@@ -1609,48 +1641,91 @@ void MapDHandler::get_table_details_impl(TTableDetails& _return,
   if (!td) {
     THROW_MAPD_EXCEPTION("Table " + table_name + " doesn't exist");
   }
+  if (SysCatalog::instance().arePrivilegesOn() &&
+      !hasTableAccessPrivileges(td, session_info)) {
+    THROW_MAPD_EXCEPTION("User has no access privileges to table " + table_name);
+  }
+  if (!get_system && !get_physical) {
+    get_cached_table_details(_return, session_info, td);
+  } else {
+    build_table_details(_return, session_info, td, get_system, get_physical);
+  }
+}
+
+void MapDHandler::get_cached_table_details(
+    TTableDetails& _return,
+    const Catalog_Namespace::SessionInfo& session_info,
+    const TableDescriptor* td) {
+  const auto& cat = session_info.getCatalog();
+  const auto db_id = cat.getCurrentDB().dbId;
+  // read before building, so details built from older descriptors are never cached
+  // under a newer version
+  const auto catalog_version = cat.getDescriptorMapsVersion();
+  {
+    std::lock_guard<std::mutex> lock(table_details_cache_mutex_);
+    const auto& cache = table_details_cache_[db_id];
+    if (cache.catalog_version == catalog_version) {
+      const auto it = cache.details_by_table_id.find(td->tableId);
+      if (it != cache.details_by_table_id.end()) {
+        _return = it->second;
+        return;
+      }
+    }
+  }
+  if (!build_table_details(_return, session_info, td, false, false)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(table_details_cache_mutex_);
+  auto& cache = table_details_cache_[db_id];
+  if (cache.catalog_version < catalog_version) {
+    cache.details_by_table_id.clear();
+    cache.catalog_version = catalog_version;
+  }
+  if (cache.catalog_version == catalog_version) {
+    cache.details_by_table_id.emplace(td->tableId, _return);
+  }
+}
+
+bool MapDHandler::build_table_details(TTableDetails& _return,
+                                      Catalog_Namespace::SessionInfo session_info,
+                                      const TableDescriptor* td,
+                                      const bool get_system,
+                                      const bool get_physical) {
+  auto& cat = session_info.getCatalog();
+  bool cacheable = true;
   if (td->isView) {
     try {
-      if (!SysCatalog::instance().arePrivilegesOn() ||
-          hasTableAccessPrivileges(td, session)) {
-        session_info.make_superuser();
-        const auto query_ra = parse_to_ra(td->viewSQL, {}, session_info);
-        TQueryResult result;
-        execute_rel_alg(result,
-                        query_ra,
-                        true,
-                        session_info,
-                        ExecutorDeviceType::CPU,
-                        -1,
-                        -1,
-                        false,
-                        true,
-                        false,
-                        false);
-        _return.row_desc = fixup_row_descriptor(result.row_set.row_desc, cat);
-      } else {
-        THROW_MAPD_EXCEPTION("User has no access privileges to table " + table_name);
-      }
+      session_info.make_superuser();
+      const auto query_ra = parse_to_ra(td->viewSQL, {}, session_info);
+      TQueryResult result;
+      execute_rel_alg(result,
+                      query_ra,
+                      true,
+                      session_info,
+                      ExecutorDeviceType::CPU,
+                      -1,
+                      -1,
+                      false,
+                      true,
+                      false,
+                      false);
+      _return.row_desc = fixup_row_descriptor(result.row_set.row_desc, cat);
     } catch (std::exception& e) {
       TColumnType tColumnType;
       tColumnType.col_name = "BROKEN_VIEW_PLEASE_FIX";
       _return.row_desc.push_back(tColumnType);
+      cacheable = false;
     }
   } else {
     try {
-      if (!SysCatalog::instance().arePrivilegesOn() ||
-          hasTableAccessPrivileges(td, session)) {
-        const auto col_descriptors =
-            cat.getAllColumnMetadataForTable(td->tableId, get_system, true, get_physical);
-        const auto deleted_cd = cat.getDeletedColumn(td);
-        for (const auto cd : col_descriptors) {
-          if (cd == deleted_cd) {
-            continue;
-          }
-          _return.row_desc.push_back(populateThriftColumnType(&cat, cd));
+      const auto col_descriptors =
+          cat.getAllColumnMetadataForTable(td->tableId, get_system, true, get_physical);
+      const auto deleted_cd = cat.getDeletedColumn(td);
+      for (const auto cd : col_descriptors) {
+        if (cd == deleted_cd) {
+          continue;
         }
-      } else {
-        THROW_MAPD_EXCEPTION("User has no access privileges to table " + table_name);
+        _return.row_desc.push_back(populateThriftColumnType(&cat, cd));
       }
     } catch (const std::runtime_error& e) {
       THROW_MAPD_EXCEPTION(e.what());
@@ -1670,6 +1745,7 @@ void MapDHandler::get_table_details_impl(TTableDetails& _return,
                  ? TPartitionDetail::REPLICATED
                  : (td->partitions == "SHARDED" ? TPartitionDetail::SHARDED
                                                 : TPartitionDetail::OTHER));
+  return cacheable;
 }
 
 // DEPRECATED(2017-04-17) - use get_table_details()
@@ -1713,7 +1789,12 @@ void MapDHandler::get_link_view(TFrontendView& _return,
 
 bool MapDHandler::hasTableAccessPrivileges(const TableDescriptor* td,
                                            const TSessionId& session) {
-  const auto session_info = get_session(session);
+  return hasTableAccessPrivileges(td, get_session(session));
+}
+
+bool MapDHandler::hasTableAccessPrivileges(
+    const TableDescriptor* td,
+    const Catalog_Namespace::SessionInfo& session_info) {
   auto& cat = session_info.getCatalog();
   auto user_metadata = session_info.get_currentUser();
 
@@ -1754,7 +1835,7 @@ void MapDHandler::get_tables_impl(std::vector<std::string>& table_names,
       default: { break; }
     }
     if (SysCatalog::instance().arePrivilegesOn() &&
-        !hasTableAccessPrivileges(td, session)) {
+        !hasTableAccessPrivileges(td, session_info)) {
       // skip table, as there are no privileges to access it
       continue;
     }
@@ -1790,7 +1871,7 @@ void MapDHandler::get_tables_meta(std::vector<TTableMeta>& _return,
       continue;
     }
     if (SysCatalog::instance().arePrivilegesOn() &&
-        !hasTableAccessPrivileges(td, session)) {
+        !hasTableAccessPrivileges(td, session_info)) {
       // skip table, as there are no privileges to access it
       continue;
     }
@@ -1833,7 +1914,7 @@ void MapDHandler::get_tables_meta(std::vector<TTableMeta>& _return,
     } else {
       try {
         if (!SysCatalog::instance().arePrivilegesOn() ||
-            hasTableAccessPrivileges(td, session)) {
+            hasTableAccessPrivileges(td, session_info)) {
           const auto col_descriptors =
               cat.getAllColumnMetadataForTable(td->tableId, false, true, false);
           const auto deleted_cd = cat.getDeletedColumn(td);
@@ -1901,6 +1982,10 @@ void MapDHandler::clear_gpu_memory(const TSessionId& session) {
 void MapDHandler::clear_cpu_memory(const TSessionId& session) {
   const auto session_info = get_session(session);
   SysCatalog::instance().getDataMgr().clearMemory(MemoryLevel::CPU_LEVEL);
+  GroupByBufferPool::instance().clear();
+  if (mapd_parameters_.cpu_buffer_prewarm) {
+    SysCatalog::instance().getDataMgr().prewarmCpuBufferPool();
+  }
   if (render_handler_) {
     render_handler_->clear_cpu_memory();
   }
@@ -1910,6 +1995,77 @@ void MapDHandler::clear_cpu_memory(const TSessionId& session) {
   }
 }
 
+void MapDHandler::prewarm_table(const TSessionId& session,
+                                const std::string& table_name,
+                                const std::vector<std::string>& column_names) {
+  const auto session_info = get_session(session);
+  auto& cat = session_info.getCatalog();
+  const auto td = cat.getMetadataForTable(table_name, false);
+  if (!td) {
+    THROW_MAPD_EXCEPTION("Table " + table_name + " doesn't exist");
+  }
+  if (SysCatalog::instance().arePrivilegesOn() &&
+      !hasTableAccessPrivileges(td, session_info)) {
+    THROW_MAPD_EXCEPTION("User has no access privileges to table " + table_name);
+  }
+  std::vector<int> column_ids;
+  if (column_names.empty()) {
+    const auto cds = cat.getAllColumnMetadataForTable(td->tableId, false, false, true);
+    for (const auto cd : cds) {
+      column_ids.push_back(cd->columnId);
+    }
+  } else {
+    for (const auto& column_name : column_names) {
+      const auto cd = cat.getMetadataForColumn(td->tableId, column_name);
+      if (!cd) {
+        THROW_MAPD_EXCEPTION("Column " + column_name + " doesn't exist in table " +
+                             table_name);
+      }
+      column_ids.push_back(cd->columnId);
+    }
+  }
+  std::vector<ChunkKey> key_prefixes;
+  for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+    for (const auto column_id : column_ids) {
+      key_prefixes.push_back({cat.getCurrentDB().dbId, physical_td->tableId, column_id});
+    }
+  }
+  const auto num_chunks =
+      SysCatalog::instance().getDataMgr().prewarmChunksWithPrefix(key_prefixes);
+  LOG(INFO) << "Prewarmed " << num_chunks << " chunks of table " << table_name;
+}
+
+void MapDHandler::get_table_chunk_layout(TTableChunkLayout& _return,
+                                         const TSessionId& session,
+                                         const std::string& table_name) {
+  const auto session_info = get_session(session);
+  auto& cat = session_info.getCatalog();
+  const auto td = cat.getMetadataForTable(table_name, false);
+  if (!td) {
+    THROW_MAPD_EXCEPTION("Table " + table_name + " doesn't exist");
+  }
+  if (SysCatalog::instance().arePrivilegesOn() &&
+      !hasTableAccessPrivileges(td, session_info)) {
+    THROW_MAPD_EXCEPTION("User has no access privileges to table " + table_name);
+  }
+  if (td->isView || td->persistenceLevel != Data_Namespace::MemoryLevel::DISK_LEVEL) {
+    THROW_MAPD_EXCEPTION("Table " + table_name + " has no chunks on disk");
+  }
+  _return.num_chunks = 0;
+  _return.num_pages = 0;
+  _return.num_page_runs = 0;
+  _return.num_scattered_chunks = 0;
+  auto& data_mgr = SysCatalog::instance().getDataMgr();
+  for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+    const auto stats =
+        data_mgr.getTableChunkLayoutStats(cat.getCurrentDB().dbId, physical_td->tableId);
+    _return.num_chunks += stats.numChunks;
+    _return.num_pages += stats.numPages;
+    _return.num_page_runs += stats.numPageRuns;
+    _return.num_scattered_chunks += stats.numScatteredChunks;
+  }
+}
+
 TSessionId MapDHandler::getInvalidSessionId() const {
   return INVALID_SESSION_ID;
 }
@@ -4504,6 +4660,9 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
           optimizer.vacuumDeletedRows();
         }
         optimizer.recomputeMetadata();
+        if (optimize_stmt->shouldCompactChunks()) {
+          optimizer.compactChunks();
+        }
       });
 
       return;
@@ -5127,3 +5286,9 @@ void MapDHandler::shutdown() {
     render_handler_->shutdown();
   }
 }
+
+void MapDHandler::save_cpu_buffer_pool() {
+  if (data_mgr_) {
+    data_mgr_->saveCpuBufferPool();
+  }
+}
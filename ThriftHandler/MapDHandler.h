@@ -156,6 +156,11 @@ class MapDHandler : public MapDIf {
   void get_internal_table_details(TTableDetails& _return,
                                   const TSessionId& session,
                                   const std::string& table_name);
+  // Details of the given tables, or of all accessible tables if none are given, in a
+  // single call. Tables which don't exist or aren't accessible are left out.
+  void get_tables_details(std::map<std::string, TTableDetails>& _return,
+                          const TSessionId& session,
+                          const std::vector<std::string>& table_names);
   void get_users(std::vector<std::string>& _return, const TSessionId& session);
   void get_databases(std::vector<TDBInfo>& _return, const TSessionId& session);
 
@@ -168,6 +173,12 @@ class MapDHandler : public MapDIf {
                   const std::string& memory_level);
   void clear_cpu_memory(const TSessionId& session);
   void clear_gpu_memory(const TSessionId& session);
+  void prewarm_table(const TSessionId& session,
+                     const std::string& table_name,
+                     const std::vector<std::string>& column_names);
+  void get_table_chunk_layout(TTableChunkLayout& _return,
+                              const TSessionId& session,
+                              const std::string& table_name);
   void set_table_epoch(const TSessionId& session,
                        const int db_id,
                        const int table_id,
@@ -395,6 +406,8 @@ class MapDHandler : public MapDIf {
   void shutdown();
   // end of sync block for HAHandler and mapd.thrift
 
+  void save_cpu_buffer_pool();
+
   TSessionId getInvalidSessionId() const;
 
   void internal_connect(TSessionId& session,
@@ -446,6 +459,17 @@ class MapDHandler : public MapDIf {
                               const std::string& table_name,
                               const bool get_system,
                               const bool get_physical);
+  // Returns false if the details shouldn't be cached, i.e. for a broken view.
+  bool build_table_details(TTableDetails& _return,
+                           Catalog_Namespace::SessionInfo session_info,
+                           const TableDescriptor* td,
+                           const bool get_system,
+                           const bool get_physical);
+  void get_cached_table_details(TTableDetails& _return,
+                                const Catalog_Namespace::SessionInfo& session_info,
+                                const TableDescriptor* td);
+  bool hasTableAccessPrivileges(const TableDescriptor* td,
+                                const Catalog_Namespace::SessionInfo& session_info);
   void check_read_only(const std::string& str);
   void check_session_exp(const SessionMap::iterator& session_it);
   SessionMap::iterator get_session_it(const TSessionId& session);
@@ -622,6 +646,15 @@ class MapDHandler : public MapDIf {
   Importer_NS::CopyParams _geo_copy_from_copy_params;
   std::string _geo_copy_from_partitions;
 
+  // Table details as returned to clients, per database id. A database's entries are
+  // dropped as a whole whenever its catalog publishes new descriptors, i.e. on DDL.
+  struct TableDetailsCache {
+    uint64_t catalog_version{0};
+    std::unordered_map<int, TTableDetails> details_by_table_id;
+  };
+  std::unordered_map<int, TableDetailsCache> table_details_cache_;
+  std::mutex table_details_cache_mutex_;
+
   // Only for IPC device memory deallocation
   mutable std::mutex handle_to_dev_ptr_mutex_;
   mutable std::unordered_map<std::string, int8_t*> ipc_handle_to_dev_ptr_;
@@ -226,18 +226,6 @@ DEVICE void ChunkIter_get_nth(ChunkIter* it, int n, ArrayDatum* result, bool* is
   }
   *is_end = false;
 
-  if (it->skip_size > 0) {
-    // for fixed-size
-    int8_t* current_pos = it->start_pos + n * it->skip_size;
-    result->length = static_cast<size_t>(it->skip_size);
-    result->pointer = current_pos;
-    result->is_null = it->type_info.is_null(result->pointer);
-  } else {
-    int8_t* current_pos = it->start_pos + n * sizeof(StringOffsetT);
-    StringOffsetT offset = *(StringOffsetT*)current_pos;
-    result->length = static_cast<size_t>(*((StringOffsetT*)current_pos + 1) - offset);
-    result->pointer = it->second_buf + offset;
-    // @TODO(wei) treat zero length as null for now
-    result->is_null = (result->length == 0);
-  }
+  result->pointer = ChunkIter_get_nth_varlen(it, n, &result->length);
+  result->is_null = ChunkIter_is_null_varlen(it, result->pointer, result->length);
 }
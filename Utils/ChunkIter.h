@@ -51,4 +51,28 @@ DEVICE void ChunkIter_get_nth(ChunkIter* it,
                               bool* is_end);
 DEVICE void ChunkIter_get_nth(ChunkIter* it, int nth, ArrayDatum* vd, bool* is_end);
 
+// @brief get nth element in a varlen or fixed-length array Chunk straight from the
+// offset and data buffers. Unlike ChunkIter_get_nth, nth isn't bounds-checked and no
+// Datum is built, so that it inlines into the per-row runtime functions.
+DEVICE FORCE_INLINE int8_t* ChunkIter_get_nth_varlen(const ChunkIter* it,
+                                                     const int64_t nth,
+                                                     size_t* length) {
+  if (it->skip_size > 0) {
+    // fixed-length array
+    *length = static_cast<size_t>(it->skip_size);
+    return it->start_pos + nth * it->skip_size;
+  }
+  const StringOffsetT* offsets = reinterpret_cast<const StringOffsetT*>(it->start_pos);
+  *length = static_cast<size_t>(offsets[nth + 1] - offsets[nth]);
+  return it->second_buf + offsets[nth];
+}
+
+// @brief whether the element returned by ChunkIter_get_nth_varlen is null
+DEVICE FORCE_INLINE bool ChunkIter_is_null_varlen(const ChunkIter* it,
+                                                  const int8_t* pointer,
+                                                  const size_t length) {
+  // @TODO(wei) treat zero length as null for now
+  return it->skip_size > 0 ? it->type_info.is_null(pointer) : length == 0;
+}
+
 #endif  // _CHUNK_ITER_H_
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.mapd.calcite.parser;
+
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * Encodes the JSON tree built by MapDRelJsonWriter in the binary plan format read by
+ * QueryEngine/RelAlgBinaryPlan.h, skipping the JSON text round trip on the server.
+ *
+ * Numbers are classified from their JSON text, exactly as the server's JSON parser
+ * would, so both formats describe the same plan.
+ */
+public class MapDBinarySerializer {
+  private static final byte[] MAGIC = {'R', 'A', 'B', '1'};
+
+  private static final byte TAG_NULL = 0;
+  private static final byte TAG_FALSE = 1;
+  private static final byte TAG_TRUE = 2;
+  private static final byte TAG_INT64 = 3;
+  private static final byte TAG_DOUBLE = 4;
+  private static final byte TAG_STRING = 5;
+  private static final byte TAG_ARRAY = 6;
+  private static final byte TAG_OBJECT = 7;
+
+  private final List<String> keys = new ArrayList<>();
+  private final Map<String, Integer> keyIndices = new HashMap<>();
+  private byte[] body = new byte[4096];
+  private int bodySize = 0;
+
+  public static byte[] serialize(Map<String, Object> root) {
+    MapDBinarySerializer serializer = new MapDBinarySerializer();
+    serializer.encode(root);
+    return serializer.finish();
+  }
+
+  private byte[] finish() {
+    MapDBinarySerializer header = new MapDBinarySerializer();
+    header.putBytes(MAGIC);
+    header.putInt(keys.size());
+    for (String key : keys) {
+      header.putString(key);
+    }
+    byte[] ret = Arrays.copyOf(header.body, header.bodySize + bodySize);
+    System.arraycopy(body, 0, ret, header.bodySize, bodySize);
+    return ret;
+  }
+
+  @SuppressWarnings("unchecked")
+  private int encode(Object o) {
+    final int offset = bodySize;
+    if (o == null) {
+      putByte(TAG_NULL);
+    } else if (o instanceof Boolean) {
+      putByte((Boolean) o ? TAG_TRUE : TAG_FALSE);
+    } else if (o instanceof Number) {
+      encodeNumber((Number) o);
+    } else if (o instanceof String) {
+      putByte(TAG_STRING);
+      putString((String) o);
+    } else if (o instanceof List) {
+      final List<Object> list = (List<Object>) o;
+      putByte(TAG_ARRAY);
+      putInt(list.size());
+      int slot = reserve(4 * list.size());
+      for (Object element : list) {
+        final int elementOffset = encode(element);
+        patchInt(slot, elementOffset);
+        slot += 4;
+      }
+    } else if (o instanceof Map) {
+      final Map<String, Object> map = (Map<String, Object>) o;
+      putByte(TAG_OBJECT);
+      putInt(map.size());
+      int slot = reserve(8 * map.size());
+      for (Map.Entry<String, Object> entry : map.entrySet()) {
+        patchInt(slot, keyIndex(entry.getKey()));
+        final int valueOffset = encode(entry.getValue());
+        patchInt(slot + 4, valueOffset);
+        slot += 8;
+      }
+    } else {
+      throw new AssertionError("not a json object: " + o);
+    }
+    return offset;
+  }
+
+  private void encodeNumber(Number n) {
+    final String text = n.toString();
+    if (text.indexOf('.') < 0 && text.indexOf('e') < 0 && text.indexOf('E') < 0) {
+      try {
+        final long v = Long.parseLong(text);
+        putByte(TAG_INT64);
+        putLong(v);
+        return;
+      } catch (NumberFormatException ex) {
+        // out of the int64 range, the JSON parser reads it as a double
+      }
+    }
+    putByte(TAG_DOUBLE);
+    putLong(Double.doubleToRawLongBits(Double.parseDouble(text)));
+  }
+
+  private int keyIndex(String key) {
+    Integer idx = keyIndices.get(key);
+    if (idx == null) {
+      idx = keys.size();
+      keys.add(key);
+      keyIndices.put(key, idx);
+    }
+    return idx;
+  }
+
+  private void ensureCapacity(int extra) {
+    if (bodySize + extra > body.length) {
+      body = Arrays.copyOf(body, Math.max(2 * body.length, bodySize + extra));
+    }
+  }
+
+  private int reserve(int size) {
+    ensureCapacity(size);
+    final int offset = bodySize;
+    bodySize += size;
+    return offset;
+  }
+
+  private void putByte(byte b) {
+    ensureCapacity(1);
+    body[bodySize++] = b;
+  }
+
+  private void putBytes(byte[] bytes) {
+    ensureCapacity(bytes.length);
+    System.arraycopy(bytes, 0, body, bodySize, bytes.length);
+    bodySize += bytes.length;
+  }
+
+  private void putInt(int v) {
+    patchInt(reserve(4), v);
+  }
+
+  private void patchInt(int offset, int v) {
+    for (int i = 0; i < 4; ++i) {
+      body[offset + i] = (byte) (v >>> (8 * i));
+    }
+  }
+
+  private void putLong(long v) {
+    final int offset = reserve(8);
+    for (int i = 0; i < 8; ++i) {
+      body[offset + i] = (byte) (v >>> (8 * i));
+    }
+  }
+
+  private void putString(String s) {
+    final byte[] bytes = s.getBytes(StandardCharsets.UTF_8);
+    putInt(bytes.length);
+    putBytes(bytes);
+    putByte((byte) 0);
+  }
+}
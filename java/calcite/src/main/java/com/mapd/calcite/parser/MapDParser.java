@@ -146,6 +146,17 @@ public final class MapDParser {
     return res;
   }
 
+  public byte[] getRelAlgebraBinary(String sql,
+          final List<FilterPushDownInfo> filterPushDownInfo,
+          final boolean legacy_syntax,
+          final MapDUser mapDUser)
+          throws SqlParseException, ValidationException, RelConversionException {
+    callCount++;
+    final RelRoot sqlRel = queryToSqlNode(sql, filterPushDownInfo, legacy_syntax);
+
+    return MapDSerializer.toBinary(sqlRel.project());
+  }
+
   public MapDPlanner.CompletionResult getCompletionHints(
           String sql, int cursor, List<String> visible_tables) {
     return getPlanner().getCompletionHints(sql, cursor, visible_tables);
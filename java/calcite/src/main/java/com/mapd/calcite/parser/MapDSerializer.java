@@ -32,4 +32,13 @@ public class MapDSerializer {
     rel.explain(planWriter);
     return planWriter.asString();
   }
+
+  public static byte[] toBinary(final RelNode rel) {
+    if (rel == null) {
+      return null;
+    }
+    final MapDRelJsonWriter planWriter = new MapDRelJsonWriter();
+    rel.explain(planWriter);
+    return MapDBinarySerializer.serialize(planWriter.asJsonMap());
+  }
 }
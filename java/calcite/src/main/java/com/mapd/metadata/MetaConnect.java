@@ -25,6 +25,9 @@ import com.mapd.thrift.server.TEncodingType;
 import com.mapd.thrift.server.TMapDException;
 import com.mapd.thrift.server.TTableDetails;
 import com.mapd.thrift.server.TTypeInfo;
+import com.mapd.thrift.calciteserver.TColumnSnapshot;
+import com.mapd.thrift.calciteserver.TSchemaSnapshot;
+import com.mapd.thrift.calciteserver.TTableSnapshot;
 import com.mapd.common.SockTransportProperties;
 
 import java.sql.Connection;
@@ -32,6 +35,7 @@ import java.sql.DriverManager;
 import java.sql.ResultSet;
 import java.sql.SQLException;
 import java.sql.Statement;
+import java.util.ArrayList;
 import java.util.HashSet;
 import java.util.Set;
 import org.apache.calcite.schema.Table;
@@ -91,6 +95,13 @@ public class MetaConnect {
           new ConcurrentHashMap<>();
   private static volatile Map<List<String>, Table> MAPD_TABLE_DETAILS =
           new ConcurrentHashMap<>();
+  // table details pushed by the server, consulted before calling back for metadata
+  private static volatile Map<List<String>, TTableDetails> MAPD_SNAPSHOT_DETAILS =
+          new ConcurrentHashMap<>();
+  private static volatile Map<String, Long> MAPD_SNAPSHOT_VERSIONS =
+          new ConcurrentHashMap<>();
+  private static volatile Set<String> MAPD_SNAPSHOT_SCHEMAS =
+          ConcurrentHashMap.newKeySet();
   private final SockTransportProperties sock_transport_properties;
   public MetaConnect(int mapdPort,
           String dataDir,
@@ -149,7 +160,15 @@ public class MetaConnect {
       return cTable;
     }
 
-    TTableDetails td = get_table_details(tableName);
+    TTableDetails td = MAPD_SNAPSHOT_DETAILS.get(dbTable);
+    if (td == null && MAPD_SNAPSHOT_SCHEMAS.contains(db.toUpperCase())) {
+      // the snapshot covers every table in the database
+      return null;
+    }
+    final boolean fromSnapshot = td != null;
+    if (!fromSnapshot) {
+      td = get_table_details(tableName);
+    }
 
     if (td.getView_sql() == null || td.getView_sql().isEmpty()) {
       MAPDLOGGER.debug("Processing a table");
@@ -158,7 +177,9 @@ public class MetaConnect {
       return rTable;
     } else {
       MAPDLOGGER.debug("Processing a view");
-      Table rTable = new MapDView(getViewSql(tableName), td, parser);
+      String viewSql = fromSnapshot ? stripTrailingSemicolon(td.getView_sql())
+                                    : getViewSql(tableName);
+      Table rTable = new MapDView(viewSql, td, parser);
       MAPD_TABLE_DETAILS.putIfAbsent(dbTable, rTable);
       return rTable;
     }
@@ -498,7 +519,11 @@ public class MetaConnect {
         throw new RuntimeException(ex.toString());
       }
     }
-    /* return string without the sqlite's trailing semicolon */
+    return stripTrailingSemicolon(sqlText);
+  }
+
+  /* return string without the sqlite's trailing semicolon */
+  private static String stripTrailingSemicolon(String sqlText) {
     if (sqlText.charAt(sqlText.length() - 1) == ';') {
       return (sqlText.substring(0, sqlText.length() - 1));
     } else {
@@ -536,7 +561,7 @@ public class MetaConnect {
     return sqlText;
   }
 
-  private TDatumType typeToThrift(int type) {
+  private static TDatumType typeToThrift(int type) {
     switch (type) {
       case KBOOLEAN:
         return TDatumType.BOOL;
@@ -582,7 +607,87 @@ public class MetaConnect {
     }
   }
 
+  private static TTableDetails snapshotToTableDetails(TTableSnapshot table) {
+    TTableDetails td = new TTableDetails();
+    td.setRow_desc(new ArrayList<TColumnType>());
+    if (table.is_view) {
+      td.setView_sql(table.view_sql);
+      return td;
+    }
+    int skip_physical_cols = 0;
+    for (TColumnSnapshot col : table.columns) {
+      TColumnType tct = new TColumnType();
+      TTypeInfo tti = new TTypeInfo();
+      if (col.col_type == KARRAY) {
+        tti.is_array = true;
+        tti.type = typeToThrift(col.col_subtype);
+      } else {
+        tti.is_array = false;
+        tti.type = typeToThrift(col.col_type);
+      }
+      tti.nullable = !col.is_notnull;
+      tti.encoding = TEncodingType.NONE;
+      tti.scale = col.col_scale;
+      tti.precision = col.col_dim;
+
+      tct.col_name = col.col_name;
+      tct.col_type = tti;
+
+      if (skip_physical_cols <= 0) skip_physical_cols = get_physical_cols(col.col_type);
+      if (is_geometry(col.col_type) || skip_physical_cols-- <= 0) td.addToRow_desc(tct);
+    }
+    return td;
+  }
+
+  public static synchronized void installSchemaSnapshot(TSchemaSnapshot snapshot) {
+    String schema = snapshot.catalog.toUpperCase();
+    Long current = MAPD_SNAPSHOT_VERSIONS.get(schema);
+    if (current != null && current >= snapshot.version) {
+      MAPDLOGGER.debug("ignoring stale snapshot for schema " + schema + " version "
+              + snapshot.version);
+      return;
+    }
+    removeSchema(schema);
+    Set<String> ts = new HashSet<String>(snapshot.tables.size());
+    for (TTableSnapshot table : snapshot.tables) {
+      ts.add(table.table_name);
+      MAPD_SNAPSHOT_DETAILS.put(
+              ImmutableList.of(schema, table.table_name.toUpperCase()),
+              snapshotToTableDetails(table));
+    }
+    MAPD_DATABASE_TO_TABLES.put(schema, ts);
+    MAPD_SNAPSHOT_VERSIONS.put(schema, snapshot.version);
+    MAPD_SNAPSHOT_SCHEMAS.add(schema);
+  }
+
+  private static void removeSchema(String schema) {
+    Set<List<String>> all = new HashSet<>(MAPD_TABLE_DETAILS.keySet());
+    all.addAll(MAPD_SNAPSHOT_DETAILS.keySet());
+    for (List<String> keys : all) {
+      if (keys.get(0).equals(schema)) {
+        MAPDLOGGER.debug("removing schema " + keys.get(0) + " table " + keys.get(1));
+        MAPD_TABLE_DETAILS.remove(keys);
+        MAPD_SNAPSHOT_DETAILS.remove(keys);
+      }
+    }
+    MAPD_DATABASE_TO_TABLES.remove(schema);
+  }
+
   public void updateMetaData(String schema, String table) {
+    // A pushed snapshot is stale after any DDL, drop it and fall back to calling back
+    // into the server until the next snapshot arrives. The snapshot version is kept
+    // so that older snapshots still in flight are ignored.
+    synchronized (MetaConnect.class) {
+      if (MAPD_SNAPSHOT_SCHEMAS.remove(schema.toUpperCase())) {
+        MAPDLOGGER.debug("dropping schema snapshot for " + schema.toUpperCase());
+      }
+      Set<List<String>> snapshotKeys = new HashSet<>(MAPD_SNAPSHOT_DETAILS.keySet());
+      for (List<String> keys : snapshotKeys) {
+        if (keys.get(0).equals(schema.toUpperCase())) {
+          MAPD_SNAPSHOT_DETAILS.remove(keys);
+        }
+      }
+    }
     // Check if table is specified, if not we are dropping an entire DB so need to
     // remove all
     // tables for that DB
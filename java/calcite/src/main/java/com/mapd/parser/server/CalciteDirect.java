@@ -0,0 +1,141 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.mapd.parser.server;
+
+import com.mapd.common.SockTransportProperties;
+import com.mapd.thrift.calciteserver.InvalidParseRequest;
+import com.mapd.thrift.calciteserver.TCompletionHint;
+import com.mapd.thrift.calciteserver.TFilterPushDownInfo;
+import com.mapd.thrift.calciteserver.TPlanResult;
+import com.mapd.thrift.calciteserver.TSchemaSnapshot;
+
+import java.io.IOException;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.Properties;
+import org.apache.log4j.PropertyConfigurator;
+import org.apache.thrift.TDeserializer;
+import org.apache.thrift.TException;
+import org.apache.thrift.TSerializer;
+import org.apache.thrift.protocol.TBinaryProtocol;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+/**
+ * Entry point for the server hosting the planner in-process through JNI. Results are
+ * returned Thrift binary-encoded, so the server decodes them exactly as it would a
+ * reply from the standalone Calcite server.
+ */
+public class CalciteDirect {
+  private final static Logger MAPDLOGGER = LoggerFactory.getLogger(CalciteDirect.class);
+  private final CalciteServerHandler handler;
+
+  public CalciteDirect(int mapdPort,
+          String dataDir,
+          String extensionsDir,
+          String trustStore,
+          String trustStorePw,
+          int plannerPoolSize) {
+    Properties p = new Properties();
+    try {
+      p.load(getClass().getResourceAsStream("/log4j.properties"));
+    } catch (IOException ex) {
+      MAPDLOGGER.error(
+              "Could not load log4j property file from resources " + ex.getMessage());
+    }
+    p.put("log.dir", dataDir); // overwrite "log.dir"
+    PropertyConfigurator.configure(p);
+
+    SockTransportProperties skT = null;
+    try {
+      if (!trustStore.isEmpty()) {
+        skT = new SockTransportProperties(trustStore, trustStorePw);
+      }
+    } catch (Exception ex) {
+      MAPDLOGGER.error(
+              "Supplied java trust stored could not be opened " + ex.getMessage());
+    }
+
+    handler = new CalciteServerHandler(mapdPort,
+            dataDir,
+            Paths.get(extensionsDir, "ExtensionFunctions.ast").toString(),
+            skT);
+    handler.setParserPoolSize(plannerPoolSize);
+  }
+
+  public byte[] process(String user,
+          String session,
+          String catalog,
+          String sqlText,
+          int[] filterPushDownInfo,
+          boolean legacySyntax,
+          boolean isExplain,
+          boolean binaryPlan) throws TException {
+    List<TFilterPushDownInfo> pushDownInfo = new ArrayList<>();
+    for (int i = 0; i + 2 < filterPushDownInfo.length; i += 3) {
+      pushDownInfo.add(new TFilterPushDownInfo(filterPushDownInfo[i],
+              filterPushDownInfo[i + 1],
+              filterPushDownInfo[i + 2]));
+    }
+    TPlanResult result;
+    try {
+      result = handler.process(user,
+              session,
+              catalog,
+              sqlText,
+              pushDownInfo,
+              legacySyntax,
+              isExplain,
+              binaryPlan);
+    } catch (InvalidParseRequest ex) {
+      // surfaced as std::invalid_argument on the server side
+      throw new IllegalArgumentException(ex.whyUp);
+    }
+    return new TSerializer(new TBinaryProtocol.Factory()).serialize(result);
+  }
+
+  public byte[][] getCompletionHints(String user,
+          String session,
+          String catalog,
+          String[] visibleTables,
+          String sql,
+          int cursor) throws TException {
+    List<TCompletionHint> hints = handler.getCompletionHints(
+            user, session, catalog, Arrays.asList(visibleTables), sql, cursor);
+    TSerializer serializer = new TSerializer(new TBinaryProtocol.Factory());
+    byte[][] ret = new byte[hints.size()][];
+    for (int i = 0; i < hints.size(); i++) {
+      ret[i] = serializer.serialize(hints.get(i));
+    }
+    return ret;
+  }
+
+  public String getExtensionFunctionWhitelist() {
+    return handler.getExtensionFunctionWhitelist();
+  }
+
+  public void updateMetadata(String catalog, String table) throws TException {
+    handler.updateMetadata(catalog, table);
+  }
+
+  public void updateSchemaSnapshot(byte[] snapshotBytes) throws TException {
+    TSchemaSnapshot snapshot = new TSchemaSnapshot();
+    new TDeserializer(new TBinaryProtocol.Factory()).deserialize(snapshot, snapshotBytes);
+    handler.updateSchemaSnapshot(snapshot);
+  }
+}
@@ -17,12 +17,14 @@ package com.mapd.parser.server;
 
 import com.mapd.calcite.parser.MapDParser;
 import com.mapd.calcite.parser.MapDUser;
+import com.mapd.metadata.MetaConnect;
 import com.mapd.thrift.calciteserver.InvalidParseRequest;
 import com.mapd.thrift.calciteserver.TAccessedQueryObjects;
 import com.mapd.thrift.calciteserver.TCompletionHint;
 import com.mapd.thrift.calciteserver.TCompletionHintType;
 import com.mapd.thrift.calciteserver.TFilterPushDownInfo;
 import com.mapd.thrift.calciteserver.TPlanResult;
+import com.mapd.thrift.calciteserver.TSchemaSnapshot;
 import com.mapd.thrift.calciteserver.CalciteServer;
 
 import static com.mapd.calcite.parser.MapDParser.CURRENT_PARSER;
@@ -99,7 +101,8 @@ class CalciteServerHandler implements CalciteServer.Iface {
           String sqlText,
           java.util.List<TFilterPushDownInfo> thriftFilterPushDownInfo,
           boolean legacySyntax,
-          boolean isExplain) throws InvalidParseRequest, TException {
+          boolean isExplain,
+          boolean binaryPlan) throws InvalidParseRequest, TException {
     long timer = System.currentTimeMillis();
     callCount++;
     MapDParser parser;
@@ -122,7 +125,8 @@ class CalciteServerHandler implements CalciteServer.Iface {
     if (sqlText.charAt(sqlText.length() - 1) == ';') {
       sqlText = sqlText.substring(0, sqlText.length() - 1);
     }
-    String relAlgebra;
+    String relAlgebra = null;
+    byte[] relAlgebraBinary = null;
     SqlIdentifierCapturer capturer;
     TAccessedQueryObjects primaryAccessedObjects = new TAccessedQueryObjects();
     TAccessedQueryObjects resolvedAccessedObjects = new TAccessedQueryObjects();
@@ -134,8 +138,14 @@ class CalciteServerHandler implements CalciteServer.Iface {
                 req.input_prev, req.input_start, req.input_next));
       }
       try {
-        relAlgebra = parser.getRelAlgebra(
-                sqlText, filterPushDownInfo, legacySyntax, mapDUser, isExplain);
+        // explain output is text, only executable plans come in binary form
+        if (binaryPlan && !isExplain) {
+          relAlgebraBinary = parser.getRelAlgebraBinary(
+                  sqlText, filterPushDownInfo, legacySyntax, mapDUser);
+        } else {
+          relAlgebra = parser.getRelAlgebra(
+                  sqlText, filterPushDownInfo, legacySyntax, mapDUser, isExplain);
+        }
       } catch (ValidationException ex) {
         String msg = "Validation: " + ex.getMessage();
         MAPDLOGGER.error(msg);
@@ -188,7 +198,11 @@ class CalciteServerHandler implements CalciteServer.Iface {
     TPlanResult result = new TPlanResult();
     result.primary_accessed_objects = primaryAccessedObjects;
     result.resolved_accessed_objects = resolvedAccessedObjects;
-    result.plan_result = relAlgebra;
+    if (relAlgebraBinary != null) {
+      result.setPlan_result_binary(relAlgebraBinary);
+    } else {
+      result.plan_result = relAlgebra;
+    }
     result.execution_time_ms = System.currentTimeMillis() - timer;
 
     return result;
@@ -210,6 +224,11 @@ class CalciteServerHandler implements CalciteServer.Iface {
     server = s;
   }
 
+  void setParserPoolSize(int size) {
+    parserPool.setMaxActive(size);
+    parserPool.setMaxIdle(size);
+  }
+
   @Override
   public void updateMetadata(String catalog, String table) throws TException {
     MAPDLOGGER.debug("Received invalidation from server for " + catalog + " : " + table);
@@ -239,6 +258,14 @@ class CalciteServerHandler implements CalciteServer.Iface {
     }
   }
 
+  @Override
+  public void updateSchemaSnapshot(TSchemaSnapshot snapshot) throws TException {
+    MAPDLOGGER.debug("Received schema snapshot from server for " + snapshot.catalog
+            + " version " + snapshot.version);
+    callCount++;
+    MetaConnect.installSchemaSnapshot(snapshot);
+  }
+
   @Override
   public List<TCompletionHint> getCompletionHints(String user,
           String session,
@@ -1145,16 +1145,21 @@ each row is a column description Throws: SQLException - if a database access err
     }
 
     // Now add some actual details for table name
-    List<String> tables;
     try {
-      tables = con.client.get_tables(con.session);
+      // details of all the matching tables in a single call
+      List<String> tableNames = new ArrayList<String>();
+      if (tableNamePattern != null) {
+        tableNames.add(tableNamePattern);
+      }
+      Map<String, TTableDetails> tablesDetails =
+              con.client.get_tables_details(con.session, tableNames);
+      List<String> tables = new ArrayList<String>(tablesDetails.keySet());
+      Collections.sort(tables);
 
       for (String tableName : tables) {
         // check if the table matches the input pattern
         if (tableNamePattern == null || tableNamePattern.equals(tableName)) {
-          // grab meta data for table
-          TTableDetails tableDetails =
-                  con.client.get_table_details(con.session, tableName);
+          TTableDetails tableDetails = tablesDetails.get(tableName);
 
           int ordinal = 0;
           // iterate through the columns
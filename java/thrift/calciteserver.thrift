@@ -21,6 +21,31 @@ struct TPlanResult {
   3: TAccessedQueryObjects primary_accessed_objects;
      // these are the accessed objects during this query after resolving all views 
   4: TAccessedQueryObjects resolved_accessed_objects;
+     // set instead of plan_result when the plan was requested in binary form
+  5: binary plan_result_binary
+}
+
+struct TColumnSnapshot {
+  1: string col_name
+  2: i32 col_type
+  3: i32 col_subtype
+  4: i32 col_dim
+  5: i32 col_scale
+  6: bool is_notnull
+}
+
+struct TTableSnapshot {
+  1: string table_name
+  2: list<TColumnSnapshot> columns
+  3: bool is_view
+  4: string view_sql
+}
+
+   // catalog metadata pushed by the server so planning doesn't call back for it
+struct TSchemaSnapshot {
+  1: string catalog
+  2: i64 version
+  3: list<TTableSnapshot> tables
 }
 
 struct TFilterPushDownInfo {
@@ -35,9 +60,10 @@ service CalciteServer {
    void shutdown(),
    TPlanResult process(1:string user 2:string passwd 3:string catalog 4:string sql_text
                        5:list<TFilterPushDownInfo> filterPushDownInfo 6:bool legacySyntax
-                       7:bool isexplain) throws (1:InvalidParseRequest parseErr),
+                       7:bool isexplain 8:bool binaryPlan) throws (1:InvalidParseRequest parseErr),
    string getExtensionFunctionWhitelist()
    void updateMetadata(1: string catalog, 2:string table),
+   void updateSchemaSnapshot(1: TSchemaSnapshot snapshot),
    list<completion_hints.TCompletionHint> getCompletionHints(1:string user, 2:string passwd, 3:string catalog,
     4:list<string> visible_tables, 5:string sql, 6:i32 cursor)
 
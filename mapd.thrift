@@ -297,6 +297,13 @@ struct TNodeMemoryInfo {
   6: list<TMemoryData> node_memory_data
 }
 
+struct TTableChunkLayout {
+  1: i64 num_chunks
+  2: i64 num_pages
+  3: i64 num_page_runs
+  4: i64 num_scattered_chunks
+}
+
 struct TTableMeta {
   1: string table_name
   2: i64 num_cols
@@ -502,6 +509,7 @@ service MapD {
   list<TTableMeta> get_tables_meta(1: TSessionId session) throws (1: TMapDException e)
   TTableDetails get_table_details(1: TSessionId session, 2: string table_name) throws (1: TMapDException e)
   TTableDetails get_internal_table_details(1: TSessionId session, 2: string table_name) throws (1: TMapDException e)
+  map<string, TTableDetails> get_tables_details(1: TSessionId session, 2: list<string> table_names) throws (1: TMapDException e)
   list<string> get_users(1: TSessionId session) throws (1: TMapDException e)
   list<TDBInfo> get_databases(1: TSessionId session) throws (1: TMapDException e)
   string get_version() throws (1: TMapDException e)
@@ -511,6 +519,8 @@ service MapD {
   list<TNodeMemoryInfo> get_memory(1: TSessionId session, 2: string memory_level) throws (1: TMapDException e)
   void clear_cpu_memory(1: TSessionId session) throws (1: TMapDException e)
   void clear_gpu_memory(1: TSessionId session) throws (1: TMapDException e)
+  void prewarm_table(1: TSessionId session, 2: string table_name, 3: list<string> column_names) throws (1: TMapDException e)
+  TTableChunkLayout get_table_chunk_layout(1: TSessionId session, 2: string table_name) throws (1: TMapDException e)
   void set_table_epoch (1: TSessionId session 2: i32 db_id 3: i32 table_id 4: i32 new_epoch) throws (1: TMapDException e)
   void set_table_epoch_by_name (1: TSessionId session 2: string table_name 3: i32 new_epoch) throws (1: TMapDException e)
   i32 get_table_epoch (1: TSessionId session 2: i32 db_id 3: i32 table_id);